@@ -0,0 +1,6 @@
+@echo off
+@rem Runs the same scene + path w/ every antialiasing mode to compare their GPU cost
+@rem (aa_gpu_ms = resolve / FXAA pass, pass_gpu_ms.forward grows w/ the MSAA sample count)
+@rem Results go to benchmarks/results/aa_<mode>.json
+if not exist benchmarks\results mkdir benchmarks\results
+for %%m in (none fxaa msaa2 msaa4 msaa8) do benchmark.exe --aa %%m --frames 300 --json benchmarks/results/aa_%%m.json
@@ -0,0 +1,7 @@
+@echo off
+@rem Sweeps generated scenes to chart frame time against object count, light count and overdraw
+@rem Results go to benchmarks/results/<sweep>_<count>.json
+if not exist benchmarks\results mkdir benchmarks\results
+for %%n in (1 4 16 64 256 1024) do benchmark.exe --scene "grid:models=%%n,lights=4,quads=0,lamps=0" --frames 300 --json benchmarks/results/models_%%n.json
+for %%n in (1 4 16 64 256) do benchmark.exe --scene "grid:models=16,lights=%%n,quads=0,lamps=0" --frames 300 --json benchmarks/results/lights_%%n.json
+for %%n in (0 4 16 64 256) do benchmark.exe --scene "grid:models=16,lights=4,quads=%%n,lamps=0" --frames 300 --json benchmarks/results/overdraw_%%n.json
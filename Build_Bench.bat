@@ -0,0 +1,17 @@
+@echo Building Benchmarks...
+if not exist bench_obj mkdir bench_obj
+pushd bench_obj
+g++ -g -O2 -c -I ../include ../src/*.cpp ../src/*.c
+if %errorlevel% neq 0 (popd & exit /b %errorlevel%)
+@rem The app's main() lives in main.o, every benchmark brings its own
+del main.o
+g++ -g -O2 -I ../include -o ../benchmark.exe ../bench/benchmark.cpp *.o -L .. -lglfw3 -lopengl32 -lgdi32 -lassimp.dll -static
+if %errorlevel% neq 0 (popd & exit /b %errorlevel%)
+@rem CPU only micro-benchmarks, GL is mocked so no context (or glfw) is needed
+g++ -g -O2 -I ../include -o ../microbench.exe ../bench/microbench.cpp *.o -L .. -lassimp.dll -static
+if %errorlevel% neq 0 (popd & exit /b %errorlevel%)
+@rem Checks of the OBJ parser on malformed files
+g++ -g -O2 -I ../include -o ../obj_loader_test.exe ../bench/obj_loader_test.cpp *.o -L .. -lassimp.dll -static
+if %errorlevel% neq 0 (popd & exit /b %errorlevel%)
+popd
+@echo Benchmark build complete
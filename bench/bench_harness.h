@@ -0,0 +1,322 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+#include "bench_json.h"
+
+using namespace std;
+
+// Minimal Google Benchmark style harness:
+//
+// MICRO_BENCHMARK(MyThing)
+// {
+//     setup...
+//     while (state.keepRunning())
+//         doNotOptimize(work());
+// }
+//
+// Each benchmark is calibrated so one repetition runs for at least minTime, run once as warmup,
+// then repeated N times. Every repetition gives a time per iteration which we report
+// mean / median / stddev / min / max / coefficient of variation for.
+
+// Stops the compiler from optimizing away a value we compute but never use
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+    asm volatile(""
+                 :
+                 : "r,m"(value)
+                 : "memory");
+}
+
+class BenchmarkState
+{
+public:
+    BenchmarkState(long long iterations) : iterations(iterations), remaining(iterations), items(0), pausedTime(0), skipped(false) {}
+
+    // Returns true while there are iterations left, the clock starts on the first call
+    bool keepRunning()
+    {
+        if (skipped)
+            return false;
+        if (remaining == iterations)
+            start = chrono::high_resolution_clock::now();
+        if (remaining-- > 0)
+            return true;
+        end = chrono::high_resolution_clock::now();
+        return false;
+    }
+
+    // Excludes setup work inside the loop from the measurement
+    void pauseTiming()
+    {
+        pauseStart = chrono::high_resolution_clock::now();
+    }
+
+    void resumeTiming()
+    {
+        pausedTime += chrono::duration<double, nano>(chrono::high_resolution_clock::now() - pauseStart).count();
+    }
+
+    // Call instead of the loop when the benchmark can't run here (missing file, ...), it's reported as skipped
+    void skip()
+    {
+        skipped = true;
+    }
+    bool wasSkipped() const { return skipped; }
+
+    // Items (vertices, objects, ...) processed per iteration, reported as a throughput
+    void setItemsPerIteration(long long count)
+    {
+        items = count;
+    }
+
+    long long iterationCount() const { return iterations; }
+    long long itemsPerIteration() const { return items; }
+
+    double elapsedNanoseconds() const
+    {
+        return chrono::duration<double, nano>(end - start).count() - pausedTime;
+    }
+
+private:
+    long long iterations;
+    long long remaining;
+    long long items;
+    double pausedTime;
+    bool skipped;
+    chrono::high_resolution_clock::time_point start, end, pauseStart;
+};
+
+typedef void (*BenchmarkFunction)(BenchmarkState &);
+
+struct RegisteredBenchmark
+{
+    string name;
+    BenchmarkFunction function;
+    // Only runs when the filter asks for it (see MICRO_BENCHMARK_SLOW)
+    bool slow;
+};
+
+vector<RegisteredBenchmark> &registered_benchmarks()
+{
+    static vector<RegisteredBenchmark> benchmarks;
+    return benchmarks;
+}
+
+struct BenchmarkRegistration
+{
+    BenchmarkRegistration(const char *name, BenchmarkFunction function, bool slow = false)
+    {
+        registered_benchmarks().push_back({name, function, slow});
+    }
+};
+
+#define MICRO_BENCHMARK(name)                                                   \
+    static void name(BenchmarkState &state);                                    \
+    static BenchmarkRegistration name##Registration(#name, name);               \
+    static void name(BenchmarkState &state)
+
+// Same, for benchmarks too slow for every run (seconds an iteration): skipped unless --filter matches them
+#define MICRO_BENCHMARK_SLOW(name)                                              \
+    static void name(BenchmarkState &state);                                    \
+    static BenchmarkRegistration name##Registration(#name, name, true);         \
+    static void name(BenchmarkState &state)
+
+struct MicroBenchmarkOptions
+{
+    // Only run benchmarks whose name contains this
+    string filter;
+    int repetitions = 10;
+    // Minimum time per repetition
+    double minTimeSeconds = 0.05;
+    string jsonPath;
+    string baselinePath;
+    // Allowed slowdown of the median against the baseline
+    double threshold = 0.10;
+};
+
+struct MicroBenchmarkResult
+{
+    string name;
+    long long iterations;
+    double mean, median, stddev, min, max;
+    double itemsPerSecond;
+    bool skipped;
+};
+
+static double runRepetition(BenchmarkFunction function, long long iterations, long long &items, bool *skipped = NULL)
+{
+    BenchmarkState state(iterations);
+    function(state);
+    items = state.itemsPerIteration();
+    if (skipped != NULL)
+        *skipped = state.wasSkipped();
+    return state.elapsedNanoseconds();
+}
+
+// Finds an iteration count where one repetition takes at least minTime, 0 when the benchmark skipped itself
+static long long calibrate(BenchmarkFunction function, double minTimeSeconds)
+{
+    long long iterations = 1;
+    long long items;
+    while (true)
+    {
+        bool skipped;
+        double elapsed = runRepetition(function, iterations, items, &skipped);
+        if (skipped)
+            return 0;
+        if (elapsed >= minTimeSeconds * 1e9 || iterations >= 1000000000LL)
+            return iterations;
+        // Grow towards the target, at most 10x at a time since the first runs are noisy
+        double scale = elapsed > 0 ? (minTimeSeconds * 1e9 * 1.2) / elapsed : 10.0;
+        iterations = (long long)(iterations * min(max(scale, 1.5), 10.0)) + 1;
+    }
+}
+
+MicroBenchmarkResult run_micro_benchmark(const RegisteredBenchmark &benchmark, const MicroBenchmarkOptions &options)
+{
+    MicroBenchmarkResult result;
+    result.name = benchmark.name;
+    result.skipped = false;
+    long long iterations = calibrate(benchmark.function, options.minTimeSeconds);
+    if (iterations == 0)
+    {
+        result.skipped = true;
+        return result;
+    }
+    long long items = 0;
+    // Warmup = calibration + one extra run that isn't recorded
+    runRepetition(benchmark.function, iterations, items);
+
+    vector<double> samples;
+    for (int i = 0; i < options.repetitions; i++)
+        samples.push_back(runRepetition(benchmark.function, iterations, items) / iterations);
+
+    result.iterations = iterations;
+    sort(samples.begin(), samples.end());
+    double total = 0;
+    for (double sample : samples)
+        total += sample;
+    result.mean = total / samples.size();
+    result.median = samples.size() % 2 ? samples[samples.size() / 2] : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) * 0.5;
+    double variance = 0;
+    for (double sample : samples)
+        variance += (sample - result.mean) * (sample - result.mean);
+    result.stddev = samples.size() > 1 ? sqrt(variance / (samples.size() - 1)) : 0;
+    result.min = samples.front();
+    result.max = samples.back();
+    result.itemsPerSecond = items > 0 ? items * 1e9 / result.median : 0;
+    return result;
+}
+
+static bool parseMicroBenchmarkArguments(int argc, char **argv, MicroBenchmarkOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue)
+            options.filter = argv[++i];
+        else if (arg == "--repetitions" && hasValue)
+            options.repetitions = max(1, atoi(argv[++i]));
+        else if (arg == "--min-time" && hasValue)
+            options.minTimeSeconds = atof(argv[++i]);
+        else if (arg == "--json" && hasValue)
+            options.jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue)
+            options.baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue)
+            options.threshold = atof(argv[++i]);
+        else
+        {
+            std::cout << "ERROR::MICROBENCH::UNKNOWN_ARGUMENT " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void writeMicroBenchmarkJson(const string &path, const vector<MicroBenchmarkResult> &results)
+{
+    ofstream file(path);
+    if (!file)
+    {
+        std::cout << "ERROR::MICROBENCH::FAILED_TO_WRITE " << path << std::endl;
+        return;
+    }
+    file << "{\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const MicroBenchmarkResult &r = results[i];
+        file << "  \"" << r.name << "\": {\"median_ns\": " << r.median << ", \"mean_ns\": " << r.mean
+             << ", \"stddev_ns\": " << r.stddev << ", \"min_ns\": " << r.min << ", \"max_ns\": " << r.max
+             << ", \"iterations\": " << r.iterations << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    file << "}\n";
+}
+
+// Runs every registered benchmark (matching the filter), returns the process exit code
+int run_micro_benchmarks(int argc, char **argv)
+{
+    MicroBenchmarkOptions options;
+    if (!parseMicroBenchmarkArguments(argc, argv, options))
+        return 2;
+
+    string baseline;
+    bool hasBaseline = !options.baselinePath.empty() && read_file(options.baselinePath, baseline);
+    if (!options.baselinePath.empty() && !hasBaseline)
+        std::cout << "No baseline at " << options.baselinePath << std::endl;
+
+    std::cout << left << setw(40) << "Benchmark" << right << setw(14) << "Median(ns)" << setw(14) << "Mean(ns)"
+              << setw(12) << "StdDev" << setw(8) << "CV%" << setw(14) << "Iterations" << setw(16) << "Items/s" << std::endl;
+    std::cout << string(118, '-') << std::endl;
+
+    vector<MicroBenchmarkResult> results;
+    bool passed = true;
+    for (const RegisteredBenchmark &benchmark : registered_benchmarks())
+    {
+        if (options.filter.empty() ? benchmark.slow : benchmark.name.find(options.filter) == string::npos)
+            continue;
+        MicroBenchmarkResult result = run_micro_benchmark(benchmark, options);
+        if (result.skipped)
+        {
+            std::cout << left << setw(40) << result.name << right << "  skipped" << std::endl;
+            continue;
+        }
+        results.push_back(result);
+
+        std::cout << left << setw(40) << result.name << right << fixed << setprecision(1)
+                  << setw(14) << result.median << setw(14) << result.mean << setw(12) << result.stddev
+                  << setw(8) << (result.mean > 0 ? 100.0 * result.stddev / result.mean : 0.0)
+                  << setw(14) << result.iterations << setw(16) << setprecision(0) << result.itemsPerSecond;
+
+        double baselineMedian;
+        if (hasBaseline && read_json_value(baseline, result.name, "median_ns", baselineMedian) && baselineMedian > 0)
+        {
+            double change = (result.median - baselineMedian) / baselineMedian;
+            std::cout << "  " << showpos << setprecision(1) << change * 100.0 << "%" << noshowpos;
+            if (change > options.threshold)
+            {
+                std::cout << " REGRESSION";
+                passed = false;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (!options.jsonPath.empty())
+        writeMicroBenchmarkJson(options.jsonPath, results);
+    return passed ? 0 : 1;
+}
+
+#endif
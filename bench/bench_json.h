@@ -0,0 +1,37 @@
+#ifndef BENCH_JSON_H
+#define BENCH_JSON_H
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+using namespace std;
+
+// Just enough JSON reading for the result files the benchmarks write: finds "group": {... "key": value}
+bool read_json_value(const string &json, const string &group, const string &key, double &value)
+{
+    size_t groupStart = json.find("\"" + group + "\"");
+    if (groupStart == string::npos)
+        return false;
+    size_t groupEnd = json.find('}', groupStart);
+    size_t keyStart = json.find("\"" + key + "\"", groupStart);
+    if (keyStart == string::npos || keyStart > groupEnd)
+        return false;
+    size_t colon = json.find(':', keyStart);
+    value = atof(json.c_str() + colon + 1);
+    return true;
+}
+
+bool read_file(const string &path, string &contents)
+{
+    ifstream file(path);
+    if (!file)
+        return false;
+    stringstream stream;
+    stream << file.rdbuf();
+    contents = stream.str();
+    return true;
+}
+
+#endif
@@ -0,0 +1,755 @@
+// Benchmark runner: renders a named scene along a scripted/recorded camera path for a fixed
+// number of frames and reports CPU + GPU frame time percentiles.
+// Usage: benchmark [--scene default|grid:models=100,lights=16,...] [--path orbit|flythrough|<file>] [--warmup 60] [--frames 600]
+//                  [--width 1280] [--height 720] [--lighting clustered|forward|deferred] [--depth-prepass] [--no-shadows] [--aa none|fxaa|msaa2|msaa4|msaa8]
+//                  [--render-scale 0.75] [--dynamic-resolution 8.0] [--load-model <path> [--load-sync]] [--texture-budget 64] [--pack-textures] [--material-batching] [--post sharpen,blur:8:half,grayscale] [--csv out.csv] [--json out.json]
+//                  [--baseline benchmarks/baseline_default.json] [--threshold 0.10] [--update-baseline]
+// Exit code is 1 when any percentile regressed more than threshold against the baseline.
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../src/stb_image.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cctype>
+
+#include "../src/camera.h"
+#include "../src/camera_path.h"
+#include "../src/scene.h"
+#include "../src/scene_generator.h"
+#include "../src/renderer.h"
+#include "../src/gpu_timer.h"
+#include "../src/shader_cache.h"
+#include "../src/gl_profiler.h"
+#include "../src/gl_loader.h"
+#include "bench_json.h"
+
+using namespace std;
+
+struct BenchmarkOptions
+{
+    string scene = "default";
+    string path = "orbit";
+    int warmupFrames = 60;
+    int measuredFrames = 600;
+    int width = 1280;
+    int height = 720;
+    // "clustered", "forward" or "deferred", see LightingPath
+    string lighting = "clustered";
+    bool depthPrepass = false;
+    bool shadows = true;
+    // Post processing effects in order, as given to --post (name[:radius][:half])
+    string post;
+    vector<PostEffect> postEffects;
+    // See Renderer::antialiasingName
+    string antialiasing = "msaa4";
+    // Fixed render scale, or the GPU frame time (ms) dynamic resolution aims for (0 = off)
+    float renderScale = 1.0f;
+    float dynamicResolutionTarget = 0.0f;
+    // Model loaded when measuring starts, on the loader thread (or the render thread w/ loadSync) to see the hitch it causes
+    string loadModel;
+    bool loadSync = false;
+    // Video memory (MB) streamed texture mip levels may take (0 = the streamer's default)
+    int textureBudget = 0;
+    // Pack specular maps into the diffuse maps' alpha
+    bool packTextures = false;
+    // Draw every lit model w/ one call, its materials from texture arrays
+    bool materialBatching = false;
+    // Simulated seconds per frame, keeps animation + camera independent of how fast we render
+    float timeStep = 1.0f / 60.0f;
+    string csvPath;
+    string jsonPath;
+    string baselinePath;
+    float threshold = 0.10f;
+    bool updateBaseline = false;
+};
+
+struct Percentiles
+{
+    double p50;
+    double p95;
+    double p99;
+};
+
+struct BenchmarkResult
+{
+    Percentiles cpu;
+    Percentiles gpu;
+    Percentiles frame;
+    // Longest frame, where a hitch shows up
+    double maxFrameMilliseconds;
+    // From starting the --load-model load until it was drawn
+    double loadModelMilliseconds;
+    unsigned int drawCalls;
+    // Window + GL setup through scene load, and the part of that spent on shaders
+    double startupMilliseconds;
+    double shaderLoadMilliseconds;
+    // Average CPU time spent sorting lights into clusters per frame (0 on the forward path)
+    double lightAssignMilliseconds;
+    // Average shadow cascades redrawn per frame (the far ones are cached)
+    double shadowCascadesPerFrame;
+    // Full screen post processing passes per frame (after fusing)
+    unsigned int postPasses;
+    // Render targets the frame graph allocated for its transient textures (after aliasing)
+    unsigned int frameGraphTextures;
+    // Average GPU time of every frame graph pass, and of the antialiasing passes (MSAA resolve / FXAA) alone
+    map<string, double> passMilliseconds;
+    double antialiasingMilliseconds;
+    // Per-frame data written to the stream buffer, and frames that waited on its fences
+    double streamBytesPerFrame;
+    unsigned int fenceWaits;
+    double fenceWaitMilliseconds;
+    // Average + lowest render scale over the measured frames, and how often dynamic resolution changed it
+    double averageRenderScale;
+    float minRenderScale;
+    unsigned int renderScaleChanges;
+    // Texture memory resident at the end, textures still waiting for a finer mip level, and levels streamed in/evicted while measuring
+    double textureResidentMegabytes;
+    unsigned int texturePendingRequests;
+    unsigned int textureLevelsStreamed;
+    unsigned int textureLevelsEvicted;
+    // Materials in the registry, meshes that got an existing one, and material (texture set) binds per frame in the lit pass
+    unsigned int materials;
+    unsigned int materialReuses;
+    double materialBindsPerFrame;
+    // Models drawn as a MaterialBatch at the end, + their materials, arrays, layers and array memory
+    unsigned int materialBatches;
+    unsigned int batchMaterials;
+    unsigned int batchArrays;
+    unsigned int batchLayers;
+    double batchMegabytes;
+};
+
+// Parses a comma separated effect list, e.g. "sharpen,blur:12:half,vignette"
+static bool parsePostEffects(const string &list, vector<PostEffect> &effects)
+{
+    stringstream entries(list);
+    string entry;
+    while (getline(entries, entry, ','))
+    {
+        stringstream fields(entry);
+        string name, field;
+        getline(fields, name, ':');
+        PostEffect effect;
+        effect.enabled = true;
+        effect.radius = 8;
+        effect.halfResolution = false;
+        if (!PostProcessStack::parseEffect(name, effect.type))
+        {
+            std::cout << "ERROR::BENCHMARK::UNKNOWN_POST_EFFECT " << name << std::endl;
+            return false;
+        }
+        while (getline(fields, field, ':'))
+        {
+            if (field == "half")
+                effect.halfResolution = true;
+            else
+                effect.radius = atoi(field.c_str());
+        }
+        effects.push_back(effect);
+    }
+    return true;
+}
+
+static bool parseAntialiasing(const string &name, Antialiasing &antialiasing)
+{
+    for (int i = ANTIALIASING_NONE; i <= ANTIALIASING_MSAA_8X; i++)
+    {
+        if (Renderer::antialiasingName((Antialiasing)i) == name)
+        {
+            antialiasing = (Antialiasing)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseArguments(int argc, char **argv, BenchmarkOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--update-baseline")
+            options.updateBaseline = true;
+        else if (arg == "--depth-prepass")
+            options.depthPrepass = true;
+        else if (arg == "--no-shadows")
+            options.shadows = false;
+        else if (arg == "--load-sync")
+            options.loadSync = true;
+        else if (arg == "--pack-textures")
+            options.packTextures = true;
+        else if (arg == "--material-batching")
+            options.materialBatching = true;
+        else if (arg == "--load-model" && hasValue)
+            options.loadModel = argv[++i];
+        else if (arg == "--scene" && hasValue)
+            options.scene = argv[++i];
+        else if (arg == "--path" && hasValue)
+            options.path = argv[++i];
+        else if (arg == "--warmup" && hasValue)
+            options.warmupFrames = atoi(argv[++i]);
+        else if (arg == "--frames" && hasValue)
+            options.measuredFrames = atoi(argv[++i]);
+        else if (arg == "--width" && hasValue)
+            options.width = atoi(argv[++i]);
+        else if (arg == "--height" && hasValue)
+            options.height = atoi(argv[++i]);
+        else if (arg == "--lighting" && hasValue)
+            options.lighting = argv[++i];
+        else if (arg == "--aa" && hasValue)
+            options.antialiasing = argv[++i];
+        else if (arg == "--render-scale" && hasValue)
+            options.renderScale = atof(argv[++i]);
+        else if (arg == "--dynamic-resolution" && hasValue)
+            options.dynamicResolutionTarget = atof(argv[++i]);
+        else if (arg == "--texture-budget" && hasValue)
+            options.textureBudget = atoi(argv[++i]);
+        else if (arg == "--post" && hasValue)
+        {
+            options.post = argv[++i];
+            if (!parsePostEffects(options.post, options.postEffects))
+                return false;
+        }
+        else if (arg == "--csv" && hasValue)
+            options.csvPath = argv[++i];
+        else if (arg == "--json" && hasValue)
+            options.jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue)
+            options.baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue)
+            options.threshold = atof(argv[++i]);
+        else
+        {
+            std::cout << "ERROR::BENCHMARK::UNKNOWN_ARGUMENT " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.lighting != "clustered" && options.lighting != "forward" && options.lighting != "deferred")
+    {
+        std::cout << "ERROR::BENCHMARK::UNKNOWN_LIGHTING " << options.lighting << std::endl;
+        return false;
+    }
+    Antialiasing antialiasing;
+    if (!parseAntialiasing(options.antialiasing, antialiasing))
+    {
+        std::cout << "ERROR::BENCHMARK::UNKNOWN_AA " << options.antialiasing << std::endl;
+        return false;
+    }
+    if (options.renderScale <= 0.0f || options.renderScale > 1.0f)
+    {
+        std::cout << "ERROR::BENCHMARK::RENDER_SCALE_OUT_OF_RANGE " << options.renderScale << std::endl;
+        return false;
+    }
+    if (options.measuredFrames <= 0)
+    {
+        std::cout << "ERROR::BENCHMARK::NEED_AT_LEAST_ONE_FRAME" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Nearest rank percentile
+static double percentile(vector<double> values, double fraction)
+{
+    if (values.empty())
+        return 0;
+    sort(values.begin(), values.end());
+    size_t rank = (size_t)(fraction * (values.size() - 1) + 0.5);
+    return values[min(rank, values.size() - 1)];
+}
+
+static Percentiles computePercentiles(const vector<double> &values)
+{
+    return {percentile(values, 0.50), percentile(values, 0.95), percentile(values, 0.99)};
+}
+
+static void writeCsv(const string &path, const vector<double> &cpu, const vector<double> &gpu, const vector<double> &frame)
+{
+    ofstream file(path);
+    if (!file)
+    {
+        std::cout << "ERROR::BENCHMARK::FAILED_TO_WRITE " << path << std::endl;
+        return;
+    }
+    file << "frame,cpu_ms,gpu_ms,frame_ms\n";
+    for (size_t i = 0; i < cpu.size(); i++)
+        file << i << "," << cpu[i] << "," << (i < gpu.size() ? gpu[i] : 0.0) << "," << frame[i] << "\n";
+}
+
+static void writePercentiles(ostream &out, const string &name, const Percentiles &p, bool last)
+{
+    out << "  \"" << name << "\": {\"p50\": " << p.p50 << ", \"p95\": " << p.p95 << ", \"p99\": " << p.p99 << "}"
+        << (last ? "\n" : ",\n");
+}
+
+static void writeJson(const string &path, const BenchmarkOptions &options, const BenchmarkResult &result)
+{
+    ofstream file(path);
+    if (!file)
+    {
+        std::cout << "ERROR::BENCHMARK::FAILED_TO_WRITE " << path << std::endl;
+        return;
+    }
+    file << "{\n";
+    file << "  \"scene\": \"" << options.scene << "\",\n";
+    file << "  \"path\": \"" << options.path << "\",\n";
+    file << "  \"width\": " << options.width << ",\n";
+    file << "  \"height\": " << options.height << ",\n";
+    file << "  \"lighting\": \"" << options.lighting << "\",\n";
+    file << "  \"depth_prepass\": " << (options.depthPrepass ? "true" : "false") << ",\n";
+    file << "  \"shadows\": " << (options.shadows ? "true" : "false") << ",\n";
+    file << "  \"post\": \"" << options.post << "\",\n";
+    file << "  \"aa\": \"" << options.antialiasing << "\",\n";
+    file << "  \"render_scale\": " << options.renderScale << ",\n";
+    file << "  \"dynamic_resolution_target_ms\": " << options.dynamicResolutionTarget << ",\n";
+    file << "  \"load_model\": \"" << options.loadModel << (options.loadSync ? " (sync)" : "") << "\",\n";
+    file << "  \"load_model_ms\": " << result.loadModelMilliseconds << ",\n";
+    file << "  \"frame_max_ms\": " << result.maxFrameMilliseconds << ",\n";
+    file << "  \"frames\": " << options.measuredFrames << ",\n";
+    file << "  \"draw_calls\": " << result.drawCalls << ",\n";
+    file << "  \"startup_ms\": " << result.startupMilliseconds << ",\n";
+    file << "  \"shader_load_ms\": " << result.shaderLoadMilliseconds << ",\n";
+    file << "  \"light_assign_ms\": " << result.lightAssignMilliseconds << ",\n";
+    file << "  \"shadow_cascades_per_frame\": " << result.shadowCascadesPerFrame << ",\n";
+    file << "  \"post_passes\": " << result.postPasses << ",\n";
+    file << "  \"frame_graph_textures\": " << result.frameGraphTextures << ",\n";
+    file << "  \"aa_gpu_ms\": " << result.antialiasingMilliseconds << ",\n";
+    file << "  \"stream_bytes_per_frame\": " << result.streamBytesPerFrame << ",\n";
+    file << "  \"fence_waits\": " << result.fenceWaits << ",\n";
+    file << "  \"fence_wait_ms\": " << result.fenceWaitMilliseconds << ",\n";
+    file << "  \"render_scale_avg\": " << result.averageRenderScale << ",\n";
+    file << "  \"render_scale_min\": " << result.minRenderScale << ",\n";
+    file << "  \"render_scale_changes\": " << result.renderScaleChanges << ",\n";
+    file << "  \"texture_budget_mb\": " << options.textureBudget << ",\n";
+    file << "  \"pack_textures\": " << (options.packTextures ? "true" : "false") << ",\n";
+    file << "  \"texture_resident_mb\": " << result.textureResidentMegabytes << ",\n";
+    file << "  \"texture_pending_requests\": " << result.texturePendingRequests << ",\n";
+    file << "  \"texture_levels_streamed\": " << result.textureLevelsStreamed << ",\n";
+    file << "  \"texture_levels_evicted\": " << result.textureLevelsEvicted << ",\n";
+    file << "  \"materials\": " << result.materials << ",\n";
+    file << "  \"material_reuses\": " << result.materialReuses << ",\n";
+    file << "  \"material_binds_per_frame\": " << result.materialBindsPerFrame << ",\n";
+    file << "  \"material_batching\": " << (options.materialBatching ? "true" : "false") << ",\n";
+    file << "  \"material_batches\": " << result.materialBatches << ",\n";
+    file << "  \"batch_materials\": " << result.batchMaterials << ",\n";
+    file << "  \"batch_arrays\": " << result.batchArrays << ",\n";
+    file << "  \"batch_layers\": " << result.batchLayers << ",\n";
+    file << "  \"batch_mb\": " << result.batchMegabytes << ",\n";
+    file << "  \"pass_gpu_ms\": {";
+    for (map<string, double>::const_iterator it = result.passMilliseconds.begin(); it != result.passMilliseconds.end(); ++it)
+        file << (it == result.passMilliseconds.begin() ? "" : ", ") << "\"" << it->first << "\": " << it->second;
+    file << "},\n";
+    writePercentiles(file, "cpu_ms", result.cpu, false);
+    writePercentiles(file, "gpu_ms", result.gpu, false);
+    writePercentiles(file, "frame_ms", result.frame, true);
+    file << "}\n";
+}
+
+// Returns false if anything got slower than baseline * (1 + threshold)
+static bool compareToBaseline(const string &path, const BenchmarkResult &result, float threshold)
+{
+    string json;
+    if (!read_file(path, json))
+    {
+        std::cout << "No baseline at " << path << " (run with --update-baseline to create one)" << std::endl;
+        return true;
+    }
+
+    bool passed = true;
+    const char *groups[] = {"cpu_ms", "gpu_ms"};
+    const Percentiles *current[] = {&result.cpu, &result.gpu};
+    const char *keys[] = {"p50", "p95", "p99"};
+    for (int g = 0; g < 2; g++)
+    {
+        double values[] = {current[g]->p50, current[g]->p95, current[g]->p99};
+        for (int k = 0; k < 3; k++)
+        {
+            double baseline;
+            if (!read_json_value(json, groups[g], keys[k], baseline) || baseline <= 0)
+                continue;
+            double change = (values[k] - baseline) / baseline;
+            bool regressed = change > threshold;
+            std::cout << "  " << groups[g] << "." << keys[k] << ": " << values[k] << " vs baseline " << baseline
+                      << " (" << (change >= 0 ? "+" : "") << change * 100.0 << "%)" << (regressed ? "  REGRESSION" : "") << std::endl;
+            if (regressed)
+                passed = false;
+        }
+    }
+    return passed;
+}
+
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options))
+        return 2;
+    if (options.baselinePath.empty())
+    {
+        // Generated scene descriptions contain characters that can't go in a file name
+        string fileName = options.scene;
+        for (size_t i = 0; i < fileName.size(); i++)
+        {
+            if (!isalnum(fileName[i]))
+                fileName[i] = '_';
+        }
+        options.baselinePath = "./benchmarks/baseline_" + fileName + ".json";
+    }
+
+    chrono::high_resolution_clock::time_point startupStart = chrono::high_resolution_clock::now();
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // The renderer does its own antialiasing (--aa)
+    glfwWindowHint(GLFW_SAMPLES, 0);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+
+    GLFWwindow *window = glfwCreateWindow(options.width, options.height, "Benchmark", NULL, NULL);
+    if (window == NULL)
+    {
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return 2;
+    }
+    // Shares objects w/ the main context, for loading --load-model on the loader thread
+    GLFWwindow *loaderWindow = NULL;
+    if (!options.loadModel.empty() && !options.loadSync)
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        loaderWindow = glfwCreateWindow(1, 1, "Loader", NULL, window);
+        if (loaderWindow == NULL)
+        {
+            std::cout << "ERROR::BENCHMARK::NO_LOADER_CONTEXT" << std::endl;
+            glfwTerminate();
+            return 2;
+        }
+    }
+    glfwMakeContextCurrent(window);
+    // Don't let vsync cap the frame rate
+    glfwSwapInterval(0);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return 2;
+    }
+    GLProfiler::enableFromEnvironment();
+
+    Camera camera = Camera();
+    // Deleted before glfwTerminate, its GL objects go w/ the context
+    Renderer *renderer = new Renderer(options.width, options.height);
+    if (options.lighting == "forward")
+        renderer->lightingPath = LIGHTING_FORWARD;
+    else if (options.lighting == "deferred")
+        renderer->lightingPath = LIGHTING_DEFERRED;
+    else
+        renderer->lightingPath = LIGHTING_CLUSTERED;
+    renderer->depthPrepass = options.depthPrepass;
+    renderer->shadows = options.shadows;
+    renderer->postEffects().effects = options.postEffects;
+    parseAntialiasing(options.antialiasing, renderer->antialiasing);
+    // Dynamic resolution starts from the fixed scale + never goes above it
+    renderer->renderScale = options.renderScale;
+    renderer->dynamicResolution.enabled = options.dynamicResolutionTarget > 0.0f;
+    renderer->dynamicResolution.targetMilliseconds = options.dynamicResolutionTarget;
+    renderer->dynamicResolution.maxScale = options.renderScale;
+    renderer->packTextures = options.packTextures;
+    renderer->materialBatching = options.materialBatching;
+    TextureStreamer &streamer = TextureStreamer::shared();
+    if (options.textureBudget > 0)
+        streamer.budgetBytes = (size_t)options.textureBudget * 1024 * 1024;
+    // GPU time per pass, so the cost of every antialiasing mode (+ everything else) shows up on its own
+    renderer->frameGraph().timePasses = true;
+    // Only the maps the lighting shader samples, the others load when a shader needs them
+    unsigned int textureUsage = renderer->litTextureUsage();
+    Scene *scene = load_scene(options.scene, textureUsage);
+    if (scene == NULL)
+    {
+        delete renderer;
+        glfwTerminate();
+        return 2;
+    }
+
+    // Textures load in the background, have them all in before measuring anything
+    TextureUploader &uploader = TextureUploader::shared();
+    uploader.finish();
+    double startupMilliseconds = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - startupStart).count();
+    std::cout << "Uploaded " << uploader.texturesUploaded << " textures (" << uploader.bytesUploaded / (1024 * 1024) << "MB) through PBOs";
+    if (uploader.synchronousUploads > 0)
+        std::cout << ", " << uploader.synchronousUploads << " from client memory";
+    std::cout << ", " << uploader.grayscaleTextures << " stored as R8, " << uploader.packedTextures << " w/ a packed specular map" << std::endl;
+
+    int totalFrames = options.warmupFrames + options.measuredFrames;
+    CameraPath path;
+    if (!load_camera_path(options.path, options.measuredFrames * options.timeStep, path))
+    {
+        delete scene;
+        delete renderer;
+        glfwTerminate();
+        return 2;
+    }
+
+    std::cout << "Benchmarking scene '" << options.scene << "' along '" << options.path << "': "
+              << options.warmupFrames << " warmup + " << options.measuredFrames << " measured frames at "
+              << options.width << "x" << options.height << ", " << options.lighting << " lighting"
+              << (options.depthPrepass ? " + depth pre-pass" : "") << ", aa " << options.antialiasing
+              << (options.post.empty() ? "" : ", post " + options.post)
+              << (options.renderScale < 1.0f ? ", render scale " + to_string(options.renderScale) : "")
+              << (renderer->dynamicResolution.enabled ? ", dynamic resolution " + to_string(options.dynamicResolutionTarget) + "ms" : "") << std::endl;
+
+    GLLoader *loader = NULL;
+    if (loaderWindow != NULL)
+        loader = new GLLoader([loaderWindow]() { glfwMakeContextCurrent(loaderWindow); }, []() { glfwMakeContextCurrent(NULL); });
+    chrono::high_resolution_clock::time_point loadStart;
+    double loadModelMilliseconds = 0;
+
+    GpuTimer *gpuTimer = new GpuTimer();
+    vector<double> cpuTimes, gpuTimes, frameTimes;
+    unsigned long long drawCalls = 0;
+    unsigned long long materialBinds = 0;
+    double lightAssignMilliseconds = 0;
+    unsigned long long shadowCascades = 0;
+    map<string, vector<double> > passTimes;
+    double renderScaleSum = 0;
+    float minRenderScale = options.renderScale;
+    unsigned int renderScaleChangesBefore = 0;
+    unsigned long long streamBytesBefore = 0;
+    unsigned int fenceWaitsBefore = 0;
+    double fenceWaitMillisecondsBefore = 0;
+    unsigned int textureLevelsStreamedBefore = 0;
+    unsigned int textureLevelsEvictedBefore = 0;
+    for (int frame = 0; frame < totalFrames; frame++)
+    {
+        bool measuring = frame >= options.warmupFrames;
+        // Whatever the warmup frames measured doesn't count
+        if (frame == options.warmupFrames)
+        {
+            passTimes.clear();
+            renderScaleChangesBefore = renderer->dynamicResolution.changes;
+            streamBytesBefore = renderer->streamBuffer().bytesStreamed;
+            fenceWaitsBefore = renderer->streamBuffer().fenceWaits;
+            fenceWaitMillisecondsBefore = renderer->streamBuffer().fenceWaitMilliseconds;
+            textureLevelsStreamedBefore = streamer.levelsStreamed;
+            textureLevelsEvictedBefore = streamer.levelsEvicted;
+        }
+        // Warmup frames hold the camera at the start of the path
+        float time = measuring ? (frame - options.warmupFrames) * options.timeStep : 0.0f;
+
+        chrono::high_resolution_clock::time_point frameStart = chrono::high_resolution_clock::now();
+        if (frame == options.warmupFrames && !options.loadModel.empty())
+        {
+            // Next to whatever the scene has at the origin
+            glm::mat4 transform = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(2.0f, -1.75f, 0.0f)), glm::vec3(0.2f));
+            loadStart = frameStart;
+            if (loader != NULL)
+            {
+                shared_ptr<Model *> model(new Model *(NULL));
+                string modelPath = options.loadModel;
+                loader->submit([model, modelPath, textureUsage]() { *model = new Model(modelPath, textureUsage, false); },
+                               [model, transform, scene, &loadStart, &loadModelMilliseconds]() {
+                                   (*model)->CreateVertexArrays();
+                                   scene->litModels.push_back({scene->adoptModel(*model), transform});
+                                   loadModelMilliseconds = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - loadStart).count();
+                               },
+                               [model]() { delete *model; });
+            }
+            else
+            {
+                Model *model = new Model(options.loadModel, textureUsage);
+                // Its textures still upload in the background, wait for them like the loader thread does
+                TextureUploader::shared().finish();
+                scene->litModels.push_back({scene->adoptModel(model), transform});
+                loadModelMilliseconds = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - loadStart).count();
+            }
+        }
+        if (loader != NULL)
+            loader->poll();
+        path.apply(camera, time);
+        scene->update(time);
+
+        if (measuring)
+            gpuTimer->begin();
+        renderer->render(*scene, camera);
+        if (measuring)
+            gpuTimer->end();
+        chrono::high_resolution_clock::time_point submitEnd = chrono::high_resolution_clock::now();
+
+        glfwPollEvents();
+        glfwSwapBuffers(window);
+        chrono::high_resolution_clock::time_point frameEnd = chrono::high_resolution_clock::now();
+
+        GLProfiler::endFrame();
+        if (measuring)
+        {
+            cpuTimes.push_back(chrono::duration<double, milli>(submitEnd - frameStart).count());
+            frameTimes.push_back(chrono::duration<double, milli>(frameEnd - frameStart).count());
+            drawCalls += GLProfiler::lastFrame().calls[GL_CALL_DRAW];
+            materialBinds += renderer->materialBinds();
+            if (renderer->lightingPath != LIGHTING_FORWARD)
+                lightAssignMilliseconds += renderer->lightClusters().assignMilliseconds;
+            if (renderer->shadows)
+                shadowCascades += renderer->shadowCascades().cascadesRendered;
+            gpuTimer->collect(gpuTimes);
+            // The scale render() picked for this frame
+            renderScaleSum += renderer->renderScale;
+            minRenderScale = min(minRenderScale, renderer->renderScale);
+        }
+        renderer->frameGraph().collectPassTimes(passTimes);
+        if (glfwWindowShouldClose(window))
+        {
+            std::cout << "ERROR::BENCHMARK::WINDOW_CLOSED" << std::endl;
+            delete loader;
+            delete scene;
+            delete gpuTimer;
+            delete renderer;
+            glfwTerminate();
+            return 2;
+        }
+    }
+    if (loader != NULL)
+    {
+        // Still loading after the last frame, the time still counts
+        loader->finish();
+        delete loader;
+    }
+    // Wait for the last few frames the GPU is still working on
+    gpuTimer->collect(gpuTimes, true);
+    renderer->frameGraph().collectPassTimes(passTimes, true);
+
+    BenchmarkResult result;
+    result.cpu = computePercentiles(cpuTimes);
+    result.gpu = computePercentiles(gpuTimes);
+    result.frame = computePercentiles(frameTimes);
+    result.maxFrameMilliseconds = *max_element(frameTimes.begin(), frameTimes.end());
+    result.loadModelMilliseconds = loadModelMilliseconds;
+    result.drawCalls = (unsigned int)(drawCalls / options.measuredFrames);
+    result.startupMilliseconds = startupMilliseconds;
+    result.shaderLoadMilliseconds = renderer->shaderLoadMilliseconds();
+    result.lightAssignMilliseconds = lightAssignMilliseconds / options.measuredFrames;
+    result.shadowCascadesPerFrame = (double)shadowCascades / options.measuredFrames;
+    result.postPasses = renderer->postEffects().passCount();
+    result.frameGraphTextures = renderer->frameGraph().physicalTextures;
+    result.antialiasingMilliseconds = 0;
+    const StreamBuffer &stream = renderer->streamBuffer();
+    result.streamBytesPerFrame = (double)(stream.bytesStreamed - streamBytesBefore) / options.measuredFrames;
+    result.fenceWaits = stream.fenceWaits - fenceWaitsBefore;
+    result.fenceWaitMilliseconds = stream.fenceWaitMilliseconds - fenceWaitMillisecondsBefore;
+    result.averageRenderScale = renderScaleSum / options.measuredFrames;
+    result.minRenderScale = minRenderScale;
+    result.renderScaleChanges = renderer->dynamicResolution.changes - renderScaleChangesBefore;
+    result.textureResidentMegabytes = streamer.residentBytes / (1024.0 * 1024.0);
+    result.texturePendingRequests = streamer.pendingRequests;
+    result.textureLevelsStreamed = streamer.levelsStreamed - textureLevelsStreamedBefore;
+    result.textureLevelsEvicted = streamer.levelsEvicted - textureLevelsEvictedBefore;
+    MaterialRegistry &materials = MaterialRegistry::shared();
+    result.materials = materials.materialCount();
+    result.materialReuses = materials.reuses;
+    result.materialBindsPerFrame = (double)materialBinds / options.measuredFrames;
+    result.materialBatches = result.batchMaterials = result.batchArrays = result.batchLayers = 0;
+    result.batchMegabytes = 0;
+    vector<MaterialBatch *> batches;
+    for (size_t i = 0; i < scene->litModels.size() && options.materialBatching; i++)
+    {
+        MaterialBatch *batch = scene->litModels[i].model->GetMaterialBatch();
+        // Instances share their model's batch
+        if (batch == NULL || find(batches.begin(), batches.end(), batch) != batches.end())
+            continue;
+        batches.push_back(batch);
+        result.materialBatches++;
+        result.batchMaterials += batch->materialCount();
+        result.batchArrays += batch->arrayCount();
+        result.batchLayers += batch->layerCount;
+        result.batchMegabytes += batch->textureBytes / (1024.0 * 1024.0);
+    }
+    for (map<string, vector<double> >::iterator it = passTimes.begin(); it != passTimes.end(); ++it)
+    {
+        double total = 0;
+        for (size_t i = 0; i < it->second.size(); i++)
+            total += it->second[i];
+        double average = it->second.empty() ? 0 : total / it->second.size();
+        result.passMilliseconds[it->first] = average;
+        if (it->first == "resolve" || it->first == "fxaa")
+            result.antialiasingMilliseconds += average;
+    }
+
+    std::cout << "CPU   ms  p50 " << result.cpu.p50 << "  p95 " << result.cpu.p95 << "  p99 " << result.cpu.p99 << std::endl;
+    std::cout << "GPU   ms  p50 " << result.gpu.p50 << "  p95 " << result.gpu.p95 << "  p99 " << result.gpu.p99 << std::endl;
+    std::cout << "Frame ms  p50 " << result.frame.p50 << "  p95 " << result.frame.p95 << "  p99 " << result.frame.p99
+              << "  max " << result.maxFrameMilliseconds << std::endl;
+    if (!options.loadModel.empty())
+        std::cout << "Loaded " << options.loadModel << (loaderWindow != NULL ? " on the loader thread" : " on the render thread") << " in "
+                  << result.loadModelMilliseconds << "ms" << std::endl;
+    if (GLProfiler::isEnabled())
+        std::cout << "Draw calls/frame " << result.drawCalls << std::endl;
+    if (renderer->lightingPath != LIGHTING_FORWARD)
+    {
+        const LightClusters &clusters = renderer->lightClusters();
+        std::cout << "Light assignment " << result.lightAssignMilliseconds << "ms/frame (" << clusters.visibleLights << "/"
+                  << clusters.lightCount << " lights visible, " << clusters.indexCount << " indices";
+        if (clusters.overflowCount > 0)
+            std::cout << ", " << clusters.overflowCount << " dropped from full clusters";
+        std::cout << ")" << std::endl;
+    }
+    if (renderer->shadows)
+        std::cout << "Shadow cascades redrawn/frame " << result.shadowCascadesPerFrame << " of " << SHADOW_CASCADES << std::endl;
+    const FrameGraph &graph = renderer->frameGraph();
+    std::cout << "Frame graph " << graph.passesExecuted << " passes (" << graph.passesCulled << " culled), "
+              << graph.transientTextures << " transient textures in " << graph.physicalTextures << " allocations, compiled "
+              << graph.compileCount << " time(s)" << std::endl;
+    std::cout << "Streamed " << result.streamBytesPerFrame / 1024.0 << "KB/frame (" << (stream.persistent() ? "persistent mapping" : "orphaning")
+              << ", " << stream.capacity() / 1024 << "KB/frame capacity), " << result.fenceWaits << " fence wait(s) totalling "
+              << result.fenceWaitMilliseconds << "ms" << std::endl;
+    std::cout << "GPU ms per pass:";
+    for (map<string, double>::iterator it = result.passMilliseconds.begin(); it != result.passMilliseconds.end(); ++it)
+        std::cout << " " << it->first << " " << it->second;
+    std::cout << std::endl;
+    // MSAA's extra samples also make the forward pass slower, compare it between runs too
+    std::cout << "Antialiasing passes (" << options.antialiasing << ") " << result.antialiasingMilliseconds << "ms/frame" << std::endl;
+    if (renderer->dynamicResolution.enabled)
+        std::cout << "Dynamic resolution (target " << options.dynamicResolutionTarget << "ms) render scale avg "
+                  << result.averageRenderScale << ", min " << result.minRenderScale << ", " << result.renderScaleChanges << " change(s)" << std::endl;
+    std::cout << "Textures " << result.textureResidentMegabytes << "MB resident of " << streamer.budgetBytes / (1024 * 1024) << "MB ("
+              << streamer.textureCount() << " streamed), " << result.textureLevelsStreamed << " mip level(s) streamed in, "
+              << result.textureLevelsEvicted << " evicted, " << result.texturePendingRequests << " still wanting a finer level" << std::endl;
+    std::cout << "Materials " << result.materials << " (" << result.materialReuses << " reused), " << result.materialBindsPerFrame
+              << " material binds/frame" << std::endl;
+    if (options.materialBatching)
+        std::cout << "Material batches " << result.materialBatches << " (" << result.batchMaterials << " materials in " << result.batchArrays
+                  << " texture arrays, " << result.batchLayers << " layers, " << result.batchMegabytes << "MB)" << std::endl;
+    if (!options.postEffects.empty())
+        std::cout << "Post processing " << options.post << " in " << result.postPasses << " pass(es)" << std::endl;
+
+    if (!options.csvPath.empty())
+        writeCsv(options.csvPath, cpuTimes, gpuTimes, frameTimes);
+    if (!options.jsonPath.empty())
+        writeJson(options.jsonPath, options, result);
+
+    bool passed = true;
+    if (options.updateBaseline)
+    {
+        writeJson(options.baselinePath, options, result);
+        std::cout << "Updated baseline " << options.baselinePath << std::endl;
+    }
+    else
+    {
+        passed = compareToBaseline(options.baselinePath, result, options.threshold);
+        std::cout << (passed ? "PASSED" : "FAILED: performance regressed past threshold") << std::endl;
+    }
+
+    delete scene;
+    delete gpuTimer;
+    delete renderer;
+    glfwTerminate();
+    return passed ? 0 : 1;
+}
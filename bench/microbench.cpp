@@ -0,0 +1,398 @@
+// CPU micro-benchmarks for the loader + per-frame hot paths.
+// Runs without a GL context: every GL call goes to the mocked GL layer (mock_gl.h).
+// Usage: microbench [--filter name] [--repetitions 10] [--min-time 0.05] [--json out.json]
+//                   [--baseline benchmarks/microbench_baseline.json] [--threshold 0.10]
+// Slow benchmarks (e.g. the 100MB OBJ) only run when named: --filter Synthetic100MB
+#include <glad/glad.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../src/stb_image.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <random>
+
+#include "../src/shader.h"
+#include "../src/mesh.h"
+#include "../src/model.h"
+#include "../src/camera.h"
+#include "../src/renderer.h"
+#include "../src/object_transforms.h"
+#include "../src/light_clusters.h"
+#include "../src/obj_loader.h"
+#include "mock_gl.h"
+#include "bench_harness.h"
+
+using namespace std;
+
+// Roughly the size of nanosuit's body mesh
+static const unsigned int MESH_VERTEX_COUNT = 20000;
+static const unsigned int OBJECT_COUNT = 1000;
+static const char *NANOSUIT_PATH = "./models/nanosuit/nanosuit.obj";
+// 800 x 800 quads w/ a position, uv + normal per grid point: ~105MB of OBJ
+static const unsigned int SYNTHETIC_GRID_SIZE = 800;
+static const char *SYNTHETIC_OBJ_PATH = "./microbench_synthetic.obj";
+
+// Builds an assimp mesh in memory so we don't measure the importer itself
+static aiMesh *createTestMesh(unsigned int vertexCount)
+{
+    mt19937 random(1);
+    uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    aiMesh *mesh = new aiMesh();
+    mesh->mNumVertices = vertexCount;
+    mesh->mVertices = new aiVector3D[vertexCount];
+    mesh->mNormals = new aiVector3D[vertexCount];
+    mesh->mTextureCoords[0] = new aiVector3D[vertexCount];
+    mesh->mNumUVComponents[0] = 2;
+    for (unsigned int i = 0; i < vertexCount; i++)
+    {
+        mesh->mVertices[i] = aiVector3D(unit(random), unit(random), unit(random));
+        mesh->mNormals[i] = aiVector3D(unit(random), unit(random), unit(random)).Normalize();
+        mesh->mTextureCoords[0][i] = aiVector3D(unit(random), unit(random), 0.0f);
+    }
+    mesh->mNumFaces = vertexCount / 3;
+    mesh->mFaces = new aiFace[mesh->mNumFaces];
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    {
+        mesh->mFaces[i].mNumIndices = 3;
+        mesh->mFaces[i].mIndices = new unsigned int[3];
+        for (unsigned int j = 0; j < 3; j++)
+            mesh->mFaces[i].mIndices[j] = i * 3 + j;
+    }
+    return mesh;
+}
+
+// Model::processMesh minus texture loading: assimp -> Vertex/index conversion + Mesh::setupMesh
+MICRO_BENCHMARK(ModelProcessMesh)
+{
+    aiMesh *mesh = createTestMesh(MESH_VERTEX_COUNT);
+    state.setItemsPerIteration(MESH_VERTEX_COUNT);
+    while (state.keepRunning())
+    {
+        vector<Vertex> vertices;
+        vector<unsigned int> indices;
+        ConvertMesh(mesh, vertices, indices);
+        Mesh converted(vertices, indices, vector<Texture>());
+        doNotOptimize(converted.VAO);
+    }
+    delete mesh;
+}
+
+static long long file_size(const char *path)
+{
+    ifstream file(path, ios::binary | ios::ate);
+    return file ? (long long)file.tellg() : 0;
+}
+
+static bool syntheticObjWritten = false;
+
+// Removes the synthetic OBJ (~100MB) once the benchmarks are done
+static void remove_synthetic_obj()
+{
+    if (syntheticObjWritten)
+        remove(SYNTHETIC_OBJ_PATH);
+    syntheticObjWritten = false;
+}
+
+// Written the first time a benchmark asks for it, NULL when it can't be (read only or full working directory)
+static const char *synthetic_obj()
+{
+    static bool failed = false;
+    if (syntheticObjWritten || failed)
+        return failed ? NULL : SYNTHETIC_OBJ_PATH;
+    FILE *file = fopen(SYNTHETIC_OBJ_PATH, "wb");
+    if (file == NULL)
+    {
+        std::cout << "ERROR::MICROBENCH::FAILED_TO_WRITE " << SYNTHETIC_OBJ_PATH << ", skipping the synthetic OBJ benchmarks" << std::endl;
+        failed = true;
+        return NULL;
+    }
+    bool written = true;
+    unsigned int points = SYNTHETIC_GRID_SIZE + 1;
+    for (unsigned int y = 0; y < points && written; y++)
+    {
+        for (unsigned int x = 0; x < points && written; x++)
+        {
+            float height = 0.25f * sinf(x * 0.1f) * cosf(y * 0.1f);
+            written = fprintf(file, "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n", x * 0.01f, height, y * 0.01f,
+                              (float)x / SYNTHETIC_GRID_SIZE, (float)y / SYNTHETIC_GRID_SIZE, 0.0f, 1.0f, 0.0f) > 0;
+        }
+    }
+    for (unsigned int y = 0; y < SYNTHETIC_GRID_SIZE && written; y++)
+    {
+        for (unsigned int x = 0; x < SYNTHETIC_GRID_SIZE && written; x++)
+        {
+            unsigned int a = y * points + x + 1, b = a + 1, c = a + points + 1, d = a + points;
+            written = fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c, d, d, d) > 0;
+        }
+    }
+    // The last writes only fail here when the disk fills up
+    written = fclose(file) == 0 && written;
+    if (!written)
+    {
+        std::cout << "ERROR::MICROBENCH::FAILED_TO_WRITE " << SYNTHETIC_OBJ_PATH << ", skipping the synthetic OBJ benchmarks" << std::endl;
+        remove(SYNTHETIC_OBJ_PATH);
+        failed = true;
+        return NULL;
+    }
+    syntheticObjWritten = true;
+    return SYNTHETIC_OBJ_PATH;
+}
+
+// Our parser vs assimp w/ the flags Model uses, items = bytes of OBJ
+MICRO_BENCHMARK(ObjLoadNanosuit)
+{
+    state.setItemsPerIteration(file_size(NANOSUIT_PATH));
+    while (state.keepRunning())
+    {
+        ObjModel model;
+        doNotOptimize(load_obj(NANOSUIT_PATH, model));
+    }
+}
+
+MICRO_BENCHMARK(AssimpReadFileNanosuit)
+{
+    state.setItemsPerIteration(file_size(NANOSUIT_PATH));
+    while (state.keepRunning())
+    {
+        Assimp::Importer import;
+        doNotOptimize(import.ReadFile(NANOSUIT_PATH, aiProcess_Triangulate | aiProcess_FlipUVs));
+    }
+}
+
+MICRO_BENCHMARK_SLOW(ObjLoadSynthetic100MB)
+{
+    const char *path = synthetic_obj();
+    if (path == NULL)
+        return state.skip();
+    state.setItemsPerIteration(file_size(path));
+    while (state.keepRunning())
+    {
+        ObjModel model;
+        doNotOptimize(load_obj(path, model));
+    }
+}
+
+MICRO_BENCHMARK_SLOW(AssimpReadFileSynthetic100MB)
+{
+    const char *path = synthetic_obj();
+    if (path == NULL)
+        return state.skip();
+    state.setItemsPerIteration(file_size(path));
+    while (state.keepRunning())
+    {
+        Assimp::Importer import;
+        doNotOptimize(import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs));
+    }
+}
+
+// PNG decode + copy into a PBO of a small texture (GL upload is mocked), waits for the background upload
+MICRO_BENCHMARK(TextureFromFileContainer)
+{
+    while (state.keepRunning())
+    {
+        unsigned int texture = TextureFromFile("container2.png", "./textures");
+        TextureUploader::shared().finish();
+        // Or every iteration's mip chain stays w/ the streamer
+        TextureStreamer::shared().remove(texture);
+        glDeleteTextures(1, &texture);
+    }
+}
+
+// Nanosuit's largest textures are its specular maps
+MICRO_BENCHMARK(TextureFromFileNanosuitSpec)
+{
+    while (state.keepRunning())
+    {
+        unsigned int texture = TextureFromFile("body_showroom_spec.png", "./models/nanosuit");
+        TextureUploader::shared().finish();
+        // Or every iteration's mip chain stays w/ the streamer
+        TextureStreamer::shared().remove(texture);
+        glDeleteTextures(1, &texture);
+    }
+}
+
+MICRO_BENCHMARK(SortByCameraDistance)
+{
+    mt19937 random(1);
+    uniform_real_distribution<float> unit(-20.0f, 20.0f);
+    vector<glm::vec3> positions;
+    for (int i = 0; i < 256; i++)
+        positions.push_back(glm::vec3(unit(random), unit(random), unit(random)));
+    glm::vec3 cameraPosition = glm::vec3(0.0f, 1.0f, 10.0f);
+    state.setItemsPerIteration(positions.size());
+    while (state.keepRunning())
+    {
+        positions = sortByCameraDistance(positions, cameraPosition);
+        // Move the camera so the order actually changes between iterations
+        cameraPosition.x = -cameraPosition.x;
+        doNotOptimize(positions[0]);
+    }
+}
+
+MICRO_BENCHMARK(CameraGetViewMatrix)
+{
+    Camera camera = Camera(glm::vec3(0.0f, 1.0f, 5.0f));
+    while (state.keepRunning())
+    {
+        camera.Position.x += 0.001f;
+        doNotOptimize(camera.GetViewMatrix());
+    }
+}
+
+MICRO_BENCHMARK(CameraUpdateVectors)
+{
+    Camera camera = Camera();
+    float yaw = 0.0f;
+    while (state.keepRunning())
+    {
+        yaw += 0.1f;
+        camera.SetOrientation(yaw, 10.0f);
+        doNotOptimize(camera.Front);
+    }
+}
+
+// translate * rotate * scale + model-view-projection for a batch of objects
+MICRO_BENCHMARK(ObjectTransforms)
+{
+    vector<glm::vec3> positions;
+    for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+        positions.push_back(glm::vec3(i % 32, 0.0f, i / 32));
+    vector<glm::mat4> mvp(OBJECT_COUNT);
+    glm::mat4 view = Camera(glm::vec3(0.0f, 2.0f, 10.0f)).GetViewMatrix();
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    glm::mat4 viewProjection = projection * view;
+    state.setItemsPerIteration(OBJECT_COUNT);
+    while (state.keepRunning())
+    {
+        for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+        {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::translate(model, positions[i]);
+            model = glm::rotate(model, glm::radians(i * 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            model = glm::scale(model, glm::vec3(0.2f));
+            mvp[i] = viewProjection * model;
+        }
+        doNotOptimize(mvp[0]);
+    }
+}
+
+// Model + MVP + normal matrix per object the way the vertex shader used to do it (4x4 inverse)...
+MICRO_BENCHMARK(ObjectTransformBlockGlm)
+{
+    vector<glm::mat4> models;
+    for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+        models.push_back(glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(i % 32, 0.0f, i / 32)), glm::radians(i * 1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    vector<ObjectTransform> transforms(OBJECT_COUNT);
+    glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) * Camera(glm::vec3(0.0f, 2.0f, 10.0f)).GetViewMatrix();
+    state.setItemsPerIteration(OBJECT_COUNT);
+    while (state.keepRunning())
+    {
+        for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+        {
+            transforms[i].model = models[i];
+            transforms[i].modelViewProjection = viewProjection * models[i];
+            transforms[i].normalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(models[i]))));
+        }
+        doNotOptimize(transforms[0]);
+    }
+}
+
+// ...and the batch kernel the renderer uses (std140 stride included)
+MICRO_BENCHMARK(ObjectTransformBlockBatch)
+{
+    vector<glm::mat4> models;
+    for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+        models.push_back(glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(i % 32, 0.0f, i / 32)), glm::radians(i * 1.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    const size_t stride = 256;
+    vector<unsigned char> transforms(OBJECT_COUNT * stride);
+    glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) * Camera(glm::vec3(0.0f, 2.0f, 10.0f)).GetViewMatrix();
+    state.setItemsPerIteration(OBJECT_COUNT);
+    while (state.keepRunning())
+    {
+        compute_object_transforms(models.data(), OBJECT_COUNT, viewProjection, transforms.data(), stride);
+        doNotOptimize(transforms[0]);
+    }
+}
+
+// Sorting 4096 small moving lights into the froxels (the clustered lighting path's CPU cost per frame)
+MICRO_BENCHMARK(LightClusterAssign)
+{
+    const unsigned int lightCount = 4096;
+    mt19937 random(7);
+    uniform_real_distribution<float> unit(0.0f, 1.0f);
+    vector<ClusterLight> lights(lightCount);
+    for (unsigned int i = 0; i < lightCount; i++)
+    {
+        ClusterLight &light = lights[i];
+        light.position = glm::vec3((unit(random) - 0.5f) * 60.0f, unit(random) * 4.0f, (unit(random) - 0.5f) * 60.0f);
+        light.ambient = glm::vec3(0.0f);
+        light.diffuse = glm::vec3(unit(random), unit(random), unit(random));
+        light.specular = glm::vec3(1.0f);
+        light.constant = 1.0f;
+        light.linear = 4.5f / 4.0f;
+        light.quadratic = 75.0f / 16.0f;
+        light.direction = glm::vec3(0.0f);
+        light.cutOff = -2.0f;
+        light.outerCutOff = -2.0f;
+        light.range = light_range(light.constant, light.linear, light.quadratic, 1.0f);
+    }
+    LightClusters clusters;
+    glm::mat4 view = Camera(glm::vec3(0.0f, 2.0f, 30.0f)).GetViewMatrix();
+    state.setItemsPerIteration(lightCount);
+    while (state.keepRunning())
+    {
+        clusters.update(lights.data(), lights.size(), view, 45.0f, 0.1f, 100.0f, 1280, 720);
+        doNotOptimize(clusters.indexCount);
+    }
+}
+
+// The uniforms the renderer sets on the lighting shader every frame (lookups by name + upload)
+// (transforms come from the ObjectBlock uniform buffer instead)
+MICRO_BENCHMARK(ShaderLightingUniforms)
+{
+    Shader shader = Shader("./shaders/vertex.glsl", "./shaders/fragLighting.glsl");
+    glm::vec3 vector = glm::vec3(1.0f);
+    while (state.keepRunning())
+    {
+        shader.use();
+        shader.setVec3("viewPos", vector);
+        shader.setVec3("dirLight.direction", vector);
+        shader.setVec3("dirLight.ambient", vector);
+        shader.setVec3("dirLight.diffuse", vector);
+        shader.setVec3("dirLight.specular", vector);
+        for (int i = 0; i < 4; i++)
+        {
+            string index = "[" + to_string(i) + "]";
+            shader.setVec3("pointLights" + index + ".position", vector);
+            shader.setVec3("pointLights" + index + ".ambient", vector);
+            shader.setVec3("pointLights" + index + ".diffuse", vector);
+            shader.setVec3("pointLights" + index + ".specular", vector);
+            shader.setFloat("pointLights" + index + ".constant", 1.0f);
+            shader.setFloat("pointLights" + index + ".linear", 0.09f);
+            shader.setFloat("pointLights" + index + ".quadratic", 0.032f);
+        }
+        shader.setFloat("material.shininess", 32.0f);
+    }
+}
+
+MICRO_BENCHMARK(ShaderSetMat4)
+{
+    Shader shader = Shader("./shaders/vertex.glsl", "./shaders/fragLamp.glsl");
+    glm::mat4 matrix = glm::mat4(1.0f);
+    while (state.keepRunning())
+        shader.setMat4("model", matrix);
+}
+
+int main(int argc, char **argv)
+{
+    install_mock_gl();
+    int result = run_micro_benchmarks(argc, argv);
+    remove_synthetic_obj();
+    return result;
+}
@@ -0,0 +1,120 @@
+#ifndef MOCK_GL_H
+#define MOCK_GL_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Mocked GL layer for running GL-touching code on machines without a GL context.
+// glad only exposes GL through global function pointers, so instead of loading the driver
+// we point every one of them at a stub that does nothing (and returns 0 / NULL).
+// A few entry points get smarter stubs so the code calling them keeps working:
+// object creation hands out increasing ids, compile/link/framebuffer checks succeed and mapping a buffer
+// hands out memory that stays around (per buffer) so the caller can write to it.
+
+unsigned long long mockGLCallCount = 0;
+static GLuint mockNextObjectId = 1;
+
+template <typename Function>
+struct GLStub;
+
+template <typename Result, typename... Args>
+struct GLStub<Result(APIENTRYP)(Args...)>
+{
+    static Result APIENTRY call(Args...)
+    {
+        mockGLCallCount++;
+        return Result();
+    }
+};
+
+static void APIENTRY mockGenObjects(GLsizei count, GLuint *ids)
+{
+    mockGLCallCount++;
+    for (GLsizei i = 0; i < count; i++)
+        ids[i] = mockNextObjectId++;
+}
+
+static GLuint APIENTRY mockCreateProgram()
+{
+    mockGLCallCount++;
+    return mockNextObjectId++;
+}
+
+static GLuint APIENTRY mockCreateShader(GLenum)
+{
+    mockGLCallCount++;
+    return mockNextObjectId++;
+}
+
+// Used for glGetShaderiv + glGetProgramiv, reports success for every status query
+static void APIENTRY mockGetObjectiv(GLuint, GLenum, GLint *params)
+{
+    mockGLCallCount++;
+    *params = 1;
+}
+
+static void APIENTRY mockGetIntegerv(GLenum, GLint *data)
+{
+    mockGLCallCount++;
+    *data = 0;
+}
+
+static GLenum APIENTRY mockCheckFramebufferStatus(GLenum)
+{
+    mockGLCallCount++;
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static std::map<GLenum, GLuint> mockBoundBuffers;
+static std::map<GLuint, std::vector<unsigned char> > mockBufferMemory;
+
+static void APIENTRY mockBindBuffer(GLenum target, GLuint buffer)
+{
+    mockGLCallCount++;
+    mockBoundBuffers[target] = buffer;
+}
+
+static void *APIENTRY mockMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield)
+{
+    mockGLCallCount++;
+    std::vector<unsigned char> &memory = mockBufferMemory[mockBoundBuffers[target]];
+    if (memory.size() < (std::size_t)(offset + length))
+        memory.resize(offset + length);
+    return memory.data() + offset;
+}
+
+static const GLubyte *APIENTRY mockGetString(GLenum)
+{
+    mockGLCallCount++;
+    return (const GLubyte *)"Mock GL";
+}
+
+void install_mock_gl()
+{
+#define GL_PROFILER_HOOK(function, category) \
+    glad_##function = &GLStub<decltype(glad_##function)>::call;
+#include "../src/gl_profiler_hooks.inl"
+#undef GL_PROFILER_HOOK
+
+    glad_glGenTextures = mockGenObjects;
+    glad_glGenBuffers = mockGenObjects;
+    glad_glGenVertexArrays = mockGenObjects;
+    glad_glGenFramebuffers = mockGenObjects;
+    glad_glGenRenderbuffers = mockGenObjects;
+    glad_glGenQueries = mockGenObjects;
+    glad_glGenSamplers = mockGenObjects;
+    glad_glCreateProgram = mockCreateProgram;
+    glad_glCreateShader = mockCreateShader;
+    glad_glGetShaderiv = mockGetObjectiv;
+    glad_glGetProgramiv = mockGetObjectiv;
+    glad_glGetIntegerv = mockGetIntegerv;
+    glad_glCheckFramebufferStatus = mockCheckFramebufferStatus;
+    glad_glGetString = mockGetString;
+    glad_glBindBuffer = mockBindBuffer;
+    glad_glMapBufferRange = mockMapBufferRange;
+}
+
+#endif
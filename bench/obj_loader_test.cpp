@@ -0,0 +1,86 @@
+// Checks load_obj on small hand written OBJ files, the malformed ones have to be rejected w/o writing out of bounds.
+// Runs without a GL context (load_obj makes no GL calls). Usage: obj_loader_test, exits w/ 1 if a check fails
+#include <glad/glad.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../src/stb_image.h"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "../src/obj_loader.h"
+#include "../src/thread_pool.h"
+
+using namespace std;
+
+static const char *TEST_OBJ_PATH = "./obj_loader_test.obj";
+// Enough lines that the 4 thread pool splits the file into 4 chunks (see MIN_CHUNK_BYTES)
+static const unsigned int LARGE_POSITION_COUNT = 100000;
+
+static unsigned int failures = 0;
+
+static bool write_file(const string &contents)
+{
+    FILE *file = fopen(TEST_OBJ_PATH, "wb");
+    if (file == NULL)
+        return false;
+    bool written = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    return fclose(file) == 0 && written;
+}
+
+// Loads contents as an OBJ file, counts a failure if it doesn't load (or does when it shouldn't)
+static void check(const char *name, const string &contents, bool loads, ThreadPool &pool, size_t triangles = 0)
+{
+    if (!write_file(contents))
+    {
+        std::cout << "ERROR::OBJ_LOADER_TEST::FAILED_TO_WRITE " << TEST_OBJ_PATH << std::endl;
+        failures++;
+        return;
+    }
+    ObjModel model;
+    bool loaded = load_obj(TEST_OBJ_PATH, model, pool);
+    size_t indices = 0;
+    for (size_t i = 0; i < model.meshes.size(); i++)
+        indices += model.meshes[i].indices.size();
+    bool passed = loaded == loads && (!loaded || indices == triangles * 3);
+    std::cout << (passed ? "PASSED " : "FAILED ") << name << std::endl;
+    if (!passed)
+        failures++;
+}
+
+// Positions w/ a bare "v" line after every positionsPerBare of them (0 = none), + one triangle
+static string positions(unsigned int count, unsigned int positionsPerBare)
+{
+    string contents;
+    char line[64];
+    for (unsigned int i = 0; i < count; i++)
+    {
+        snprintf(line, sizeof(line), "v %u.0 %u.5 0.25\n", i % 1000, i % 7);
+        contents += line;
+        if (positionsPerBare > 0 && (i + 1) % positionsPerBare == 0)
+            contents += "v\n";
+    }
+    return contents + "f 1 2 3\n";
+}
+
+int main()
+{
+    ThreadPool pool(4);
+    string triangle = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvn 0 0 1\nf 1/1/1 2/1/1 3/1/1\n";
+    check("Triangle", triangle, true, pool, 1);
+    check("TrailingSpaces", "v 0 0 0  \nv 1 0 0\t\nv 0 1 0\r\nf 1 2 3\n", true, pool, 1);
+    check("Quad", "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3 4\n", true, pool, 2);
+    // Bare attribute keywords are counted + then rejected, like any other line w/ missing numbers
+    check("BareVertexAtEnd", triangle + "v", false, pool);
+    check("BareVertexLine", "v 0 0 0\nv\nv 1 0 0\nv 0 1 0\nf 1 2 3\n", false, pool);
+    check("BareTexCoordAtEnd", triangle + "vt", false, pool);
+    check("BareNormalLine", "vn\n" + triangle, false, pool);
+    check("LargeFile", positions(LARGE_POSITION_COUNT, 0), true, pool, 1);
+    // In every chunk, so a miscounted line would write into the next chunk's attributes or past the last one
+    check("LargeFileBareVertices", positions(LARGE_POSITION_COUNT, LARGE_POSITION_COUNT / 16), false, pool);
+    remove(TEST_OBJ_PATH);
+
+    std::cout << (failures == 0 ? "All OBJ loader checks passed" : "OBJ loader checks FAILED") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
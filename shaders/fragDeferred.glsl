@@ -0,0 +1,56 @@
+#version 330 core
+// Lighting pass of the deferred path: one full screen pass over the G-buffer (see include/gbuffer.glsl).
+// Point + spot lights come from the same froxel lists as the clustered forward path, so every pixel
+// only pays for the lights that reach it, no matter how many triangles ended up there
+#ifndef BLINN_PHONG
+#define BLINN_PHONG 1
+#endif
+#ifndef CLUSTERED_LIGHTING
+#define CLUSTERED_LIGHTING 1
+#endif
+
+#include "include/lighting.glsl"
+#include "include/clusters.glsl"
+#include "include/gbuffer.glsl"
+#include "include/shadows.glsl"
+
+in vec2 TexCoords;
+
+uniform sampler2D gAlbedoSpecular;
+uniform sampler2D gNormal;
+uniform sampler2D gShininess;
+uniform sampler2D gDepth;
+// Clip space back to world space, for rebuilding positions from depth
+uniform mat4 inverseViewProjection;
+
+uniform DirectionalLight dirLight;
+uniform SpotLight spotLight;
+uniform vec3 viewPos;
+
+out vec4 FragColor;
+
+void main()
+{
+    float depth = texture(gDepth, TexCoords).r;
+    // Nothing was drawn here, leave it for the skybox
+    if (depth == 1.0)
+        discard;
+    vec4 clipPosition = vec4(vec3(TexCoords, depth) * 2.0 - 1.0, 1.0);
+    vec4 worldPosition = inverseViewProjection * clipPosition;
+    vec3 fragPos = worldPosition.xyz / worldPosition.w;
+
+    vec4 albedoSpecular = texture(gAlbedoSpecular, TexCoords);
+    vec3 diffuseColor = albedoSpecular.rgb;
+    vec3 specularColor = vec3(albedoSpecular.a);
+    vec3 norm = DecodeNormal(texture(gNormal, TexCoords).rg);
+    float shininess = DecodeShininess(texture(gShininess, TexCoords).r);
+    vec3 viewDir = normalize(viewPos - fragPos);
+
+    float shadow = CalcShadow(fragPos, norm, viewPos);
+    vec3 result = CalcDirLight(dirLight, norm, viewDir, diffuseColor, specularColor, shininess, shadow);
+#if CLUSTERED_LIGHTING
+    result += CalcClusteredLights(fragPos, depth, norm, viewDir, diffuseColor, specularColor, shininess);
+#endif
+    result += CalcSpotLight(spotLight, norm, fragPos, viewDir, diffuseColor, specularColor, shininess);
+    FragColor = vec4(result, 1);
+}
@@ -0,0 +1,5 @@
+#version 330 core
+// Depth pre-pass: color writes are off, only the depth buffer gets written
+void main()
+{
+}
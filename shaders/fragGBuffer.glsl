@@ -0,0 +1,65 @@
+#version 330 core
+// Geometry pass of the deferred path: only writes the surface, lighting happens later in fragDeferred.glsl
+// Variant defines (see Renderer::lightingShaderFor)
+#ifndef HAS_DIFFUSE_MAP
+#define HAS_DIFFUSE_MAP 1
+#endif
+#ifndef HAS_SPECULAR_MAP
+#define HAS_SPECULAR_MAP 1
+#endif
+// MATERIAL_BATCH 1 = the maps come from the material arrays of a MaterialBatch, per fragment (HAS_* are ignored)
+#ifndef MATERIAL_BATCH
+#define MATERIAL_BATCH 0
+#endif
+
+#include "include/gbuffer.glsl"
+#include "include/materials.glsl"
+
+struct Material {
+    sampler2D texture_diffuse1;
+    sampler2D texture_specular1;
+    float shininess;
+};
+
+in vec2 TexCoords;
+in vec3 Normal;
+in vec3 FragPos;
+#if MATERIAL_BATCH
+flat in int MaterialIndex;
+#endif
+
+uniform Material material;
+
+layout (location = 0) out vec4 gAlbedoSpecular;
+layout (location = 1) out vec2 gNormal;
+layout (location = 2) out float gShininess;
+
+void main()
+{
+#if MATERIAL_BATCH
+    vec3 diffuseColor;
+    vec3 specularColor;
+    int id;
+    SampleMaterial(MaterialIndex, TexCoords, diffuseColor, specularColor, id);
+#else
+    int id = materialId;
+#if HAS_DIFFUSE_MAP
+    vec4 diffuseSample = texture(material.texture_diffuse1, TexCoords);
+    vec3 diffuseColor = diffuseSample.rgb;
+#else
+    vec3 diffuseColor = materialParams[id].diffuse.rgb;
+#endif
+#if HAS_SPECULAR_MAP == 2
+    // Packed into the diffuse map's alpha (see Model), grey
+    vec3 specularColor = vec3(diffuseSample.a);
+#elif HAS_SPECULAR_MAP
+    vec3 specularColor = texture(material.texture_specular1, TexCoords).rgb;
+#else
+    vec3 specularColor = diffuseColor * materialParams[id].specular.rgb;
+#endif
+#endif
+    // Specular maps are grey in practice, one channel is enough
+    gAlbedoSpecular = vec4(diffuseColor, dot(specularColor, vec3(0.2126, 0.7152, 0.0722)));
+    gNormal = EncodeNormal(normalize(Normal));
+    gShininess = EncodeShininess(MaterialShininess(id, material.shininess));
+}
@@ -1,4 +1,34 @@
 #version 330 core
+// Variant defines (set by the renderer, see Renderer::lightingShaderFor), defaults below
+#ifndef NR_POINT_LIGHTS
+#define NR_POINT_LIGHTS 4
+#endif
+#ifndef BLINN_PHONG
+#define BLINN_PHONG 1
+#endif
+// Which maps the mesh actually has, a missing one isn't sampled at all
+// (HAS_SPECULAR_MAP 2 = it's in the diffuse map's alpha)
+#ifndef HAS_DIFFUSE_MAP
+#define HAS_DIFFUSE_MAP 1
+#endif
+#ifndef HAS_SPECULAR_MAP
+#define HAS_SPECULAR_MAP 1
+#endif
+// MATERIAL_BATCH 1 = the maps come from the material arrays of a MaterialBatch, per fragment (HAS_* are ignored)
+#ifndef MATERIAL_BATCH
+#define MATERIAL_BATCH 0
+#endif
+// Clustered lighting: lights come from the froxel lists built by the CPU (see light_clusters.h)
+// instead of the pointLights array, CLUSTER_X/Y/Z have to match the grid there
+#ifndef CLUSTERED_LIGHTING
+#define CLUSTERED_LIGHTING 0
+#endif
+
+#include "include/lighting.glsl"
+#include "include/clusters.glsl"
+#include "include/shadows.glsl"
+#include "include/materials.glsl"
+
 struct Material {
     sampler2D texture_diffuse1;
     sampler2D texture_specular1;
@@ -6,48 +36,19 @@ struct Material {
     float shininess;
 }; 
 
-struct DirectionalLight {
-    vec3 direction;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-
-struct PointLight {
-    vec3 position;  
-  
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-	
-    float constant;
-    float linear;
-    float quadratic;
-}; 
-
-struct SpotLight {
-    vec3  position;
-    vec3  direction;
-    float cutOff;
-    float outerCutOff;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    
-    float constant;
-    float linear;
-    float quadratic;
-};
 // Incoming from vertex shader
 // ALL INPUTS are interpolated from vertex shader
 in vec2 TexCoords;
 in vec3 Normal;
 in vec3 FragPos;
+#if MATERIAL_BATCH
+flat in int MaterialIndex;
+#endif
 
 uniform DirectionalLight dirLight;
-#define NR_POINT_LIGHTS 4  
+#if NR_POINT_LIGHTS > 0
 uniform PointLight pointLights[NR_POINT_LIGHTS];
+#endif
 uniform SpotLight spotLight;
 uniform vec3 lightColor;
 uniform vec3 viewPos;
@@ -55,109 +56,49 @@ uniform Material material;
 
 out vec4 FragColor;
 
-vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir);
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-// Blinn Phong feels more realistic than Phong and side steps a an issue with specular cut off
-bool useBlinnPhong = true;
-
 void main()
 {
     vec3 norm = normalize(Normal);
     vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 result = CalcDirLight(dirLight, norm, viewDir);
-    for(int i = 0; i < NR_POINT_LIGHTS; ++i){
-        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
-    }
-    result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
-    FragColor = vec4(result, 1);
-} 
 
-vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir)
-{
-    vec3 lightDir = normalize(-light.direction);
-    // diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    // specular shading
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    if(useBlinnPhong){
-        vec3 halfwayDir = normalize(lightDir + viewDir);
-        spec = pow(max(dot(normal, halfwayDir), 0.0),material.shininess);
-    }
-    // combine results
-    vec3 ambient  = light.ambient  * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.texture_specular1, TexCoords));
-    return (ambient + diffuse + specular);
-}  
-
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
-{
-    vec3 lightDir = normalize(light.position - fragPos);
-    // diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    // specular shading
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    if(useBlinnPhong){
-        vec3 halfwayDir = normalize(lightDir + viewDir);
-        spec = pow(max(dot(normal, halfwayDir), 0.0),material.shininess);
-    }
-    // attenuation
-    float distance    = length(light.position - fragPos);
-    // constant = makes sure denom never goes below X
-    // linear = initial fall-off
-    // quadratic = long tail that takes over as linear gets smaller
-    float attenuation = 1.0 / (light.constant + light.linear * distance + 
-  			     light.quadratic * (distance * distance));    
-    // combine results
-    vec3 ambient  = light.ambient  * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.texture_specular1, TexCoords));
-    ambient  *= attenuation;
-    diffuse  *= attenuation;
-    specular *= attenuation;
-    return (ambient + diffuse + specular);
-} 
+    // Sample the material once instead of once per light
+#if MATERIAL_BATCH
+    vec3 diffuseColor;
+    vec3 specularColor;
+    int id;
+    SampleMaterial(MaterialIndex, TexCoords, diffuseColor, specularColor, id);
+#else
+    int id = materialId;
+#if HAS_DIFFUSE_MAP
+    vec4 diffuseSample = texture(material.texture_diffuse1, TexCoords);
+    vec3 diffuseColor = diffuseSample.rgb;
+#else
+    vec3 diffuseColor = materialParams[id].diffuse.rgb;
+#endif
+#if HAS_SPECULAR_MAP == 2
+    // Packed into the diffuse map's alpha (see Model), grey
+    vec3 specularColor = vec3(diffuseSample.a);
+#elif HAS_SPECULAR_MAP
+    vec3 specularColor = texture(material.texture_specular1, TexCoords).rgb;
+#else
+    // What the unbound sampler used to read (the diffuse map on unit 0), scaled by Ks
+    vec3 specularColor = diffuseColor * materialParams[id].specular.rgb;
+#endif
+#endif
 
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir){
-    vec3 lightDir = normalize(light.position - fragPos);
-    float theta = dot(lightDir, normalize(-spotLight.direction));
-    
-    vec3 result = light.ambient * texture(material.texture_diffuse1, TexCoords).rgb;
-    if(theta > light.outerCutOff) 
-    {   
-        // diffuse 
-        float diff = max(dot(normal, lightDir), 0.0);
-        vec3 diffuse = light.diffuse * diff * texture(material.texture_diffuse1, TexCoords).rgb;  
-        
-        // specular
-        vec3 viewDir = normalize(viewPos - fragPos);
-        vec3 reflectDir = reflect(-lightDir, normal);  
-        float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-        if(useBlinnPhong){
-            vec3 halfwayDir = normalize(lightDir + viewDir);
-            spec = pow(max(dot(normal, halfwayDir), 0.0), material.shininess);
-        }
-        vec3 specular = light.specular * spec * texture(material.texture_specular1, TexCoords).rgb;  
+    float shininess = MaterialShininess(id, material.shininess);
 
-        // Soft Edges 
-        float theta = dot(lightDir, normalize(-light.direction)); 
-        float epsilon = (light.cutOff - light.outerCutOff);
-        float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
-        diffuse  *= intensity;
-        specular *= intensity;
-
-        // attenuation
-        float distance    = length(light.position - FragPos);
-        float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
-
-        // ambient  *= attenuation; // remove attenuation from ambient, as otherwise at large distances the light would be darker inside than outside the spotlight due the ambient term in the else branche
-        diffuse   *= attenuation;
-        specular *= attenuation;   
-            
-        result += diffuse + specular;
+    float shadow = CalcShadow(FragPos, norm, viewPos);
+    vec3 result = CalcDirLight(dirLight, norm, viewDir, diffuseColor, specularColor, shininess, shadow);
+#if NR_POINT_LIGHTS > 0
+    for(int i = 0; i < NR_POINT_LIGHTS; ++i){
+        result += CalcPointLight(pointLights[i], norm, FragPos, viewDir, diffuseColor, specularColor, shininess);
     }
-    return result;
-}
\ No newline at end of file
+#endif
+#if CLUSTERED_LIGHTING
+    result += CalcClusteredLights(FragPos, gl_FragCoord.z, norm, viewDir, diffuseColor, specularColor, shininess);
+#endif
+    result += CalcSpotLight(spotLight, norm, FragPos, viewDir, diffuseColor, specularColor, shininess);
+    result += materialParams[id].emissive.rgb;
+    FragColor = vec4(result, 1);
+} 
@@ -0,0 +1,115 @@
+#version 330 core
+// One pass of the post processing stack (see post_process.h). Variant defines:
+// POST_SOURCE: where the color comes from, 0 = the input as is, 1 = a 3x3 kernel, 2 = one direction of a gaussian blur,
+// 3 = FXAA
+// POST_CHAIN: the per-pixel effects fused into this pass as one expression of color, e.g. Grayscale(Invert(color))
+#ifndef POST_SOURCE
+#define POST_SOURCE 0
+#endif
+#ifndef POST_CHAIN
+#define POST_CHAIN color
+#endif
+// Has to match POST_MAX_BLUR_TAPS in post_process.h
+#define MAX_BLUR_TAPS 17
+// FXAA: longest edge (in pixels) it blurs along + how much the search direction is damped in dark/flat areas
+#define FXAA_SPAN_MAX 8.0
+#define FXAA_REDUCE_MUL (1.0 / 8.0)
+#define FXAA_REDUCE_MIN (1.0 / 128.0)
+
+in vec2 TexCoords;
+
+#include "include/post_effects.glsl"
+
+uniform sampler2D screenTexture;
+// Kernel = matrix centered on current pixel, used to sum together surrounding pixels
+// Most should sum to 1
+uniform float kernel[9];
+// Blurs are split into a horizontal + a vertical pass, 2 * radius samples a pixel instead of radius^2.
+// Each tap after the first samples between two texels so the bilinear filter averages them for us
+uniform vec2 blurDirection;
+uniform float blurOffsets[MAX_BLUR_TAPS];
+uniform float blurWeights[MAX_BLUR_TAPS];
+uniform int blurTaps;
+
+out vec4 FragColor;
+
+vec3 ApplyKernel()
+{
+    vec2 texel = 1.0 / vec2(textureSize(screenTexture, 0));
+    vec3 color = vec3(0.0);
+    for (int y = 0; y < 3; y++)
+    {
+        for (int x = 0; x < 3; x++)
+        {
+            // kernel[0] is the top-left
+            vec2 offset = vec2(x - 1, 1 - y) * texel;
+            color += texture(screenTexture, TexCoords + offset).rgb * kernel[y * 3 + x];
+        }
+    }
+    return color;
+}
+
+vec3 ApplyBlur()
+{
+    vec3 color = texture(screenTexture, TexCoords).rgb * blurWeights[0];
+    for (int i = 1; i < blurTaps; i++)
+    {
+        vec2 offset = blurDirection * blurOffsets[i];
+        color += (texture(screenTexture, TexCoords + offset).rgb + texture(screenTexture, TexCoords - offset).rgb) * blurWeights[i];
+    }
+    return color;
+}
+
+// Fast approximate anti-aliasing: finds the direction of the edge through this pixel from the luma of its
+// diagonal neighbours, then blurs along that edge (never across it). Works on the final image so it's a single
+// cheap pass no matter how much geometry there is, but it can't recover detail smaller than a pixel like MSAA
+vec3 ApplyFxaa()
+{
+    vec2 texel = 1.0 / vec2(textureSize(screenTexture, 0));
+    vec3 rgbNW = texture(screenTexture, TexCoords + vec2(-1.0, 1.0) * texel).rgb;
+    vec3 rgbNE = texture(screenTexture, TexCoords + vec2(1.0, 1.0) * texel).rgb;
+    vec3 rgbSW = texture(screenTexture, TexCoords + vec2(-1.0, -1.0) * texel).rgb;
+    vec3 rgbSE = texture(screenTexture, TexCoords + vec2(1.0, -1.0) * texel).rgb;
+    vec3 rgbM = texture(screenTexture, TexCoords).rgb;
+    vec3 toLuma = vec3(0.299, 0.587, 0.114);
+    float lumaNW = dot(rgbNW, toLuma);
+    float lumaNE = dot(rgbNE, toLuma);
+    float lumaSW = dot(rgbSW, toLuma);
+    float lumaSE = dot(rgbSE, toLuma);
+    float lumaM = dot(rgbM, toLuma);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    // Perpendicular to the luma gradient = along the edge
+    vec2 dir;
+    dir.x = -((lumaNW + lumaNE) - (lumaSW + lumaSE));
+    dir.y = (lumaNE + lumaSE) - (lumaNW + lumaSW);
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * FXAA_REDUCE_MUL), FXAA_REDUCE_MIN);
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * texel;
+
+    vec3 rgbA = 0.5 * (texture(screenTexture, TexCoords + dir * (1.0 / 3.0 - 0.5)).rgb +
+                       texture(screenTexture, TexCoords + dir * (2.0 / 3.0 - 0.5)).rgb);
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (texture(screenTexture, TexCoords - dir * 0.5).rgb +
+                                     texture(screenTexture, TexCoords + dir * 0.5).rgb);
+    // The wider blur ran past the edge into something else, fall back to the narrow one
+    float lumaB = dot(rgbB, toLuma);
+    if (lumaB < lumaMin || lumaB > lumaMax)
+        return rgbA;
+    return rgbB;
+}
+
+void main()
+{
+#if POST_SOURCE == 1
+    vec3 color = ApplyKernel();
+#elif POST_SOURCE == 2
+    vec3 color = ApplyBlur();
+#elif POST_SOURCE == 3
+    vec3 color = ApplyFxaa();
+#else
+    vec3 color = texture(screenTexture, TexCoords).rgb;
+#endif
+    color = POST_CHAIN;
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,52 @@
+// Lights sorted into froxels by the CPU (see light_clusters.h), #include after "include/lighting.glsl"
+// Only does anything with CLUSTERED_LIGHTING 1, CLUSTER_X/Y/Z have to match the grid in light_clusters.h
+#if CLUSTERED_LIGHTING
+// 6 texels per light: (position, range) (ambient, constant) (diffuse, linear) (specular, quadratic)
+// (direction, cutOff) (outerCutOff, -, -, -), point lights have an outerCutOff of -2
+uniform samplerBuffer clusterLights;
+// (first index, light count) per froxel
+uniform usamplerBuffer clusterGrid;
+uniform usamplerBuffer clusterIndices;
+uniform vec2 clusterTileSize;
+uniform float clusterNear;
+uniform float clusterFar;
+uniform float clusterDepthScale;
+uniform float clusterDepthBias;
+
+// Only the lights whose range reaches the froxel of this pixel (gl_FragCoord.xy) at windowDepth (0-1, like gl_FragCoord.z)
+vec3 CalcClusteredLights(vec3 fragPos, float windowDepth, vec3 normal, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess)
+{
+    // Undo the perspective projection to get the view space depth back
+    float ndcDepth = windowDepth * 2.0 - 1.0;
+    float depth = 2.0 * clusterNear * clusterFar / (clusterFar + clusterNear - ndcDepth * (clusterFar - clusterNear));
+    int slice = clamp(int(log(depth) * clusterDepthScale - clusterDepthBias), 0, CLUSTER_Z - 1);
+    ivec2 tile = min(ivec2(gl_FragCoord.xy / clusterTileSize), ivec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+    uvec2 cluster = texelFetch(clusterGrid, tile.x + CLUSTER_X * (tile.y + CLUSTER_Y * slice)).rg;
+
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < cluster.y; ++i)
+    {
+        int texel = int(texelFetch(clusterIndices, int(cluster.x + i)).r) * 6;
+        vec4 positionRange = texelFetch(clusterLights, texel);
+        vec4 ambientConstant = texelFetch(clusterLights, texel + 1);
+        vec4 diffuseLinear = texelFetch(clusterLights, texel + 2);
+        vec4 specularQuadratic = texelFetch(clusterLights, texel + 3);
+        vec4 directionCutOff = texelFetch(clusterLights, texel + 4);
+        float outerCutOff = texelFetch(clusterLights, texel + 5).r;
+        if (outerCutOff < -1.5)
+        {
+            PointLight light = PointLight(positionRange.xyz, ambientConstant.rgb, diffuseLinear.rgb, specularQuadratic.rgb,
+                                          ambientConstant.a, diffuseLinear.a, specularQuadratic.a);
+            result += CalcPointLight(light, normal, fragPos, viewDir, diffuseColor, specularColor, shininess);
+        }
+        else
+        {
+            SpotLight light = SpotLight(positionRange.xyz, directionCutOff.xyz, directionCutOff.w, outerCutOff,
+                                        ambientConstant.rgb, diffuseLinear.rgb, specularQuadratic.rgb,
+                                        ambientConstant.a, diffuseLinear.a, specularQuadratic.a);
+            result += CalcSpotLight(light, normal, fragPos, viewDir, diffuseColor, specularColor, shininess);
+        }
+    }
+    return result;
+}
+#endif
@@ -0,0 +1,38 @@
+// G-buffer packing shared by the geometry pass (fragGBuffer.glsl) and the lighting pass (fragDeferred.glsl)
+// Target 0 (RGBA8): diffuse color + specular intensity
+// Target 1 (RG16):  normal, octahedral encoded (a unit vector folded onto a square, 2 channels instead of 3)
+// Target 2 (R8):    shininess, log2 encoded (1 - 256)
+// Positions aren't stored, they're rebuilt from the depth buffer
+
+vec2 OctahedronWrap(vec2 v)
+{
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeNormal(vec3 n)
+{
+    // Project onto the octahedron |x| + |y| + |z| = 1, then fold the bottom half over the top one
+    n /= (abs(n.x) + abs(n.y) + abs(n.z));
+    vec2 folded = n.z >= 0.0 ? n.xy : OctahedronWrap(n.xy);
+    return folded * 0.5 + 0.5;
+}
+
+vec3 DecodeNormal(vec2 encoded)
+{
+    encoded = encoded * 2.0 - 1.0;
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+float EncodeShininess(float shininess)
+{
+    return clamp(log2(shininess) / 8.0, 0.0, 1.0);
+}
+
+float DecodeShininess(float encoded)
+{
+    return exp2(encoded * 8.0);
+}
@@ -0,0 +1,124 @@
+// Light types + shading shared by every lit shader (#include "include/lighting.glsl")
+// Specialized with:
+// BLINN_PHONG 1 = Blinn-Phong specular, 0 = Phong
+// Blinn Phong feels more realistic than Phong and side steps a an issue with specular cut off
+struct DirectionalLight {
+    vec3 direction;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct PointLight {
+    vec3 position;  
+  
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+	
+    float constant;
+    float linear;
+    float quadratic;
+}; 
+
+struct SpotLight {
+    vec3  position;
+    vec3  direction;
+    float cutOff;
+    float outerCutOff;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+// Specular factor for light arriving from lightDir
+float CalcSpecular(vec3 lightDir, vec3 normal, vec3 viewDir, float shininess)
+{
+#if BLINN_PHONG
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    return pow(max(dot(normal, halfwayDir), 0.0), shininess);
+#else
+    vec3 reflectDir = reflect(-lightDir, normal);
+    return pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+#endif
+}
+
+// diffuseColor + specularColor are the material's colors at this fragment (sampled once by the caller)
+// shadow = how much of the light reaches the fragment (1 = fully lit, see include/shadows.glsl)
+vec3 CalcDirLight(DirectionalLight light, vec3 normal, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess, float shadow)
+{
+    vec3 lightDir = normalize(-light.direction);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    float spec = CalcSpecular(lightDir, normal, viewDir, shininess);
+    // combine results
+    vec3 ambient  = light.ambient  * diffuseColor;
+    vec3 diffuse  = light.diffuse  * diff * diffuseColor;
+    vec3 specular = light.specular * spec * specularColor;
+    return (ambient + shadow * (diffuse + specular));
+}  
+
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    float spec = CalcSpecular(lightDir, normal, viewDir, shininess);
+    // attenuation
+    float distance    = length(light.position - fragPos);
+    // constant = makes sure denom never goes below X
+    // linear = initial fall-off
+    // quadratic = long tail that takes over as linear gets smaller
+    float attenuation = 1.0 / (light.constant + light.linear * distance + 
+  			     light.quadratic * (distance * distance));    
+    // combine results
+    vec3 ambient  = light.ambient  * diffuseColor;
+    vec3 diffuse  = light.diffuse  * diff * diffuseColor;
+    vec3 specular = light.specular * spec * specularColor;
+    ambient  *= attenuation;
+    diffuse  *= attenuation;
+    specular *= attenuation;
+    return (ambient + diffuse + specular);
+} 
+
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+    float theta = dot(lightDir, normalize(-light.direction));
+    
+    vec3 result = light.ambient * diffuseColor;
+    if(theta > light.outerCutOff) 
+    {   
+        // diffuse 
+        float diff = max(dot(normal, lightDir), 0.0);
+        vec3 diffuse = light.diffuse * diff * diffuseColor;  
+        
+        // specular
+        float spec = CalcSpecular(lightDir, normal, viewDir, shininess);
+        vec3 specular = light.specular * spec * specularColor;  
+
+        // Soft Edges 
+        float epsilon = (light.cutOff - light.outerCutOff);
+        float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+        diffuse  *= intensity;
+        specular *= intensity;
+
+        // attenuation
+        float distance    = length(light.position - fragPos);
+        float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
+
+        // ambient  *= attenuation; // remove attenuation from ambient, as otherwise at large distances the light would be darker inside than outside the spotlight due the ambient term in the else branche
+        diffuse   *= attenuation;
+        specular *= attenuation;   
+            
+        result += diffuse + specular;
+    }
+    return result;
+}
@@ -0,0 +1,85 @@
+// Material parameters of the MaterialRegistry (see material.h), indexed by the registry id of what's drawn.
+// MAX_MATERIALS has to match material.h
+#ifndef MAX_MATERIALS
+#define MAX_MATERIALS 256
+#endif
+// Materials of a MaterialBatch (see material_batch.h): the textures of every mesh in a model live in layers of
+// up to 4 texture arrays (one per size + format), each material says which (array, layer) its maps are in.
+// Only w/ MATERIAL_BATCH 1, MAX_BATCH_MATERIALS has to match material_batch.h
+#ifndef MATERIAL_BATCH
+#define MATERIAL_BATCH 0
+#endif
+#ifndef MAX_BATCH_MATERIALS
+#define MAX_BATCH_MATERIALS 256
+#endif
+
+// What the material file says, see MaterialParameters
+struct MaterialParams
+{
+    // rgb = Kd (the color where there's no diffuse map), a = opacity
+    vec4 diffuse;
+    // rgb = Ks (scales the diffuse color where there's no specular map), a = shininess
+    vec4 specular;
+    vec4 ambient;
+    vec4 emissive;
+};
+layout (std140) uniform MaterialParamsBlock
+{
+    MaterialParams materialParams[MAX_MATERIALS];
+};
+// Registry id of the mesh drawn (per mesh variants, a batch has one per material)
+uniform int materialId;
+
+// The instance's shininess when it has one (> 0), the material's otherwise
+float MaterialShininess(int material, float instanceShininess)
+{
+    return instanceShininess > 0.0 ? instanceShininess : materialParams[material].specular.a;
+}
+
+#if MATERIAL_BATCH
+struct BatchMaterial
+{
+    // (diffuse array, diffuse layer, specular array, specular layer), array -1 = no map, specular array -2 = in the diffuse alpha
+    ivec4 maps;
+    // Registry id
+    int material;
+};
+layout (std140) uniform MaterialBlock
+{
+    BatchMaterial materials[MAX_BATCH_MATERIALS];
+};
+uniform sampler2DArray materialArrays[4];
+
+// GLSL 330 only indexes sampler arrays w/ constants, hence the branches. The derivatives are taken outside them,
+// inside non-uniform control flow they (+ the mip level picked from them) are undefined
+vec4 SampleMaterialArray(int array, int layer, vec2 uv, vec2 dx, vec2 dy)
+{
+    vec3 coord = vec3(uv, float(layer));
+    if (array == 0)
+        return textureGrad(materialArrays[0], coord, dx, dy);
+    if (array == 1)
+        return textureGrad(materialArrays[1], coord, dx, dy);
+    if (array == 2)
+        return textureGrad(materialArrays[2], coord, dx, dy);
+    return textureGrad(materialArrays[3], coord, dx, dy);
+}
+
+// Same fallbacks as the per-mesh variants, material = the registry id
+void SampleMaterial(int batchMaterial, vec2 uv, out vec3 diffuseColor, out vec3 specularColor, out int material)
+{
+    ivec4 maps = materials[batchMaterial].maps;
+    material = materials[batchMaterial].material;
+    vec2 dx = dFdx(uv);
+    vec2 dy = dFdy(uv);
+    vec4 diffuseSample = vec4(materialParams[material].diffuse.rgb, 1.0);
+    if (maps.x >= 0)
+        diffuseSample = SampleMaterialArray(maps.x, maps.y, uv, dx, dy);
+    diffuseColor = diffuseSample.rgb;
+    if (maps.z >= 0)
+        specularColor = SampleMaterialArray(maps.z, maps.w, uv, dx, dy).rgb;
+    else if (maps.z == -2)
+        specularColor = vec3(diffuseSample.a);
+    else
+        specularColor = diffuseColor * materialParams[material].specular.rgb;
+}
+#endif
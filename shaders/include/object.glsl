@@ -0,0 +1,8 @@
+// Per-object transforms, computed once per object per frame on the CPU (see object_transforms.h)
+// normalMatrix = inverse transpose of the model matrix (upper 3x3), stored as a mat4 to keep std140 simple
+layout (std140) uniform ObjectBlock
+{
+    mat4 model;
+    mat4 modelViewProjection;
+    mat4 normalMatrix;
+} object;
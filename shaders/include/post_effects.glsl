@@ -0,0 +1,22 @@
+// Per-pixel post effects, fused into whichever pass comes before them (see post_process.h)
+// Each one only looks at the color of its own pixel, expects "in vec2 TexCoords" to be declared first
+
+// Invert
+vec3 Invert(vec3 color)
+{
+    return 1.0 - color;
+}
+
+// Greyscale (w/ weighted channels for more accurate result)
+vec3 Grayscale(vec3 color)
+{
+    float average = 0.2126 * color.r + 0.7152 * color.g + 0.0722 * color.b;
+    return vec3(average);
+}
+
+// Darkens the corners
+vec3 Vignette(vec3 color)
+{
+    float distance = length(TexCoords - vec2(0.5));
+    return color * smoothstep(0.8, 0.35, distance);
+}
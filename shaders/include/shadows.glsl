@@ -0,0 +1,45 @@
+// Cascaded shadow maps of the directional light (see shadow_cascades.h)
+// Only does anything with SHADOWS 1, SHADOW_CASCADES has to match the cascade count there
+#ifndef SHADOWS
+#define SHADOWS 0
+#endif
+
+#if SHADOWS
+// One layer per cascade, compared in hardware (returns how much of the sample is lit)
+uniform sampler2DArrayShadow shadowMap;
+// World space -> (shadow map uv, layer depth) of each cascade
+uniform mat4 shadowMatrices[SHADOW_CASCADES];
+// View depth where each cascade ends
+uniform float shadowSplits[SHADOW_CASCADES];
+// World space size of one shadow map texel in each cascade
+uniform float shadowTexelSizes[SHADOW_CASCADES];
+uniform vec3 shadowCameraForward;
+
+float CalcShadow(vec3 fragPos, vec3 normal, vec3 viewPos)
+{
+    float depth = dot(fragPos - viewPos, shadowCameraForward);
+    if (depth > shadowSplits[SHADOW_CASCADES - 1])
+        return 1.0;
+    int cascade = 0;
+    while (cascade < SHADOW_CASCADES - 1 && depth > shadowSplits[cascade])
+        cascade++;
+
+    // Pushing the lookup out along the normal by a texel or two stops surfaces from shadowing themselves (acne)
+    vec3 offsetPos = fragPos + normal * shadowTexelSizes[cascade] * 1.5;
+    vec4 coord = shadowMatrices[cascade] * vec4(offsetPos, 1.0);
+    // 3x3 PCF, softens the texel edges
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float lit = 0.0;
+    for (int x = -1; x <= 1; ++x)
+    {
+        for (int y = -1; y <= 1; ++y)
+            lit += texture(shadowMap, vec4(coord.xy + vec2(x, y) * texelSize, float(cascade), coord.z));
+    }
+    return lit / 9.0;
+}
+#else
+float CalcShadow(vec3 fragPos, vec3 normal, vec3 viewPos)
+{
+    return 1.0;
+}
+#endif
@@ -0,0 +1,13 @@
+#version 330 core
+// Depth pre-pass: positions only (Mesh::DrawDepth)
+layout (location = 0) in vec3 aPos;
+
+#include "include/object.glsl"
+
+// Has to land on exactly the same depth as vertex.glsl, or GL_EQUAL in the main pass rejects the pixel
+invariant gl_Position;
+
+void main()
+{
+    gl_Position = object.modelViewProjection * vec4(aPos, 1.0);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+// Shadow map pass: positions only (Mesh::DrawDepth), seen from the light of the cascade being drawn
+layout (location = 0) in vec3 aPos;
+
+#include "include/object.glsl"
+
+uniform mat4 lightSpace;
+
+void main()
+{
+    gl_Position = lightSpace * object.model * vec4(aPos, 1.0);
+}
@@ -4,22 +4,34 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
+// MATERIAL_BATCH 1 = drawn by a MaterialBatch, every vertex carries its material (see include/materials.glsl)
+#ifndef MATERIAL_BATCH
+#define MATERIAL_BATCH 0
+#endif
+#if MATERIAL_BATCH
+layout (location = 5) in int aMaterial;
+flat out int MaterialIndex;
+#endif
 // will be available in frag shader
 out vec2 TexCoords;
 out vec3 Normal;
 out vec3 FragPos;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "include/object.glsl"
+
+// Same depth as the depth pre-pass (vertDepth.glsl) down to the last bit, the main pass tests it w/ GL_EQUAL
+invariant gl_Position;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = object.modelViewProjection * vec4(aPos, 1.0);
     // Calculate Position in world space
-    FragPos = vec3(model * vec4(aPos,1.0));
+    FragPos = vec3(object.model * vec4(aPos,1.0));
     TexCoords = aTexCoord;
-    // generate normal matrix for transforming normals to world space
-    // NOTE: inversing matrices is not performant in shader code and should be done on CPU
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+#if MATERIAL_BATCH
+    MaterialIndex = aMaterial;
+#endif
+    // normal matrix for transforming normals to world space
+    // (inversing matrices is not performant in shader code, so it is done on the CPU)
+    Normal = mat3(object.normalMatrix) * aNormal;
 }
\ No newline at end of file
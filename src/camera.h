@@ -104,6 +104,14 @@ public:
         updateCameraVectors();
     }
 
+    // Points the camera using Euler angles directly (used for scripted camera paths)
+    void SetOrientation(float yaw, float pitch)
+    {
+        Yaw = yaw;
+        Pitch = pitch;
+        updateCameraVectors();
+    }
+
     // Processes input received from a mouse scroll-wheel event. Only requires input on the vertical wheel-axis
     void ProcessMouseScroll(float yoffset)
     {
@@ -0,0 +1,177 @@
+#ifndef CAMERA_PATH_H
+#define CAMERA_PATH_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cmath>
+
+#include "camera.h"
+
+using namespace std;
+
+struct CameraKeyframe
+{
+    float time;
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+// A list of camera keyframes that can be played back through a Camera so every benchmark run
+// sees exactly the same views. Paths can be scripted in code or recorded from the app.
+// File format = one keyframe per line: "time x y z yaw pitch"
+class CameraPath
+{
+public:
+    string name;
+    vector<CameraKeyframe> keyframes;
+
+    CameraPath(const string &name = "") : name(name) {}
+
+    float duration() const
+    {
+        return keyframes.empty() ? 0.0f : keyframes.back().time;
+    }
+
+    void addKeyframe(float time, glm::vec3 position, float yaw, float pitch)
+    {
+        keyframes.push_back({time, position, yaw, pitch});
+    }
+
+    // Records the camera's current state
+    void addKeyframe(float time, const Camera &camera)
+    {
+        addKeyframe(time, camera.Position, camera.Yaw, camera.Pitch);
+    }
+
+    // Adds a keyframe at position looking towards target
+    void addLookAt(float time, glm::vec3 position, glm::vec3 target)
+    {
+        glm::vec3 direction = glm::normalize(target - position);
+        float yaw = glm::degrees(atan2(direction.z, direction.x));
+        float pitch = glm::degrees(asin(direction.y));
+        addKeyframe(time, position, yaw, pitch);
+    }
+
+    // Moves the camera to where the path is at time (linear interpolation between keyframes)
+    void apply(Camera &camera, float time) const
+    {
+        if (keyframes.empty())
+            return;
+        if (time <= keyframes.front().time || keyframes.size() == 1)
+        {
+            applyKeyframe(camera, keyframes.front());
+            return;
+        }
+        for (size_t i = 1; i < keyframes.size(); i++)
+        {
+            if (time <= keyframes[i].time)
+            {
+                const CameraKeyframe &a = keyframes[i - 1];
+                const CameraKeyframe &b = keyframes[i];
+                float t = (time - a.time) / max(b.time - a.time, 0.0001f);
+                CameraKeyframe blended;
+                blended.position = glm::mix(a.position, b.position, t);
+                // Take the short way around when yaw wraps
+                float yawDelta = fmod(b.yaw - a.yaw + 540.0f, 360.0f) - 180.0f;
+                blended.yaw = a.yaw + yawDelta * t;
+                blended.pitch = glm::mix(a.pitch, b.pitch, t);
+                applyKeyframe(camera, blended);
+                return;
+            }
+        }
+        applyKeyframe(camera, keyframes.back());
+    }
+
+    bool save(const string &path) const
+    {
+        ofstream file(path);
+        if (!file)
+        {
+            std::cout << "ERROR::CAMERA_PATH::FAILED_TO_WRITE " << path << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < keyframes.size(); i++)
+        {
+            const CameraKeyframe &k = keyframes[i];
+            file << k.time << " " << k.position.x << " " << k.position.y << " " << k.position.z
+                 << " " << k.yaw << " " << k.pitch << "\n";
+        }
+        return true;
+    }
+
+    static bool load(const string &path, CameraPath &result)
+    {
+        ifstream file(path);
+        if (!file)
+        {
+            std::cout << "ERROR::CAMERA_PATH::FAILED_TO_READ " << path << std::endl;
+            return false;
+        }
+        result = CameraPath(path);
+        string line;
+        while (getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+            stringstream stream(line);
+            CameraKeyframe k;
+            if (stream >> k.time >> k.position.x >> k.position.y >> k.position.z >> k.yaw >> k.pitch)
+                result.keyframes.push_back(k);
+        }
+        return !result.keyframes.empty();
+    }
+
+private:
+    static void applyKeyframe(Camera &camera, const CameraKeyframe &keyframe)
+    {
+        camera.Position = keyframe.position;
+        camera.SetOrientation(keyframe.yaw, keyframe.pitch);
+    }
+};
+
+// Circles the origin at a fixed height, always looking at the center
+CameraPath orbit_camera_path(float radius, float height, float duration)
+{
+    CameraPath path("orbit");
+    const int steps = 64;
+    for (int i = 0; i <= steps; i++)
+    {
+        float angle = glm::two_pi<float>() * i / steps;
+        glm::vec3 position = glm::vec3(sin(angle) * radius, height, cos(angle) * radius);
+        path.addLookAt(duration * i / steps, position, glm::vec3(0.0f, height * 0.5f, 0.0f));
+    }
+    return path;
+}
+
+// Flies in from the front, past the lamps and windows and back out
+CameraPath flythrough_camera_path(float duration)
+{
+    CameraPath path("flythrough");
+    path.addLookAt(0.0f * duration, glm::vec3(0.0f, 1.5f, 12.0f), glm::vec3(0.0f, 1.5f, 0.0f));
+    path.addLookAt(0.25f * duration, glm::vec3(3.0f, 2.0f, 6.0f), glm::vec3(0.0f, 1.5f, 0.0f));
+    path.addLookAt(0.5f * duration, glm::vec3(6.0f, 1.0f, 0.0f), glm::vec3(-5.0f, 0.0f, 0.0f));
+    path.addLookAt(0.75f * duration, glm::vec3(0.0f, 3.0f, -8.0f), glm::vec3(0.0f, 1.0f, 5.0f));
+    path.addLookAt(1.0f * duration, glm::vec3(-6.0f, 1.5f, 4.0f), glm::vec3(0.0f, 1.5f, 0.0f));
+    return path;
+}
+
+// Named scripted paths, anything else is treated as a recorded path file
+bool load_camera_path(const string &name, float duration, CameraPath &result)
+{
+    if (name == "orbit")
+        result = orbit_camera_path(8.0f, 2.0f, duration);
+    else if (name == "flythrough")
+        result = flythrough_camera_path(duration);
+    else
+        return CameraPath::load(name, result);
+    return true;
+}
+
+#endif
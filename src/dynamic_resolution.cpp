@@ -0,0 +1,53 @@
+#include "dynamic_resolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const float DynamicResolution::SCALE_STEP = 0.05f;
+
+// Frames to wait after a change, long enough for the timer results of the new scale to come in
+static const int COOLDOWN_FRAMES = 8;
+// How much of the last measurement goes into the smoothed time
+static const double SMOOTHING = 0.2;
+// Scale up only while comfortably under budget, so it doesn't flip back + forth around the target
+static const double HEADROOM = 0.85;
+
+DynamicResolution::DynamicResolution() : enabled(false), targetMilliseconds(16.0f), minScale(0.5f), maxScale(1.0f),
+                                         smoothedMilliseconds(0.0), changes(0), framesSinceChange(0)
+{
+}
+
+float DynamicResolution::update(const vector<double> &gpuMilliseconds, float scale)
+{
+    framesSinceChange++;
+    for (size_t i = 0; i < gpuMilliseconds.size(); i++)
+    {
+        if (smoothedMilliseconds <= 0.0)
+            smoothedMilliseconds = gpuMilliseconds[i];
+        else
+            smoothedMilliseconds += (gpuMilliseconds[i] - smoothedMilliseconds) * SMOOTHING;
+    }
+    if (smoothedMilliseconds <= 0.0 || framesSinceChange < COOLDOWN_FRAMES)
+        return scale;
+
+    float desired = scale;
+    if (smoothedMilliseconds > targetMilliseconds)
+        desired = scale * (float)sqrt(targetMilliseconds / smoothedMilliseconds);
+    else if (smoothedMilliseconds < targetMilliseconds * HEADROOM)
+        // Going up is cautious (at most 2 steps), overshooting costs a frame over budget
+        desired = min(scale * (float)sqrt(targetMilliseconds * HEADROOM / smoothedMilliseconds), scale + 2.0f * SCALE_STEP);
+
+    // Down rounds down + up rounds down too, so a step is only taken once it fits the budget
+    float stepped = floor(desired / SCALE_STEP + 0.001f) * SCALE_STEP;
+    stepped = min(max(stepped, minScale), maxScale);
+    if (fabs(stepped - scale) < SCALE_STEP * 0.5f)
+        return scale;
+
+    framesSinceChange = 0;
+    changes++;
+    // The old measurements were taken at the old scale, predict what the new one costs
+    smoothedMilliseconds *= (stepped * stepped) / (scale * scale);
+    return stepped;
+}
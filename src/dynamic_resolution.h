@@ -0,0 +1,35 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <vector>
+
+using namespace std;
+
+// Picks the render scale (internal resolution / window resolution, per axis) that keeps the GPU frame time
+// at targetMilliseconds. GPU time mostly grows w/ the pixel count, so the scale moves by the square root
+// of how far off the measured time is. Changes are damped + come in steps of SCALE_STEP w/ a few frames
+// in between, every new scale means new render targets (and the timer results lag a few frames behind)
+class DynamicResolution
+{
+public:
+    static const float SCALE_STEP;
+
+    bool enabled;
+    float targetMilliseconds;
+    float minScale;
+    float maxScale;
+    // Smoothed GPU frame time the last decision was based on
+    double smoothedMilliseconds;
+    // Times the scale changed since startup
+    unsigned int changes;
+
+    DynamicResolution();
+
+    // Takes the GPU times of the frames that finished since the last call, returns the scale for the next frame
+    float update(const vector<double> &gpuMilliseconds, float scale);
+
+private:
+    int framesSinceChange;
+};
+
+#endif
@@ -0,0 +1,510 @@
+#include "frame_graph.h"
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <sstream>
+#include <iostream>
+
+using namespace std;
+
+static bool is_depth_format(GLenum internalFormat)
+{
+    return internalFormat == GL_DEPTH_COMPONENT16 || internalFormat == GL_DEPTH_COMPONENT24 || internalFormat == GL_DEPTH_COMPONENT32F ||
+           internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+
+static GLenum depth_attachment(GLenum internalFormat)
+{
+    if (internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8)
+        return GL_DEPTH_STENCIL_ATTACHMENT;
+    return GL_DEPTH_ATTACHMENT;
+}
+
+static bool same_desc(const FrameGraphTextureDesc &a, const FrameGraphTextureDesc &b)
+{
+    return a.width == b.width && a.height == b.height && a.internalFormat == b.internalFormat && a.filter == b.filter &&
+           max(a.samples, 1) == max(b.samples, 1);
+}
+
+static GLenum texture_target(const FrameGraphTextureDesc &desc)
+{
+    return desc.samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+}
+
+static unsigned int create_texture(const FrameGraphTextureDesc &desc)
+{
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    if (desc.samples > 1)
+    {
+        // Every pixel stores samples colors (or depths), all samples of a pixel are shaded once + written
+        // where the triangle covers them. Fixed sample locations so color + depth line up
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, texture);
+        glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, desc.samples, desc.internalFormat, desc.width, desc.height, GL_TRUE);
+        glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+        return texture;
+    }
+
+    // Nothing gets uploaded, but glTexImage2D still wants a format + type that fit the internal format
+    GLenum format = GL_RGBA;
+    GLenum type = GL_UNSIGNED_BYTE;
+    switch (desc.internalFormat)
+    {
+    case GL_R8:
+        format = GL_RED;
+        break;
+    case GL_RG8:
+        format = GL_RG;
+        break;
+    case GL_RG16:
+        format = GL_RG;
+        type = GL_UNSIGNED_SHORT;
+        break;
+    case GL_RGB8:
+        format = GL_RGB;
+        break;
+    case GL_RGBA16F:
+        type = GL_FLOAT;
+        break;
+    case GL_DEPTH_COMPONENT16:
+    case GL_DEPTH_COMPONENT24:
+    case GL_DEPTH_COMPONENT32F:
+        format = GL_DEPTH_COMPONENT;
+        type = GL_FLOAT;
+        break;
+    case GL_DEPTH24_STENCIL8:
+        format = GL_DEPTH_STENCIL;
+        type = GL_UNSIGNED_INT_24_8;
+        break;
+    case GL_DEPTH32F_STENCIL8:
+        format = GL_DEPTH_STENCIL;
+        type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+        break;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, desc.internalFormat, desc.width, desc.height, 0, format, type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, desc.filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, desc.filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+// Tells the driver the contents of these attachments (of the bound framebuffer) don't matter
+static void invalidate(const vector<GLenum> &attachments)
+{
+    if (GLAD_GL_ARB_invalidate_subdata && !attachments.empty())
+        glInvalidateFramebuffer(GL_FRAMEBUFFER, (GLsizei)attachments.size(), attachments.data());
+}
+
+FrameGraph::FrameGraph() : passesExecuted(0), passesCulled(0), transientTextures(0), physicalTextures(0), compileCount(0), timePasses(false)
+{
+}
+
+FrameGraph::~FrameGraph()
+{
+    for (map<vector<unsigned int>, unsigned int>::iterator it = framebuffers.begin(); it != framebuffers.end(); ++it)
+        glDeleteFramebuffers(1, &it->second);
+    for (size_t i = 0; i < physical.size(); i++)
+        glDeleteTextures(1, &physical[i].texture);
+    for (map<string, GpuTimer *>::iterator it = passTimers.begin(); it != passTimers.end(); ++it)
+        delete it->second;
+}
+
+void FrameGraph::reset()
+{
+    resources.clear();
+    passes.clear();
+}
+
+FrameGraphResource FrameGraph::createTexture(const string &name, const FrameGraphTextureDesc &desc)
+{
+    Resource resource;
+    resource.name = name;
+    resource.kind = RESOURCE_TRANSIENT;
+    resource.desc = desc;
+    resource.texture = 0;
+    resources.push_back(resource);
+    return (FrameGraphResource)resources.size() - 1;
+}
+
+FrameGraphResource FrameGraph::importTexture(const string &name, unsigned int texture, int width, int height)
+{
+    Resource resource;
+    resource.name = name;
+    resource.kind = RESOURCE_IMPORTED;
+    resource.desc.width = width;
+    resource.desc.height = height;
+    resource.desc.internalFormat = GL_NONE;
+    resource.desc.filter = GL_NONE;
+    resource.desc.samples = 0;
+    resource.texture = texture;
+    resources.push_back(resource);
+    return (FrameGraphResource)resources.size() - 1;
+}
+
+FrameGraphResource FrameGraph::importBackbuffer(int width, int height)
+{
+    FrameGraphResource resource = importTexture("backbuffer", 0, width, height);
+    resources[resource].kind = RESOURCE_BACKBUFFER;
+    return resource;
+}
+
+void FrameGraph::addPass(const string &name, const vector<FrameGraphResource> &reads, const vector<FrameGraphResource> &writes,
+                         const function<void()> &execute)
+{
+    Pass pass;
+    pass.name = name;
+    pass.reads = reads;
+    pass.writes = writes;
+    pass.execute = execute;
+    passes.push_back(pass);
+}
+
+unsigned int FrameGraph::texture(FrameGraphResource resource) const
+{
+    return resources[resource].texture;
+}
+
+const FrameGraphTextureDesc &FrameGraph::desc(FrameGraphResource resource) const
+{
+    return resources[resource].desc;
+}
+
+unsigned int FrameGraph::framebuffer(FrameGraphResource resource)
+{
+    if (resources[resource].kind == RESOURCE_BACKBUFFER)
+        return 0;
+    return framebufferFor(vector<FrameGraphResource>(1, resource));
+}
+
+void FrameGraph::collectPassTimes(map<string, vector<double> > &times, bool wait)
+{
+    for (map<string, GpuTimer *>::iterator it = passTimers.begin(); it != passTimers.end(); ++it)
+        it->second->collect(times[it->first], wait);
+}
+
+// Everything compile() depends on, imported texture names don't matter
+string FrameGraph::shape() const
+{
+    stringstream out;
+    for (size_t i = 0; i < resources.size(); i++)
+    {
+        const Resource &resource = resources[i];
+        out << resource.kind << ' ' << resource.desc.width << ' ' << resource.desc.height << ' '
+            << resource.desc.internalFormat << ' ' << resource.desc.filter << ' ' << resource.desc.samples << ';';
+    }
+    for (size_t i = 0; i < passes.size(); i++)
+    {
+        out << '|' << passes[i].name << ':';
+        for (size_t j = 0; j < passes[i].reads.size(); j++)
+            out << passes[i].reads[j] << ',';
+        out << ':';
+        for (size_t j = 0; j < passes[i].writes.size(); j++)
+            out << passes[i].writes[j] << ',';
+    }
+    return out.str();
+}
+
+void FrameGraph::compile()
+{
+    size_t passCount = passes.size();
+    compiledPasses.assign(passCount, CompiledPass());
+
+    // Culling: walking backwards, a pass is live if it writes the backbuffer or something a later live pass reads
+    vector<bool> needed(resources.size(), false);
+    for (size_t i = passCount; i-- > 0;)
+    {
+        const Pass &pass = passes[i];
+        bool live = false;
+        for (size_t j = 0; j < pass.writes.size(); j++)
+            live = live || needed[pass.writes[j]] || resources[pass.writes[j]].kind == RESOURCE_BACKBUFFER;
+        compiledPasses[i].live = live;
+        if (!live)
+            continue;
+        // Readers after this pass get what it wrote, earlier writers only matter if this pass reads it too
+        for (size_t j = 0; j < pass.writes.size(); j++)
+            needed[pass.writes[j]] = false;
+        for (size_t j = 0; j < pass.reads.size(); j++)
+            needed[pass.reads[j]] = true;
+    }
+
+    // Lifetime of every transient texture: first to last live pass touching it
+    vector<int> firstUse(resources.size(), -1);
+    vector<int> lastUse(resources.size(), -1);
+    vector<bool> written(resources.size(), false);
+    for (size_t i = 0; i < passCount; i++)
+    {
+        if (!compiledPasses[i].live)
+            continue;
+        const Pass &pass = passes[i];
+        for (size_t j = 0; j < pass.reads.size(); j++)
+        {
+            FrameGraphResource read = pass.reads[j];
+            if (resources[read].kind == RESOURCE_TRANSIENT && !written[read])
+                std::cout << "ERROR::FRAME_GRAPH::READ_BEFORE_WRITE " << resources[read].name << " in " << pass.name << std::endl;
+        }
+        vector<FrameGraphResource> used = pass.reads;
+        used.insert(used.end(), pass.writes.begin(), pass.writes.end());
+        for (size_t j = 0; j < used.size(); j++)
+        {
+            if (firstUse[used[j]] < 0)
+                firstUse[used[j]] = (int)i;
+            lastUse[used[j]] = (int)i;
+        }
+        for (size_t j = 0; j < pass.writes.size(); j++)
+            written[pass.writes[j]] = true;
+    }
+
+    assignTextures(firstUse, lastUse);
+    releaseUnused();
+
+    int lastBackbufferPass = -1;
+    for (size_t i = 0; i < passCount; i++)
+    {
+        CompiledPass &compiled = compiledPasses[i];
+        const Pass &pass = passes[i];
+        compiled.bindsTarget = false;
+        compiled.framebuffer = 0;
+        compiled.width = 0;
+        compiled.height = 0;
+        if (!compiled.live)
+            continue;
+
+        vector<FrameGraphResource> attachments;
+        bool backbuffer = false;
+        for (size_t j = 0; j < pass.writes.size(); j++)
+        {
+            const Resource &resource = resources[pass.writes[j]];
+            if (resource.kind == RESOURCE_TRANSIENT)
+                attachments.push_back(pass.writes[j]);
+            else if (resource.kind == RESOURCE_BACKBUFFER)
+                backbuffer = true;
+        }
+        if (backbuffer)
+        {
+            if (!attachments.empty())
+                std::cout << "ERROR::FRAME_GRAPH::BACKBUFFER_WITH_TEXTURES in " << pass.name << std::endl;
+            compiled.bindsTarget = true;
+            compiled.framebuffer = 0;
+            FrameGraphResource backbufferResource = -1;
+            for (size_t j = 0; j < pass.writes.size(); j++)
+            {
+                if (resources[pass.writes[j]].kind == RESOURCE_BACKBUFFER)
+                    backbufferResource = pass.writes[j];
+            }
+            compiled.width = resources[backbufferResource].desc.width;
+            compiled.height = resources[backbufferResource].desc.height;
+            lastBackbufferPass = (int)i;
+            continue;
+        }
+        if (attachments.empty())
+            continue;
+
+        compiled.bindsTarget = true;
+        compiled.framebuffer = framebufferFor(attachments);
+        compiled.width = resources[attachments[0]].desc.width;
+        compiled.height = resources[attachments[0]].desc.height;
+        int color = 0;
+        for (size_t j = 0; j < attachments.size(); j++)
+        {
+            FrameGraphResource resource = attachments[j];
+            GLenum internalFormat = resources[resource].desc.internalFormat;
+            GLenum attachment = is_depth_format(internalFormat) ? depth_attachment(internalFormat) : GL_COLOR_ATTACHMENT0 + color++;
+            // Nothing before this pass wrote it (the memory may still hold another texture's contents)
+            if (firstUse[resource] == (int)i && find(pass.reads.begin(), pass.reads.end(), resource) == pass.reads.end())
+                compiled.invalidateBefore.push_back(attachment);
+            // Nothing after this pass reads it, no need to keep the result
+            if (lastUse[resource] == (int)i)
+                compiled.invalidateAfter.push_back(attachment);
+        }
+    }
+    // Nothing reads the screen's depth + stencil once the last pass drawing to it is done
+    if (lastBackbufferPass >= 0)
+    {
+        compiledPasses[lastBackbufferPass].invalidateAfter.push_back(GL_DEPTH);
+        compiledPasses[lastBackbufferPass].invalidateAfter.push_back(GL_STENCIL);
+    }
+}
+
+void FrameGraph::assignTextures(const vector<int> &firstUse, const vector<int> &lastUse)
+{
+    for (size_t i = 0; i < physical.size(); i++)
+    {
+        physical[i].busyUntil = -1;
+        physical[i].used = false;
+    }
+
+    // Greedy in order of first use: take any texture of the same description whose last user is done by then
+    vector<FrameGraphResource> order;
+    for (size_t i = 0; i < resources.size(); i++)
+    {
+        if (resources[i].kind == RESOURCE_TRANSIENT && firstUse[i] >= 0)
+            order.push_back((FrameGraphResource)i);
+    }
+    stable_sort(order.begin(), order.end(), [&firstUse](FrameGraphResource a, FrameGraphResource b) {
+        return firstUse[a] < firstUse[b];
+    });
+
+    compiledPhysical.assign(resources.size(), -1);
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        FrameGraphResource resource = order[i];
+        int slot = -1;
+        for (size_t j = 0; j < physical.size() && slot < 0; j++)
+        {
+            if (same_desc(physical[j].desc, resources[resource].desc) && physical[j].busyUntil < firstUse[resource])
+                slot = (int)j;
+        }
+        if (slot < 0)
+        {
+            PhysicalTexture texture;
+            texture.desc = resources[resource].desc;
+            texture.texture = create_texture(texture.desc);
+            texture.busyUntil = -1;
+            texture.used = false;
+            physical.push_back(texture);
+            slot = (int)physical.size() - 1;
+        }
+        physical[slot].busyUntil = lastUse[resource];
+        physical[slot].used = true;
+        compiledPhysical[resource] = slot;
+    }
+
+    transientTextures = (unsigned int)order.size();
+    physicalTextures = 0;
+    for (size_t i = 0; i < physical.size(); i++)
+        physicalTextures += physical[i].used ? 1 : 0;
+}
+
+// Deletes the textures the new plan doesn't use + the framebuffers made from them
+void FrameGraph::releaseUnused()
+{
+    vector<int> remap(physical.size(), -1);
+    vector<PhysicalTexture> kept;
+    for (size_t i = 0; i < physical.size(); i++)
+    {
+        if (physical[i].used)
+        {
+            remap[i] = (int)kept.size();
+            kept.push_back(physical[i]);
+            continue;
+        }
+        for (map<vector<unsigned int>, unsigned int>::iterator it = framebuffers.begin(); it != framebuffers.end();)
+        {
+            if (find(it->first.begin(), it->first.end(), physical[i].texture) != it->first.end())
+            {
+                glDeleteFramebuffers(1, &it->second);
+                framebuffers.erase(it++);
+            }
+            else
+                ++it;
+        }
+        glDeleteTextures(1, &physical[i].texture);
+    }
+    physical = kept;
+    for (size_t i = 0; i < compiledPhysical.size(); i++)
+    {
+        if (compiledPhysical[i] >= 0)
+        {
+            compiledPhysical[i] = remap[compiledPhysical[i]];
+            resources[i].texture = physical[compiledPhysical[i]].texture;
+        }
+    }
+}
+
+unsigned int FrameGraph::framebufferFor(const vector<FrameGraphResource> &attachments)
+{
+    vector<unsigned int> key;
+    for (size_t i = 0; i < attachments.size(); i++)
+        key.push_back(resources[attachments[i]].texture);
+    map<vector<unsigned int>, unsigned int>::iterator found = framebuffers.find(key);
+    if (found != framebuffers.end())
+        return found->second;
+
+    // A FrameBuffer Requires
+    // 1. At least one attached buffer (color, depth or stencil buffer).
+    // 2. All attachments should be complete (reserved memory).
+    // 3. Each buffer should have the same number of samples.
+    unsigned int framebuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    vector<GLenum> drawBuffers;
+    for (size_t i = 0; i < attachments.size(); i++)
+    {
+        const Resource &resource = resources[attachments[i]];
+        GLenum attachment = GL_COLOR_ATTACHMENT0 + (GLenum)drawBuffers.size();
+        if (is_depth_format(resource.desc.internalFormat))
+            attachment = depth_attachment(resource.desc.internalFormat);
+        else
+            drawBuffers.push_back(attachment);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, texture_target(resource.desc), resource.texture, 0);
+    }
+    // Fragment outputs 0.. go to the color attachments in the order they were written
+    if (drawBuffers.empty())
+        glDrawBuffer(GL_NONE);
+    else
+        glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::FRAME_GRAPH:: Framebuffer is not complete!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    framebuffers[key] = framebuffer;
+    return framebuffer;
+}
+
+void FrameGraph::execute()
+{
+    string current = shape();
+    if (current != compiledShape)
+    {
+        compile();
+        compiledShape = current;
+        compileCount++;
+    }
+    else
+    {
+        for (size_t i = 0; i < resources.size(); i++)
+        {
+            if (compiledPhysical[i] >= 0)
+                resources[i].texture = physical[compiledPhysical[i]].texture;
+        }
+    }
+
+    passesExecuted = 0;
+    passesCulled = 0;
+    for (size_t i = 0; i < passes.size(); i++)
+    {
+        const CompiledPass &compiled = compiledPasses[i];
+        if (!compiled.live)
+        {
+            passesCulled++;
+            continue;
+        }
+        GpuTimer *timer = NULL;
+        if (timePasses)
+        {
+            GpuTimer *&passTimer = passTimers[passes[i].name];
+            if (passTimer == NULL)
+                passTimer = new GpuTimer();
+            timer = passTimer;
+            timer->begin();
+        }
+        if (compiled.bindsTarget)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, compiled.framebuffer);
+            glViewport(0, 0, compiled.width, compiled.height);
+            invalidate(compiled.invalidateBefore);
+        }
+        passes[i].execute();
+        if (compiled.bindsTarget && !compiled.invalidateAfter.empty())
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, compiled.framebuffer);
+            invalidate(compiled.invalidateAfter);
+        }
+        if (timer != NULL)
+            timer->end();
+        passesExecuted++;
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef FRAME_GRAPH_H
+#define FRAME_GRAPH_H
+
+#include <glad/glad.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gpu_timer.h"
+
+using namespace std;
+
+// Handle of a texture in a FrameGraph, only valid for the frame it was created in
+typedef int FrameGraphResource;
+
+struct FrameGraphTextureDesc
+{
+    int width;
+    int height;
+    // e.g. GL_RGB8, GL_RG16 or GL_DEPTH24_STENCIL8 (depth formats are attached as depth (+ stencil))
+    GLenum internalFormat;
+    // GL_LINEAR or GL_NEAREST
+    GLenum filter;
+    // > 1 for a multisampled texture (can't be sampled w/ texture(), resolve it w/ a blit first)
+    int samples;
+};
+
+// Describes a frame as passes that declare the textures they read + write, then runs it.
+// Instead of every effect owning its framebuffers forever, the graph owns the intermediate ("transient") textures:
+//   - passes whose results nobody reads are culled (only the backbuffer has to be written)
+//   - transient textures w/ the same description whose passes don't overlap share one GL texture
+//   - contents that are about to be overwritten or won't be read again are invalidated,
+//     so the driver doesn't have to load or store them (GL_ARB_invalidate_subdata, when available)
+//   - every pass gets the framebuffer of the textures it writes bound + a matching viewport
+// The graph is built again every frame, it's only recompiled when its shape changes
+class FrameGraph
+{
+public:
+    // Stats of the last execute()
+    unsigned int passesExecuted;
+    unsigned int passesCulled;
+    // Transient textures used by the live passes vs GL textures behind them after aliasing
+    unsigned int transientTextures;
+    unsigned int physicalTextures;
+    unsigned int compileCount;
+    // Time every pass on the GPU, see collectPassTimes
+    bool timePasses;
+
+    FrameGraph();
+    ~FrameGraph();
+
+    // Forgets the passes + resources of the last frame, its textures + framebuffers are kept to be reused
+    void reset();
+    // A texture that only lives for this frame
+    FrameGraphResource createTexture(const string &name, const FrameGraphTextureDesc &desc);
+    // A texture owned by someone else (e.g. a cached shadow map). Passes writing it bind their own target
+    FrameGraphResource importTexture(const string &name, unsigned int texture, int width, int height);
+    // The default framebuffer, the only thing a pass has to write to not be culled
+    FrameGraphResource importBackbuffer(int width, int height);
+    // Adds a pass, passes run in the order they're added.
+    // A resource in both reads + writes means the pass draws on top of what's there (it isn't cleared for it).
+    // Before execute() the pass' framebuffer (its transient writes, or the backbuffer) is bound w/ a viewport covering it
+    void addPass(const string &name, const vector<FrameGraphResource> &reads, const vector<FrameGraphResource> &writes,
+                 const function<void()> &execute);
+    // Compiles (when the passes changed since last frame) + runs the live passes
+    void execute();
+    // GL texture behind a resource, transient ones only have one while execute() runs
+    unsigned int texture(FrameGraphResource resource) const;
+    const FrameGraphTextureDesc &desc(FrameGraphResource resource) const;
+    // Framebuffer w/ only this texture attached (0 for the backbuffer), e.g. to blit from or to while execute() runs.
+    // Changes the framebuffer binding when it has to create one
+    unsigned int framebuffer(FrameGraphResource resource);
+    // Appends the finished GPU times (ms) of every timed pass to times[pass name], wait = block until all are done
+    void collectPassTimes(map<string, vector<double> > &times, bool wait = false);
+
+private:
+    enum ResourceKind
+    {
+        RESOURCE_TRANSIENT,
+        RESOURCE_IMPORTED,
+        RESOURCE_BACKBUFFER
+    };
+    struct Resource
+    {
+        string name;
+        ResourceKind kind;
+        FrameGraphTextureDesc desc;
+        // Imported texture, or the transient's physical texture once compiled
+        unsigned int texture;
+    };
+    struct Pass
+    {
+        string name;
+        vector<FrameGraphResource> reads;
+        vector<FrameGraphResource> writes;
+        function<void()> execute;
+    };
+    // What compile() decided, reused while the graph keeps the same shape
+    struct CompiledPass
+    {
+        bool live;
+        // Has a framebuffer to bind (writes transients or the backbuffer)
+        bool bindsTarget;
+        unsigned int framebuffer;
+        int width;
+        int height;
+        vector<GLenum> invalidateBefore;
+        vector<GLenum> invalidateAfter;
+    };
+    struct PhysicalTexture
+    {
+        FrameGraphTextureDesc desc;
+        unsigned int texture;
+        // Last pass (this frame) of the resource using it, while assigning
+        int busyUntil;
+        bool used;
+    };
+
+    vector<Resource> resources;
+    vector<Pass> passes;
+    string compiledShape;
+    vector<CompiledPass> compiledPasses;
+    vector<int> compiledPhysical;
+    vector<PhysicalTexture> physical;
+    // Attachments (textures in attachment order) -> framebuffer
+    map<vector<unsigned int>, unsigned int> framebuffers;
+    map<string, GpuTimer *> passTimers;
+
+    string shape() const;
+    void compile();
+    void assignTextures(const vector<int> &firstUse, const vector<int> &lastUse);
+    unsigned int framebufferFor(const vector<FrameGraphResource> &attachments);
+    void releaseUnused();
+
+    FrameGraph(const FrameGraph &);
+    FrameGraph &operator=(const FrameGraph &);
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "gbuffer.h"
+#include <glad/glad.h>
+
+GBuffer create_gbuffer(FrameGraph &graph, int width, int height, FrameGraphResource depthStencil)
+{
+    // Read back 1:1 by the lighting pass, filtering would blend neighbouring surfaces
+    FrameGraphTextureDesc desc = {width, height, GL_RGBA8, GL_NEAREST, 0};
+    GBuffer gBuffer;
+    gBuffer.albedoSpecular = graph.createTexture("gAlbedoSpecular", desc);
+    desc.internalFormat = GL_RG16;
+    gBuffer.normal = graph.createTexture("gNormal", desc);
+    desc.internalFormat = GL_R8;
+    gBuffer.shininess = graph.createTexture("gShininess", desc);
+    gBuffer.depthStencil = depthStencil;
+    return gBuffer;
+}
+
+vector<FrameGraphResource> gbuffer_targets(const GBuffer &gBuffer)
+{
+    vector<FrameGraphResource> targets;
+    targets.push_back(gBuffer.albedoSpecular);
+    targets.push_back(gBuffer.normal);
+    targets.push_back(gBuffer.shininess);
+    targets.push_back(gBuffer.depthStencil);
+    return targets;
+}
+
+void clear_gbuffer()
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+}
+
+void bind_gbuffer_textures(const FrameGraph &graph, const GBuffer &gBuffer, int firstUnit)
+{
+    FrameGraphResource textures[4] = {gBuffer.albedoSpecular, gBuffer.normal, gBuffer.shininess, gBuffer.depthStencil};
+    for (int i = 0; i < 4; i++)
+    {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_2D, graph.texture(textures[i]));
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
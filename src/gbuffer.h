@@ -0,0 +1,31 @@
+#ifndef GBUFFER_H
+#define GBUFFER_H
+
+#include <glad/glad.h>
+
+#include "frame_graph.h"
+
+// Targets of the deferred path's geometry pass (layout in shaders/include/gbuffer.glsl):
+// diffuse + specular (RGBA8), octahedral normal (RG16), shininess (R8) and depth + stencil,
+// 8 bytes of color per pixel. Depth is a texture so the lighting pass can rebuild positions from it.
+// They're transient frame graph textures, so nothing is allocated while the deferred path isn't used
+struct GBuffer
+{
+    FrameGraphResource albedoSpecular;
+    FrameGraphResource normal;
+    FrameGraphResource shininess;
+    // The scene's own depth + stencil, so forward drawn objects (lamps, transparent windows, skybox)
+    // are still hidden behind the deferred ones without copying it over
+    FrameGraphResource depthStencil;
+};
+
+// Adds the color targets of a width x height G-buffer to the graph, depthStencil is the scene's depth
+GBuffer create_gbuffer(FrameGraph &graph, int width, int height, FrameGraphResource depthStencil);
+// The targets the geometry pass writes, in fragment output order (depth last)
+vector<FrameGraphResource> gbuffer_targets(const GBuffer &gBuffer);
+// Clears the bound G-buffer, zero everywhere (including the specular in alpha)
+void clear_gbuffer();
+// Binds the 4 textures to firstUnit.. in the order albedoSpecular, normal, shininess, depth
+void bind_gbuffer_textures(const FrameGraph &graph, const GBuffer &gBuffer, int firstUnit);
+
+#endif
@@ -0,0 +1,121 @@
+#include "gl_loader.h"
+#include <glad/glad.h>
+
+#include "texture_uploader.h"
+
+#include <chrono>
+
+using namespace std;
+
+GLLoader::GLLoader(const function<void()> &makeCurrent, const function<void()> &release) : loadsCompleted(0), loadMilliseconds(0.0),
+                                                                                           inProgress(0), stopping(false)
+{
+    worker = thread(&GLLoader::workerLoop, this, makeCurrent, release);
+}
+
+GLLoader::~GLLoader()
+{
+    {
+        lock_guard<mutex> lock(loadsMutex);
+        stopping = true;
+    }
+    loadsAvailable.notify_all();
+    worker.join();
+    // The fences + objects of loads nobody polled for belong to the same share group, the render thread's context can
+    // delete them. The queued loads never ran, there's nothing of theirs to free
+    for (size_t i = 0; i < loaded.size(); i++)
+    {
+        glDeleteSync(loaded[i].fence);
+        if (loaded[i].drop)
+            loaded[i].drop();
+    }
+}
+
+void GLLoader::workerLoop(function<void()> makeCurrent, function<void()> release)
+{
+    makeCurrent();
+    while (true)
+    {
+        Load load;
+        {
+            unique_lock<mutex> lock(loadsMutex);
+            loadsAvailable.wait(lock, [this] { return stopping || !queued.empty(); });
+            if (stopping)
+                break;
+            load = queued.front();
+            queued.pop_front();
+            inProgress++;
+        }
+
+        chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+        load.load();
+        // Textures the load started go through this thread's uploader, they have to be in before it's published
+        TextureUploader::shared().finish();
+        load.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        // Without a flush the fence may never reach the GPU, the render thread would wait forever
+        glFlush();
+        load.milliseconds = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+
+        lock_guard<mutex> lock(loadsMutex);
+        loaded.push_back(load);
+        inProgress--;
+    }
+    // The PBOs of this thread's uploader go w/ its context
+    TextureUploader::shared().releasePixelBuffers();
+    release();
+}
+
+void GLLoader::submit(const function<void()> &load, const function<void()> &ready, const function<void()> &drop)
+{
+    Load entry;
+    entry.load = load;
+    entry.ready = ready;
+    entry.drop = drop;
+    entry.fence = NULL;
+    entry.milliseconds = 0.0;
+    {
+        lock_guard<mutex> lock(loadsMutex);
+        queued.push_back(entry);
+    }
+    loadsAvailable.notify_one();
+}
+
+unsigned int GLLoader::poll()
+{
+    unsigned int completed = 0;
+    while (true)
+    {
+        Load load;
+        {
+            lock_guard<mutex> lock(loadsMutex);
+            if (loaded.empty())
+                break;
+            // Loads finish in order, if the oldest isn't done on the GPU the others aren't either
+            if (glClientWaitSync(loaded.front().fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+                break;
+            load = loaded.front();
+            loaded.pop_front();
+        }
+        glDeleteSync(load.fence);
+        load.ready();
+        loadsCompleted++;
+        loadMilliseconds += load.milliseconds;
+        completed++;
+    }
+    return completed;
+}
+
+void GLLoader::finish()
+{
+    while (pending() > 0)
+    {
+        if (poll() == 0)
+            this_thread::yield();
+    }
+}
+
+unsigned int GLLoader::pending() const
+{
+    lock_guard<mutex> lock(loadsMutex);
+    return (unsigned int)(queued.size() + loaded.size()) + inProgress;
+}
@@ -0,0 +1,66 @@
+#ifndef GL_LOADER_H
+#define GL_LOADER_H
+
+#include <glad/glad.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// Thread w/ its own GL context (sharing objects w/ the render thread's) that loads models + textures,
+// so creating + filling their buffers and textures doesn't take frame time.
+// A load's results are published w/ a fence: ready() runs on the render thread (in poll()) once the GPU
+// has done every command the load issued, that's where the render thread adds them to the scene.
+// Vertex arrays aren't shared between contexts, ready() is also where they get created (see Mesh)
+class GLLoader
+{
+public:
+    // Loads finished (ready() ran) + the time their load() took on the loader thread
+    unsigned int loadsCompleted;
+    double loadMilliseconds;
+
+    // makeCurrent makes the loader's context current on the calling thread (e.g. glfwMakeContextCurrent on a hidden
+    // window created to share w/ the main one), release lets go of it again. Both run on the loader thread
+    GLLoader(const function<void()> &makeCurrent, const function<void()> &release);
+    // Waits for the load in progress, the queued ones are dropped. Loads that ran but weren't made ready get their drop()
+    // instead, on the calling thread (w/ the render thread's context current, like poll())
+    ~GLLoader();
+
+    // load runs on the loader thread (GL calls are fine), ready on the thread calling poll(). drop frees what load
+    // made when the loader is destroyed before ready() could run
+    void submit(const function<void()> &load, const function<void()> &ready, const function<void()> &drop = function<void()>());
+    // Runs ready() of every load the GPU is done with, call once a frame from the render thread
+    unsigned int poll();
+    // Blocks until every submitted load is ready
+    void finish();
+    unsigned int pending() const;
+
+private:
+    struct Load
+    {
+        function<void()> load;
+        function<void()> ready;
+        function<void()> drop;
+        GLsync fence;
+        double milliseconds;
+    };
+
+    thread worker;
+    mutable mutex loadsMutex;
+    condition_variable loadsAvailable;
+    deque<Load> queued;
+    deque<Load> loaded;
+    unsigned int inProgress;
+    bool stopping;
+
+    void workerLoop(function<void()> makeCurrent, function<void()> release);
+
+    GLLoader(const GLLoader &);
+    GLLoader &operator=(const GLLoader &);
+};
+
+#endif
@@ -0,0 +1,451 @@
+#include "gl_profiler.h"
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+// One id per interceptable GL function
+enum GLHookId
+{
+#define GL_PROFILER_HOOK(function, category) HOOK_##function,
+#include "gl_profiler_hooks.inl"
+#undef GL_PROFILER_HOOK
+    GL_HOOK_COUNT
+};
+
+struct GLFunctionStats
+{
+    const char *name;
+    GLCallCategory category;
+    // Reset every frame
+    unsigned int frameCalls;
+    double frameMilliseconds;
+    size_t frameBytes;
+    // Accumulated since the profiler was enabled
+    unsigned long long totalCalls;
+    double totalMilliseconds;
+    unsigned int peakFrameCalls;
+};
+
+static GLFunctionStats functionStats[GL_HOOK_COUNT] = {
+#define GL_PROFILER_HOOK(function, category) {#function, category, 0, 0, 0, 0, 0, 0},
+#include "gl_profiler_hooks.inl"
+#undef GL_PROFILER_HOOK
+};
+
+// Ring buffer of the last N frames, used for the histograms
+static const unsigned int FRAME_HISTORY_SIZE = 300;
+static GLFrameStats frameHistory[FRAME_HISTORY_SIZE];
+static unsigned int frameHistoryCount = 0;
+static unsigned int frameHistoryHead = 0;
+static unsigned int framesSinceReport = 0;
+static unsigned int violationCount = 0;
+static GLFrameStats emptyFrame = {};
+static bool profilerEnabled = false;
+// Only the thread that enabled the profiler (the render thread) counts its calls: the counters aren't atomic,
+// the loader thread's calls (see GLLoader) go straight to the driver
+static thread_local bool countsCalls = false;
+
+GLProfilerBudget GLProfiler::budget;
+unsigned int GLProfiler::reportInterval = 300;
+
+// Works out how many bytes an upload call transfers, 0 for every call that isn't an upload
+static size_t bytesPerPixel(GLenum format, GLenum type)
+{
+    size_t components = 4;
+    if (format == GL_RED || format == GL_DEPTH_COMPONENT || format == GL_STENCIL_INDEX)
+        components = 1;
+    else if (format == GL_RG || format == GL_DEPTH_STENCIL)
+        components = 2;
+    else if (format == GL_RGB || format == GL_BGR)
+        components = 3;
+
+    if (type == GL_FLOAT || type == GL_UNSIGNED_INT || type == GL_INT)
+        return components * 4;
+    if (type == GL_HALF_FLOAT || type == GL_UNSIGNED_SHORT || type == GL_SHORT)
+        return components * 2;
+    return components;
+}
+
+template <int Id>
+struct UploadSize
+{
+    template <typename... Args>
+    static size_t of(Args...) { return 0; }
+};
+
+template <>
+struct UploadSize<HOOK_glBufferData>
+{
+    static size_t of(GLenum, GLsizeiptr size, const void *data, GLenum) { return data ? size : 0; }
+};
+
+template <>
+struct UploadSize<HOOK_glBufferSubData>
+{
+    static size_t of(GLenum, GLintptr, GLsizeiptr size, const void *) { return size; }
+};
+
+template <>
+struct UploadSize<HOOK_glTexImage2D>
+{
+    static size_t of(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum type, const void *pixels)
+    {
+        return pixels ? width * height * bytesPerPixel(format, type) : 0;
+    }
+};
+
+template <>
+struct UploadSize<HOOK_glTexSubImage2D>
+{
+    static size_t of(GLenum, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
+    {
+        return pixels ? width * height * bytesPerPixel(format, type) : 0;
+    }
+};
+
+template <>
+struct UploadSize<HOOK_glTexImage3D>
+{
+    static size_t of(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLsizei depth, GLint, GLenum format, GLenum type, const void *pixels)
+    {
+        return pixels ? width * height * depth * bytesPerPixel(format, type) : 0;
+    }
+};
+
+template <>
+struct UploadSize<HOOK_glTexSubImage3D>
+{
+    static size_t of(GLenum, GLint, GLint, GLint, GLint, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels)
+    {
+        return pixels ? width * height * depth * bytesPerPixel(format, type) : 0;
+    }
+};
+
+template <>
+struct UploadSize<HOOK_glCompressedTexImage2D>
+{
+    static size_t of(GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei imageSize, const void *data) { return data ? imageSize : 0; }
+};
+
+template <>
+struct UploadSize<HOOK_glCompressedTexSubImage2D>
+{
+    static size_t of(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLsizei imageSize, const void *) { return imageSize; }
+};
+
+// Times a single call and adds it to the function's counters when it goes out of scope
+class ScopedCallTimer
+{
+public:
+    ScopedCallTimer(int id, size_t bytes) : id(id), bytes(bytes), start(chrono::high_resolution_clock::now()) {}
+    ~ScopedCallTimer()
+    {
+        chrono::duration<double, milli> elapsed = chrono::high_resolution_clock::now() - start;
+        GLFunctionStats &stats = functionStats[id];
+        stats.frameCalls++;
+        stats.frameMilliseconds += elapsed.count();
+        stats.frameBytes += bytes;
+    }
+
+private:
+    int id;
+    size_t bytes;
+    chrono::high_resolution_clock::time_point start;
+};
+
+// One wrapper per GL function, generated from the function pointer's own type
+// so every entry point keeps its exact signature (+ calling convention on win32)
+template <int Id, typename Function>
+struct GLHook;
+
+template <int Id, typename Result, typename... Args>
+struct GLHook<Id, Result(APIENTRYP)(Args...)>
+{
+    static Result(APIENTRYP original)(Args...);
+
+    static Result APIENTRY call(Args... args)
+    {
+        if (!countsCalls)
+            return original(args...);
+        ScopedCallTimer timer(Id, UploadSize<Id>::of(args...));
+        return original(args...);
+    }
+};
+
+template <int Id, typename Result, typename... Args>
+Result(APIENTRYP GLHook<Id, Result(APIENTRYP)(Args...)>::original)(Args...) = NULL;
+
+// original is set once + never cleared: another thread (the GLLoader's) can be inside call() or still hold
+// the wrapper's address while the hooks are toggled, it has to reach the driver either way
+static void installHooks()
+{
+    // Entry points that failed to load stay NULL so glad's behaviour is unchanged
+#define GL_PROFILER_HOOK(function, category)                                                   \
+    if (glad_##function != NULL)                                                             \
+    {                                                                                        \
+        if (GLHook<HOOK_##function, decltype(glad_##function)>::original == NULL)            \
+            GLHook<HOOK_##function, decltype(glad_##function)>::original = glad_##function;  \
+        glad_##function = &GLHook<HOOK_##function, decltype(glad_##function)>::call;         \
+    }
+#include "gl_profiler_hooks.inl"
+#undef GL_PROFILER_HOOK
+}
+
+static void removeHooks()
+{
+#define GL_PROFILER_HOOK(function, category)                                    \
+    if (GLHook<HOOK_##function, decltype(glad_##function)>::original != NULL) \
+        glad_##function = GLHook<HOOK_##function, decltype(glad_##function)>::original;
+#include "gl_profiler_hooks.inl"
+#undef GL_PROFILER_HOOK
+}
+
+void GLProfiler::enable()
+{
+    if (profilerEnabled)
+        return;
+    reset();
+    countsCalls = true;
+    installHooks();
+    profilerEnabled = true;
+    std::cout << "GL Profiler enabled" << std::endl;
+}
+
+void GLProfiler::disable()
+{
+    if (!profilerEnabled)
+        return;
+    removeHooks();
+    profilerEnabled = false;
+    printReport();
+    std::cout << "GL Profiler disabled" << std::endl;
+}
+
+void GLProfiler::toggle()
+{
+    if (profilerEnabled)
+        disable();
+    else
+        enable();
+}
+
+bool GLProfiler::isEnabled()
+{
+    return profilerEnabled;
+}
+
+void GLProfiler::enableFromEnvironment()
+{
+    const char *value = getenv("GL_PROFILE");
+    if (value != NULL && string(value) != "0")
+        enable();
+}
+
+void GLProfiler::reset()
+{
+    for (unsigned int i = 0; i < GL_HOOK_COUNT; i++)
+    {
+        GLFunctionStats &stats = functionStats[i];
+        stats.frameCalls = 0;
+        stats.frameMilliseconds = 0;
+        stats.frameBytes = 0;
+        stats.totalCalls = 0;
+        stats.totalMilliseconds = 0;
+        stats.peakFrameCalls = 0;
+    }
+    frameHistoryCount = 0;
+    frameHistoryHead = 0;
+    framesSinceReport = 0;
+    violationCount = 0;
+}
+
+// Only the first frame over budget is printed in full, after that they're summarized in the report
+static bool checkBudget(const GLFrameStats &frame, bool verbose)
+{
+    const GLProfilerBudget &budget = GLProfiler::budget;
+    bool overBudget = false;
+    if (frame.calls[GL_CALL_DRAW] > budget.maxDrawCalls)
+    {
+        if (verbose)
+            std::cout << "WARNING::GL_PROFILER::DRAW_CALLS " << frame.calls[GL_CALL_DRAW] << " > " << budget.maxDrawCalls << std::endl;
+        overBudget = true;
+    }
+    if (frame.calls[GL_CALL_STATE] > budget.maxStateChanges)
+    {
+        if (verbose)
+            std::cout << "WARNING::GL_PROFILER::STATE_CHANGES " << frame.calls[GL_CALL_STATE] << " > " << budget.maxStateChanges << std::endl;
+        overBudget = true;
+    }
+    if (frame.calls[GL_CALL_TEXTURE_BIND] > budget.maxTextureBinds)
+    {
+        if (verbose)
+            std::cout << "WARNING::GL_PROFILER::TEXTURE_BINDS " << frame.calls[GL_CALL_TEXTURE_BIND] << " > " << budget.maxTextureBinds << std::endl;
+        overBudget = true;
+    }
+    if (frame.calls[GL_CALL_UNIFORM] > budget.maxUniformCalls)
+    {
+        if (verbose)
+            std::cout << "WARNING::GL_PROFILER::UNIFORM_CALLS " << frame.calls[GL_CALL_UNIFORM] << " > " << budget.maxUniformCalls << std::endl;
+        overBudget = true;
+    }
+    if (frame.uploadBytes > budget.maxUploadBytes)
+    {
+        if (verbose)
+            std::cout << "WARNING::GL_PROFILER::UPLOAD_BYTES " << frame.uploadBytes << " > " << budget.maxUploadBytes << std::endl;
+        overBudget = true;
+    }
+    return overBudget;
+}
+
+void GLProfiler::endFrame()
+{
+    if (!profilerEnabled)
+        return;
+
+    GLFrameStats frame = {};
+    for (unsigned int i = 0; i < GL_HOOK_COUNT; i++)
+    {
+        GLFunctionStats &stats = functionStats[i];
+        frame.calls[stats.category] += stats.frameCalls;
+        frame.milliseconds[stats.category] += stats.frameMilliseconds;
+        frame.uploadBytes += stats.frameBytes;
+
+        stats.totalCalls += stats.frameCalls;
+        stats.totalMilliseconds += stats.frameMilliseconds;
+        stats.peakFrameCalls = max(stats.peakFrameCalls, stats.frameCalls);
+        stats.frameCalls = 0;
+        stats.frameMilliseconds = 0;
+        stats.frameBytes = 0;
+    }
+
+    frameHistory[frameHistoryHead] = frame;
+    frameHistoryHead = (frameHistoryHead + 1) % FRAME_HISTORY_SIZE;
+    frameHistoryCount = min(frameHistoryCount + 1, FRAME_HISTORY_SIZE);
+
+    // The first frame after enabling is usually partial, don't flag it
+    if (frameHistoryCount > 1 && checkBudget(frame, violationCount == 0))
+        violationCount++;
+
+    framesSinceReport++;
+    if (reportInterval != 0 && framesSinceReport >= reportInterval)
+        printReport();
+}
+
+const GLFrameStats &GLProfiler::lastFrame()
+{
+    if (frameHistoryCount == 0)
+        return emptyFrame;
+    return frameHistory[(frameHistoryHead + FRAME_HISTORY_SIZE - 1) % FRAME_HISTORY_SIZE];
+}
+
+unsigned int GLProfiler::budgetViolations()
+{
+    return violationCount;
+}
+
+const char *GLProfiler::categoryName(GLCallCategory category)
+{
+    switch (category)
+    {
+    case GL_CALL_DRAW:
+        return "Draw Calls";
+    case GL_CALL_STATE:
+        return "State Changes";
+    case GL_CALL_BUFFER_UPLOAD:
+        return "Buffer Uploads";
+    case GL_CALL_TEXTURE_BIND:
+        return "Texture Binds";
+    case GL_CALL_UNIFORM:
+        return "Uniform Calls";
+    default:
+        return "Other";
+    }
+}
+
+// Prints a histogram of per-frame values using power of two buckets (0, 1, 2-3, 4-7, ...)
+static void printHistogram(const string &title, const vector<size_t> &values)
+{
+    const int BUCKET_COUNT = 24;
+    unsigned int buckets[BUCKET_COUNT] = {};
+    size_t minValue = values.empty() ? 0 : values[0];
+    size_t maxValue = 0;
+    double total = 0;
+    for (size_t value : values)
+    {
+        int bucket = 0;
+        while (bucket < BUCKET_COUNT - 1 && (size_t(1) << bucket) <= value)
+            bucket++;
+        buckets[bucket]++;
+        minValue = min(minValue, value);
+        maxValue = max(maxValue, value);
+        total += value;
+    }
+    std::cout << title << " per frame (min " << minValue << ", avg "
+              << (values.empty() ? 0 : total / values.size()) << ", max " << maxValue << ")" << std::endl;
+    for (int i = 0; i < BUCKET_COUNT; i++)
+    {
+        if (buckets[i] == 0)
+            continue;
+        size_t low = i == 0 ? 0 : (size_t(1) << (i - 1));
+        size_t high = i == 0 ? 0 : (size_t(1) << i) - 1;
+        std::cout << "  [" << setw(8) << low << " - " << setw(8) << high << "] "
+                  << string(max(1u, buckets[i] * 40 / (unsigned int)values.size()), '#') << " " << buckets[i] << std::endl;
+    }
+}
+
+void GLProfiler::printReport()
+{
+    framesSinceReport = 0;
+    if (frameHistoryCount == 0)
+        return;
+
+    std::cout << "===== GL Profiler: last " << frameHistoryCount << " frames =====" << std::endl;
+    for (int category = 0; category < GL_CALL_CATEGORY_COUNT; category++)
+    {
+        vector<size_t> values;
+        double milliseconds = 0;
+        for (unsigned int i = 0; i < frameHistoryCount; i++)
+        {
+            values.push_back(frameHistory[i].calls[category]);
+            milliseconds += frameHistory[i].milliseconds[category];
+        }
+        printHistogram(categoryName((GLCallCategory)category), values);
+        std::cout << "  CPU time in driver: " << milliseconds / frameHistoryCount << " ms/frame" << std::endl;
+    }
+    vector<size_t> uploads;
+    for (unsigned int i = 0; i < frameHistoryCount; i++)
+        uploads.push_back(frameHistory[i].uploadBytes);
+    printHistogram("Upload Bytes", uploads);
+
+    // Worst offenders = functions that cost the most CPU time overall
+    vector<GLFunctionStats *> ranked;
+    for (unsigned int i = 0; i < GL_HOOK_COUNT; i++)
+    {
+        if (functionStats[i].totalCalls > 0)
+            ranked.push_back(&functionStats[i]);
+    }
+    sort(ranked.begin(), ranked.end(), [](GLFunctionStats *a, GLFunctionStats *b) {
+        return a->totalMilliseconds > b->totalMilliseconds;
+    });
+    std::cout << "Worst offenders (by total CPU time):" << std::endl;
+    streamsize precision = std::cout.precision();
+    for (size_t i = 0; i < ranked.size() && i < 10; i++)
+    {
+        GLFunctionStats *stats = ranked[i];
+        std::cout << "  " << setw(28) << left << stats->name << right
+                  << setw(10) << stats->totalCalls << " calls"
+                  << setw(10) << fixed << setprecision(3) << stats->totalMilliseconds << " ms"
+                  << "  peak " << stats->peakFrameCalls << "/frame"
+                  << "  [" << categoryName(stats->category) << "]" << std::endl;
+        std::cout.unsetf(ios::fixed);
+    }
+    std::cout.precision(precision);
+    if (violationCount > 0)
+        std::cout << "WARNING::GL_PROFILER::" << violationCount << " frames over budget" << std::endl;
+}
@@ -0,0 +1,74 @@
+#ifndef GL_PROFILER_H
+#define GL_PROFILER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+// Buckets every intercepted GL call is reported under
+enum GLCallCategory
+{
+    GL_CALL_DRAW,
+    GL_CALL_STATE,
+    GL_CALL_BUFFER_UPLOAD,
+    GL_CALL_TEXTURE_BIND,
+    GL_CALL_UNIFORM,
+    GL_CALL_OTHER,
+    GL_CALL_CATEGORY_COUNT
+};
+
+// Totals for a single frame (between two endFrame() calls)
+struct GLFrameStats
+{
+    unsigned int calls[GL_CALL_CATEGORY_COUNT];
+    double milliseconds[GL_CALL_CATEGORY_COUNT];
+    // Bytes handed to the driver from client memory (glBufferData, glTexImage2D, ...)
+    size_t uploadBytes;
+};
+
+// Per-frame limits, any frame going over one of these is flagged as a regression
+struct GLProfilerBudget
+{
+    unsigned int maxDrawCalls = 500;
+    unsigned int maxStateChanges = 1000;
+    unsigned int maxTextureBinds = 500;
+    unsigned int maxUniformCalls = 2000;
+    size_t maxUploadBytes = 4 * 1024 * 1024;
+};
+
+// Instrumented GL loader:
+// glad resolves every GL entry point into a global function pointer (glad_glDrawElements etc.)
+// and the gl* names are just macros for those pointers. Enabling the profiler swaps each pointer
+// for a wrapper that counts + times the call before forwarding to the driver, disabling it puts
+// the original pointers back so there is zero overhead when it is off.
+class GLProfiler
+{
+public:
+    static GLProfilerBudget budget;
+    // Print a report every N frames while enabled (0 = only when printReport is called)
+    static unsigned int reportInterval;
+
+    // Must be called after gladLoadGLLoader, on the render thread: only its GL calls are counted
+    static void enable();
+    static void disable();
+    static void toggle();
+    static bool isEnabled();
+    // Enables the profiler if the GL_PROFILE environment variable is set
+    static void enableFromEnvironment();
+
+    // Closes the current frame: folds per-function counters into the frame history and checks the budget
+    static void endFrame();
+    static const GLFrameStats &lastFrame();
+    // Number of frames that went over budget since the profiler was enabled
+    static unsigned int budgetViolations();
+    static void reset();
+
+    // Per-frame histograms for every category + the worst offending GL functions
+    static void printReport();
+
+    static const char *categoryName(GLCallCategory category);
+};
+
+#endif
@@ -0,0 +1,388 @@
+// List of every glad entry point the GL profiler can intercept, tagged with the bucket it is reported under.
+// Generated from the PFN typedefs in include/glad/glad.h - keep in sync when glad is regenerated with new extensions.
+// GL_PROFILER_HOOK(function, category)
+GL_PROFILER_HOOK(glCullFace, GL_CALL_STATE)
+GL_PROFILER_HOOK(glFrontFace, GL_CALL_STATE)
+GL_PROFILER_HOOK(glHint, GL_CALL_STATE)
+GL_PROFILER_HOOK(glLineWidth, GL_CALL_STATE)
+GL_PROFILER_HOOK(glPointSize, GL_CALL_STATE)
+GL_PROFILER_HOOK(glPolygonMode, GL_CALL_STATE)
+GL_PROFILER_HOOK(glScissor, GL_CALL_STATE)
+GL_PROFILER_HOOK(glTexParameterf, GL_CALL_STATE)
+GL_PROFILER_HOOK(glTexParameterfv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glTexParameteri, GL_CALL_STATE)
+GL_PROFILER_HOOK(glTexParameteriv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glTexImage1D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glTexImage2D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glDrawBuffer, GL_CALL_STATE)
+GL_PROFILER_HOOK(glClear, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glClearColor, GL_CALL_STATE)
+GL_PROFILER_HOOK(glClearStencil, GL_CALL_STATE)
+GL_PROFILER_HOOK(glClearDepth, GL_CALL_STATE)
+GL_PROFILER_HOOK(glStencilMask, GL_CALL_STATE)
+GL_PROFILER_HOOK(glColorMask, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDepthMask, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDisable, GL_CALL_STATE)
+GL_PROFILER_HOOK(glEnable, GL_CALL_STATE)
+GL_PROFILER_HOOK(glFinish, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glFlush, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBlendFunc, GL_CALL_STATE)
+GL_PROFILER_HOOK(glLogicOp, GL_CALL_STATE)
+GL_PROFILER_HOOK(glStencilFunc, GL_CALL_STATE)
+GL_PROFILER_HOOK(glStencilOp, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDepthFunc, GL_CALL_STATE)
+GL_PROFILER_HOOK(glPixelStoref, GL_CALL_STATE)
+GL_PROFILER_HOOK(glPixelStorei, GL_CALL_STATE)
+GL_PROFILER_HOOK(glReadBuffer, GL_CALL_STATE)
+GL_PROFILER_HOOK(glReadPixels, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetBooleanv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetDoublev, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetError, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetFloatv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetIntegerv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetString, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetTexImage, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetTexParameterfv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetTexParameteriv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetTexLevelParameterfv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetTexLevelParameteriv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsEnabled, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDepthRange, GL_CALL_STATE)
+GL_PROFILER_HOOK(glViewport, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDrawArrays, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glDrawElements, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glPolygonOffset, GL_CALL_STATE)
+GL_PROFILER_HOOK(glCopyTexImage1D, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glCopyTexImage2D, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glCopyTexSubImage1D, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glCopyTexSubImage2D, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexSubImage1D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glTexSubImage2D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glBindTexture, GL_CALL_TEXTURE_BIND)
+GL_PROFILER_HOOK(glDeleteTextures, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGenTextures, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsTexture, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDrawRangeElements, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glTexImage3D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glTexSubImage3D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glCopyTexSubImage3D, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glActiveTexture, GL_CALL_TEXTURE_BIND)
+GL_PROFILER_HOOK(glSampleCoverage, GL_CALL_STATE)
+GL_PROFILER_HOOK(glCompressedTexImage3D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glCompressedTexImage2D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glCompressedTexImage1D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glCompressedTexSubImage3D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glCompressedTexSubImage2D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glCompressedTexSubImage1D, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glGetCompressedTexImage, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBlendFuncSeparate, GL_CALL_STATE)
+GL_PROFILER_HOOK(glMultiDrawArrays, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glMultiDrawElements, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glPointParameterf, GL_CALL_STATE)
+GL_PROFILER_HOOK(glPointParameterfv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glPointParameteri, GL_CALL_STATE)
+GL_PROFILER_HOOK(glPointParameteriv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glBlendColor, GL_CALL_STATE)
+GL_PROFILER_HOOK(glBlendEquation, GL_CALL_STATE)
+GL_PROFILER_HOOK(glGenQueries, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDeleteQueries, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsQuery, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBeginQuery, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glEndQuery, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetQueryiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetQueryObjectiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetQueryObjectuiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBindBuffer, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDeleteBuffers, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGenBuffers, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsBuffer, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBufferData, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glBufferSubData, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glGetBufferSubData, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMapBuffer, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glUnmapBuffer, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glGetBufferParameteriv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetBufferPointerv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBlendEquationSeparate, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDrawBuffers, GL_CALL_STATE)
+GL_PROFILER_HOOK(glStencilOpSeparate, GL_CALL_STATE)
+GL_PROFILER_HOOK(glStencilFuncSeparate, GL_CALL_STATE)
+GL_PROFILER_HOOK(glStencilMaskSeparate, GL_CALL_STATE)
+GL_PROFILER_HOOK(glAttachShader, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBindAttribLocation, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glCompileShader, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glCreateProgram, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glCreateShader, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDeleteProgram, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDeleteShader, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDetachShader, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDisableVertexAttribArray, GL_CALL_STATE)
+GL_PROFILER_HOOK(glEnableVertexAttribArray, GL_CALL_STATE)
+GL_PROFILER_HOOK(glGetActiveAttrib, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetActiveUniform, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetAttachedShaders, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetAttribLocation, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetProgramiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetProgramInfoLog, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetShaderiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetShaderInfoLog, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetShaderSource, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetUniformLocation, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glGetUniformfv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetUniformiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetVertexAttribdv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetVertexAttribfv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetVertexAttribiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetVertexAttribPointerv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsProgram, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsShader, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glLinkProgram, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glShaderSource, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glUseProgram, GL_CALL_STATE)
+GL_PROFILER_HOOK(glUniform1f, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform2f, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform3f, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform4f, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform1i, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform2i, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform3i, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform4i, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform1fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform2fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform3fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform4fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform1iv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform2iv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform3iv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform4iv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniformMatrix2fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniformMatrix3fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniformMatrix4fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glValidateProgram, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib1d, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib1dv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib1f, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib1fv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib1s, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib1sv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib2d, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib2dv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib2f, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib2fv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib2s, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib2sv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib3d, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib3dv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib3f, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib3fv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib3s, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib3sv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4Nbv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4Niv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4Nsv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4Nub, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4Nubv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4Nuiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4Nusv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4bv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4d, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4dv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4f, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4fv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4iv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4s, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4sv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4ubv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttrib4usv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribPointer, GL_CALL_STATE)
+GL_PROFILER_HOOK(glUniformMatrix2x3fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniformMatrix3x2fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniformMatrix2x4fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniformMatrix4x2fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniformMatrix3x4fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniformMatrix4x3fv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glColorMaski, GL_CALL_STATE)
+GL_PROFILER_HOOK(glGetBooleani_v, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetIntegeri_v, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glEnablei, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDisablei, GL_CALL_STATE)
+GL_PROFILER_HOOK(glIsEnabledi, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBeginTransformFeedback, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glEndTransformFeedback, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBindBufferRange, GL_CALL_STATE)
+GL_PROFILER_HOOK(glBindBufferBase, GL_CALL_STATE)
+GL_PROFILER_HOOK(glTransformFeedbackVaryings, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetTransformFeedbackVarying, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glClampColor, GL_CALL_STATE)
+GL_PROFILER_HOOK(glBeginConditionalRender, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glEndConditionalRender, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribIPointer, GL_CALL_STATE)
+GL_PROFILER_HOOK(glGetVertexAttribIiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetVertexAttribIuiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI1i, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI2i, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI3i, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI4i, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI1ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI2ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI3ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI4ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI1iv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI2iv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI3iv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI4iv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI1uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI2uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI3uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI4uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI4bv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI4sv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI4ubv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribI4usv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetUniformuiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBindFragDataLocation, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetFragDataLocation, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glUniform1ui, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform2ui, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform3ui, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform4ui, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform1uiv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform2uiv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform3uiv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glUniform4uiv, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glTexParameterIiv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glTexParameterIuiv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glGetTexParameterIiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetTexParameterIuiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glClearBufferiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glClearBufferuiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glClearBufferfv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glClearBufferfi, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetStringi, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsRenderbuffer, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBindRenderbuffer, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDeleteRenderbuffers, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGenRenderbuffers, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glRenderbufferStorage, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetRenderbufferParameteriv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsFramebuffer, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBindFramebuffer, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDeleteFramebuffers, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGenFramebuffers, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glCheckFramebufferStatus, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glFramebufferTexture1D, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glFramebufferTexture2D, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glFramebufferTexture3D, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glFramebufferRenderbuffer, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetFramebufferAttachmentParameteriv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGenerateMipmap, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBlitFramebuffer, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glRenderbufferStorageMultisample, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glFramebufferTextureLayer, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMapBufferRange, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glFlushMappedBufferRange, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glBindVertexArray, GL_CALL_STATE)
+GL_PROFILER_HOOK(glDeleteVertexArrays, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGenVertexArrays, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsVertexArray, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDrawArraysInstanced, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glDrawElementsInstanced, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glTexBuffer, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glPrimitiveRestartIndex, GL_CALL_STATE)
+GL_PROFILER_HOOK(glCopyBufferSubData, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glGetUniformIndices, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetActiveUniformsiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetActiveUniformName, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetUniformBlockIndex, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetActiveUniformBlockiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetActiveUniformBlockName, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glUniformBlockBinding, GL_CALL_UNIFORM)
+GL_PROFILER_HOOK(glDrawElementsBaseVertex, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glDrawRangeElementsBaseVertex, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glDrawElementsInstancedBaseVertex, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glMultiDrawElementsBaseVertex, GL_CALL_DRAW)
+GL_PROFILER_HOOK(glProvokingVertex, GL_CALL_STATE)
+GL_PROFILER_HOOK(glFenceSync, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsSync, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDeleteSync, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glClientWaitSync, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glWaitSync, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetInteger64v, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetSynciv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetInteger64i_v, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetBufferParameteri64v, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glFramebufferTexture, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexImage2DMultisample, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glTexImage3DMultisample, GL_CALL_BUFFER_UPLOAD)
+GL_PROFILER_HOOK(glGetMultisamplefv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glSampleMaski, GL_CALL_STATE)
+GL_PROFILER_HOOK(glBindFragDataLocationIndexed, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetFragDataIndex, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGenSamplers, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glDeleteSamplers, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glIsSampler, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBindSampler, GL_CALL_TEXTURE_BIND)
+GL_PROFILER_HOOK(glSamplerParameteri, GL_CALL_STATE)
+GL_PROFILER_HOOK(glSamplerParameteriv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glSamplerParameterf, GL_CALL_STATE)
+GL_PROFILER_HOOK(glSamplerParameterfv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glSamplerParameterIiv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glSamplerParameterIuiv, GL_CALL_STATE)
+GL_PROFILER_HOOK(glGetSamplerParameteriv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetSamplerParameterIiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetSamplerParameterfv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetSamplerParameterIuiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glQueryCounter, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetQueryObjecti64v, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetQueryObjectui64v, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribDivisor, GL_CALL_STATE)
+GL_PROFILER_HOOK(glVertexAttribP1ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribP1uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribP2ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribP2uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribP3ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribP3uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribP4ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexAttribP4uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexP2ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexP2uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexP3ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexP3uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexP4ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glVertexP4uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexCoordP1ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexCoordP1uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexCoordP2ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexCoordP2uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexCoordP3ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexCoordP3uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexCoordP4ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glTexCoordP4uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMultiTexCoordP1ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMultiTexCoordP1uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMultiTexCoordP2ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMultiTexCoordP2uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMultiTexCoordP3ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMultiTexCoordP3uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMultiTexCoordP4ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glMultiTexCoordP4uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glNormalP3ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glNormalP3uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glColorP3ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glColorP3uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glColorP4ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glColorP4uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glSecondaryColorP3ui, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glSecondaryColorP3uiv, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glGetProgramBinary, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glProgramBinary, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glProgramParameteri, GL_CALL_STATE)
+GL_PROFILER_HOOK(glMaxShaderCompilerThreadsKHR, GL_CALL_STATE)
+GL_PROFILER_HOOK(glInvalidateTexSubImage, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glInvalidateTexImage, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glInvalidateBufferSubData, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glInvalidateBufferData, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glInvalidateFramebuffer, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glInvalidateSubFramebuffer, GL_CALL_OTHER)
+GL_PROFILER_HOOK(glBufferStorage, GL_CALL_BUFFER_UPLOAD)
@@ -0,0 +1,101 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <glad/glad.h>
+
+#include <deque>
+#include <vector>
+
+using namespace std;
+
+// Measures how long the GPU spends on a range of commands using timestamp queries.
+// The GPU runs a few frames behind the CPU so results are only read once they are available,
+// asking for them straight away would stall the CPU until the GPU catches up.
+// (Timestamps are used over GL_TIME_ELAPSED so timers can be nested)
+class GpuTimer
+{
+public:
+    // How many measurements can be in flight before begin() has to wait on the oldest one
+    static const unsigned int MAX_IN_FLIGHT = 6;
+
+    GpuTimer()
+    {
+        glGenQueries(MAX_IN_FLIGHT, startQueries);
+        glGenQueries(MAX_IN_FLIGHT, endQueries);
+    }
+
+    ~GpuTimer()
+    {
+        glDeleteQueries(MAX_IN_FLIGHT, startQueries);
+        glDeleteQueries(MAX_IN_FLIGHT, endQueries);
+    }
+
+    void begin()
+    {
+        // Ring is full, have to wait for the oldest measurement
+        if (inFlight == MAX_IN_FLIGHT)
+            readOldest(true);
+        unsigned int slot = (oldest + inFlight) % MAX_IN_FLIGHT;
+        glQueryCounter(startQueries[slot], GL_TIMESTAMP);
+    }
+
+    void end()
+    {
+        unsigned int slot = (oldest + inFlight) % MAX_IN_FLIGHT;
+        glQueryCounter(endQueries[slot], GL_TIMESTAMP);
+        inFlight++;
+    }
+
+    // Moves every finished measurement (oldest first, in milliseconds) into results
+    // wait = block until every in flight measurement is done
+    void collect(vector<double> &results, bool wait = false)
+    {
+        while (inFlight > 0 && readOldest(wait))
+            ;
+        results.insert(results.end(), finished.begin(), finished.end());
+        finished.clear();
+    }
+
+    // Most recent finished measurement, doesn't consume it
+    double latestMilliseconds()
+    {
+        while (inFlight > 0 && readOldest(false))
+            ;
+        return lastMilliseconds;
+    }
+
+private:
+    unsigned int startQueries[MAX_IN_FLIGHT];
+    unsigned int endQueries[MAX_IN_FLIGHT];
+    unsigned int oldest = 0;
+    unsigned int inFlight = 0;
+    deque<double> finished;
+    double lastMilliseconds = 0;
+
+    bool readOldest(bool wait)
+    {
+        if (!wait)
+        {
+            int available = 0;
+            glGetQueryObjectiv(endQueries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                return false;
+        }
+        GLuint64 startTime, endTime;
+        glGetQueryObjectui64v(startQueries[oldest], GL_QUERY_RESULT, &startTime);
+        glGetQueryObjectui64v(endQueries[oldest], GL_QUERY_RESULT, &endTime);
+        lastMilliseconds = (endTime - startTime) / 1000000.0;
+        finished.push_back(lastMilliseconds);
+        // Nobody is collecting, only keep the recent history
+        if (finished.size() > 256)
+            finished.pop_front();
+        oldest = (oldest + 1) % MAX_IN_FLIGHT;
+        inFlight--;
+        return true;
+    }
+
+    GpuTimer(const GpuTimer &);
+    GpuTimer &operator=(const GpuTimer &);
+};
+
+#endif
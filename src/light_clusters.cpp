@@ -0,0 +1,295 @@
+#include "light_clusters.h"
+#include "thread_pool.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cfloat>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LIGHT_CLUSTERS_SSE 1
+#endif
+
+using namespace std;
+
+static_assert(sizeof(ClusterLight) == 6 * 4 * sizeof(float), "ClusterLight must match the 6 texels the shader reads");
+
+float light_range(float constant, float linear, float quadratic, float intensity)
+{
+    float limit = intensity * 256.0f / 5.0f;
+    if (limit <= constant)
+        return 0.0f;
+    // Solve quadratic * d^2 + linear * d + (constant - limit) = 0 for the positive root
+    if (quadratic > 0.0f)
+        return (-linear + sqrt(linear * linear - 4.0f * quadratic * (constant - limit))) / (2.0f * quadratic);
+    if (linear > 0.0f)
+        return (limit - constant) / linear;
+    // Never fades, reaches every froxel
+    return FLT_MAX;
+}
+
+LightClusters::LightClusters() : assignMilliseconds(0), lightCount(0), visibleLights(0), indexCount(0), overflowCount(0),
+                                 fieldOfView(0), nearPlane(0), farPlane(0), width(0), height(0),
+                                 clusterLights(CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER), clusterCounts(CLUSTER_COUNT),
+                                 sliceOverflow(CLUSTER_Z), grid(CLUSTER_COUNT * 2)
+{
+    glGenBuffers(1, &lightsBuffer);
+    glGenBuffers(1, &gridBuffer);
+    glGenBuffers(1, &indicesBuffer);
+    glGenTextures(1, &lightsTexture);
+    glGenTextures(1, &gridTexture);
+    glGenTextures(1, &indicesTexture);
+}
+
+LightClusters::~LightClusters()
+{
+    glDeleteTextures(1, &lightsTexture);
+    glDeleteTextures(1, &gridTexture);
+    glDeleteTextures(1, &indicesTexture);
+    glDeleteBuffers(1, &lightsBuffer);
+    glDeleteBuffers(1, &gridBuffer);
+    glDeleteBuffers(1, &indicesBuffer);
+}
+
+void LightClusters::buildFroxels(float fieldOfView, float nearPlane, float farPlane, int width, int height)
+{
+    this->fieldOfView = fieldOfView;
+    this->nearPlane = nearPlane;
+    this->farPlane = farPlane;
+    this->width = width;
+    this->height = height;
+
+    // View space extent of the frustum per unit of depth
+    float scaleY = tan(glm::radians(fieldOfView) * 0.5f);
+    float scaleX = scaleY * (float)width / (float)height;
+    for (int z = 0; z < CLUSTER_Z; z++)
+    {
+        float sliceNear = nearPlane * pow(farPlane / nearPlane, (float)z / CLUSTER_Z);
+        float sliceFar = nearPlane * pow(farPlane / nearPlane, (float)(z + 1) / CLUSTER_Z);
+        // The camera looks down -z
+        minZ[z] = -sliceFar;
+        maxZ[z] = -sliceNear;
+        for (int x = 0; x < CLUSTER_X; x++)
+        {
+            float left = (-1.0f + 2.0f * x / CLUSTER_X) * scaleX;
+            float right = (-1.0f + 2.0f * (x + 1) / CLUSTER_X) * scaleX;
+            minX[z * CLUSTER_X + x] = min(left * sliceNear, left * sliceFar);
+            maxX[z * CLUSTER_X + x] = max(right * sliceNear, right * sliceFar);
+        }
+        for (int y = 0; y < CLUSTER_Y; y++)
+        {
+            float bottom = (-1.0f + 2.0f * y / CLUSTER_Y) * scaleY;
+            float top = (-1.0f + 2.0f * (y + 1) / CLUSTER_Y) * scaleY;
+            minY[z * CLUSTER_Y + y] = min(bottom * sliceNear, bottom * sliceFar);
+            maxY[z * CLUSTER_Y + y] = max(top * sliceNear, top * sliceFar);
+        }
+    }
+}
+
+static int slice_of(float depth, float nearPlane, float farPlane)
+{
+    int slice = (int)floor(log(depth / nearPlane) / log(farPlane / nearPlane) * CLUSTER_Z);
+    return max(0, min(CLUSTER_Z - 1, slice));
+}
+
+// Tile of a view space position projected at depth, along an axis with count tiles
+static int tile_of(float position, float depth, float scale, int count)
+{
+    float ndc = position / (depth * scale);
+    int tile = (int)floor((ndc + 1.0f) * 0.5f * count);
+    return max(0, min(count - 1, tile));
+}
+
+void LightClusters::computeBounds(const ClusterLight *lights, size_t begin, size_t end, const glm::mat4 &view)
+{
+    float scaleY = tan(glm::radians(fieldOfView) * 0.5f);
+    float scaleX = scaleY * (float)width / (float)height;
+    for (size_t i = begin; i < end; i++)
+    {
+        LightBounds &light = bounds[i];
+        glm::vec3 center = glm::vec3(view * glm::vec4(lights[i].position, 1.0f));
+        float radius = min(lights[i].range, farPlane * 2.0f);
+        light.sphere = glm::vec4(center, radius);
+
+        float depth = -center.z;
+        if (radius <= 0.0f || depth + radius < nearPlane || depth - radius > farPlane)
+        {
+            // Empty range, skipped by every slice
+            light.z0 = 1;
+            light.z1 = 0;
+            continue;
+        }
+        float closest = max(depth - radius, nearPlane);
+        float furthest = min(depth + radius, farPlane);
+        light.z0 = slice_of(closest, nearPlane, farPlane);
+        light.z1 = slice_of(furthest, nearPlane, farPlane);
+
+        // The sphere's box projects to a screen rect bounded by its corners (x / depth is monotonic in both)
+        float left = center.x - radius, right = center.x + radius;
+        float bottom = center.y - radius, top = center.y + radius;
+        light.x0 = min(tile_of(left, closest, scaleX, CLUSTER_X), tile_of(left, furthest, scaleX, CLUSTER_X));
+        light.x1 = max(tile_of(right, closest, scaleX, CLUSTER_X), tile_of(right, furthest, scaleX, CLUSTER_X));
+        light.y0 = min(tile_of(bottom, closest, scaleY, CLUSTER_Y), tile_of(bottom, furthest, scaleY, CLUSTER_Y));
+        light.y1 = max(tile_of(top, closest, scaleY, CLUSTER_Y), tile_of(top, furthest, scaleY, CLUSTER_Y));
+    }
+}
+
+void LightClusters::assignSlice(int z)
+{
+    unsigned int *counts = &clusterCounts[z * CLUSTER_X * CLUSTER_Y];
+    unsigned short *lists = &clusterLights[(size_t)z * CLUSTER_X * CLUSTER_Y * MAX_LIGHTS_PER_CLUSTER];
+    memset(counts, 0, CLUSTER_X * CLUSTER_Y * sizeof(unsigned int));
+    unsigned int overflow = 0;
+
+    for (size_t i = 0; i < bounds.size(); i++)
+    {
+        const LightBounds &light = bounds[i];
+        if (z < light.z0 || z > light.z1)
+            continue;
+        float radiusSquared = light.sphere.w * light.sphere.w;
+        // Squared distance from the center to the froxels' box along z, then y, then x
+        float dz = max(max(minZ[z] - light.sphere.z, light.sphere.z - maxZ[z]), 0.0f);
+        for (int y = light.y0; y <= light.y1; y++)
+        {
+            float dy = max(max(minY[z * CLUSTER_Y + y] - light.sphere.y, light.sphere.y - maxY[z * CLUSTER_Y + y]), 0.0f);
+            float distanceYZ = dy * dy + dz * dz;
+            if (distanceYZ > radiusSquared)
+                continue;
+            int row = y * CLUSTER_X;
+#ifdef LIGHT_CLUSTERS_SSE
+            // 4 columns per test, CLUSTER_X is a multiple of 4 so a row never runs over
+            __m128 centerX = _mm_set1_ps(light.sphere.x);
+            __m128 limit = _mm_set1_ps(radiusSquared - distanceYZ);
+            for (int x = light.x0 & ~3; x <= light.x1; x += 4)
+            {
+                __m128 low = _mm_loadu_ps(&minX[z * CLUSTER_X + x]);
+                __m128 high = _mm_loadu_ps(&maxX[z * CLUSTER_X + x]);
+                __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(low, centerX), _mm_sub_ps(centerX, high)), _mm_setzero_ps());
+                int hits = _mm_movemask_ps(_mm_cmple_ps(_mm_mul_ps(dx, dx), limit));
+                for (int lane = 0; lane < 4; lane++)
+                {
+                    int column = x + lane;
+                    if (!(hits & (1 << lane)) || column < light.x0 || column > light.x1)
+                        continue;
+                    unsigned int &count = counts[row + column];
+                    if (count < MAX_LIGHTS_PER_CLUSTER)
+                        lists[(row + column) * MAX_LIGHTS_PER_CLUSTER + count++] = (unsigned short)i;
+                    else
+                        overflow++;
+                }
+            }
+#else
+            for (int x = light.x0; x <= light.x1; x++)
+            {
+                float dx = max(max(minX[z * CLUSTER_X + x] - light.sphere.x, light.sphere.x - maxX[z * CLUSTER_X + x]), 0.0f);
+                if (dx * dx + distanceYZ > radiusSquared)
+                    continue;
+                unsigned int &count = counts[row + x];
+                if (count < MAX_LIGHTS_PER_CLUSTER)
+                    lists[(row + x) * MAX_LIGHTS_PER_CLUSTER + count++] = (unsigned short)i;
+                else
+                    overflow++;
+            }
+#endif
+        }
+    }
+    sliceOverflow[z] = overflow;
+}
+
+void LightClusters::update(const ClusterLight *lights, size_t count, const glm::mat4 &view,
+                           float fieldOfView, float nearPlane, float farPlane, int width, int height)
+{
+    chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+    if (fieldOfView != this->fieldOfView || nearPlane != this->nearPlane || farPlane != this->farPlane ||
+        width != this->width || height != this->height)
+        buildFroxels(fieldOfView, nearPlane, farPlane, width, height);
+
+    // Indices are 16 bit
+    if (count > 65536)
+    {
+        std::cout << "ERROR::LIGHT_CLUSTERS::TOO_MANY_LIGHTS only the first 65536 of " << count << " are used" << std::endl;
+        count = 65536;
+    }
+    bounds.resize(count);
+    ThreadPool &pool = ThreadPool::shared();
+    pool.parallelFor(count, 256, [this, lights, &view](size_t begin, size_t end) {
+        computeBounds(lights, begin, end, view);
+    });
+    // Every slice is written by exactly one job, no locking needed
+    pool.parallelFor(CLUSTER_Z, 1, [this](size_t begin, size_t end) {
+        for (size_t z = begin; z < end; z++)
+            assignSlice((int)z);
+    });
+
+    // Compact the fixed size lists into one index list
+    indices.clear();
+    overflowCount = 0;
+    for (int z = 0; z < CLUSTER_Z; z++)
+        overflowCount += sliceOverflow[z];
+    for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+    {
+        grid[cluster * 2] = (unsigned int)indices.size();
+        grid[cluster * 2 + 1] = clusterCounts[cluster];
+        const unsigned short *list = &clusterLights[(size_t)cluster * MAX_LIGHTS_PER_CLUSTER];
+        indices.insert(indices.end(), list, list + clusterCounts[cluster]);
+    }
+
+    lightCount = (unsigned int)count;
+    visibleLights = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (bounds[i].z0 <= bounds[i].z1)
+            visibleLights++;
+    }
+    indexCount = (unsigned int)indices.size();
+
+    upload(lights, count);
+    assignMilliseconds = chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+}
+
+// Orphans + refills a texture buffer (never empty, a zero sized buffer can't back a texture)
+static void upload_texture_buffer(unsigned int buffer, unsigned int texture, GLenum format, const void *data, size_t bytes)
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, max<size_t>(bytes, 16), NULL, GL_STREAM_DRAW);
+    if (bytes > 0)
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::upload(const ClusterLight *lights, size_t count)
+{
+    upload_texture_buffer(lightsBuffer, lightsTexture, GL_RGBA32F, lights, count * sizeof(ClusterLight));
+    upload_texture_buffer(gridBuffer, gridTexture, GL_RG32UI, grid.data(), grid.size() * sizeof(unsigned int));
+    upload_texture_buffer(indicesBuffer, indicesTexture, GL_R16UI, indices.data(), indices.size() * sizeof(unsigned short));
+}
+
+void LightClusters::bind(Shader &shader) const
+{
+    glActiveTexture(GL_TEXTURE0 + CLUSTER_LIGHTS_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, lightsTexture);
+    glActiveTexture(GL_TEXTURE0 + CLUSTER_GRID_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, gridTexture);
+    glActiveTexture(GL_TEXTURE0 + CLUSTER_INDICES_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, indicesTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.setInt("clusterLights", CLUSTER_LIGHTS_UNIT);
+    shader.setInt("clusterGrid", CLUSTER_GRID_UNIT);
+    shader.setInt("clusterIndices", CLUSTER_INDICES_UNIT);
+    shader.setVec2("clusterTileSize", glm::vec2((float)width / CLUSTER_X, (float)height / CLUSTER_Y));
+    shader.setFloat("clusterNear", nearPlane);
+    shader.setFloat("clusterFar", farPlane);
+    // slice = log(depth) * scale - bias, same as slice_of
+    float scale = CLUSTER_Z / log(farPlane / nearPlane);
+    shader.setFloat("clusterDepthScale", scale);
+    shader.setFloat("clusterDepthBias", log(nearPlane) * scale);
+}
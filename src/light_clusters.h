@@ -0,0 +1,111 @@
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include "shader.h"
+
+using namespace std;
+
+// The view frustum is cut into CLUSTER_X * CLUSTER_Y screen tiles times CLUSTER_Z depth slices ("froxels").
+// Depth slices get exponentially thicker with distance so each froxel is roughly as deep as it is wide
+const int CLUSTER_X = 16;
+const int CLUSTER_Y = 9;
+const int CLUSTER_Z = 24;
+const int CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+// Lights past this in a single froxel are dropped (and counted in overflowCount)
+const int MAX_LIGHTS_PER_CLUSTER = 256;
+
+// Texture units the clustered lighting shader reads its buffers from, above the material's maps
+const int CLUSTER_LIGHTS_UNIT = 8;
+const int CLUSTER_GRID_UNIT = 9;
+const int CLUSTER_INDICES_UNIT = 10;
+
+// One light as the shader reads it from the light buffer: 6 RGBA32F texels.
+// Point lights have outerCutOff = -2 (no cone), spot lights store the cosines of their cone angles
+struct ClusterLight
+{
+    glm::vec3 position;
+    // Distance past which the light is too dim to matter, see light_range
+    float range;
+    glm::vec3 ambient;
+    float constant;
+    glm::vec3 diffuse;
+    float linear;
+    glm::vec3 specular;
+    float quadratic;
+    glm::vec3 direction;
+    float cutOff;
+    float outerCutOff;
+    float padding[3];
+};
+
+// Distance at which 1 / (constant + linear * d + quadratic * d^2) * intensity falls below 5/256,
+// i.e. where the light stops making a visible difference on an 8 bit target
+float light_range(float constant, float linear, float quadratic, float intensity);
+
+// Sorts lights into the froxels they touch every frame on the CPU (spread over the thread pool),
+// and hands the result to the shader as three texture buffers:
+// the lights, a (first index, count) pair per froxel and the light indices of every froxel.
+// A fragment then only loops over the lights of its own froxel instead of every light in the scene
+class LightClusters
+{
+public:
+    // Stats of the last update()
+    double assignMilliseconds;
+    unsigned int lightCount;
+    unsigned int visibleLights;
+    unsigned int indexCount;
+    unsigned int overflowCount;
+
+    LightClusters();
+    ~LightClusters();
+
+    // Assigns lights (world space, range filled in) to the froxels of this camera + uploads the lists.
+    // width/height are the size of the target that gets drawn to
+    void update(const ClusterLight *lights, size_t count, const glm::mat4 &view,
+                float fieldOfView, float nearPlane, float farPlane, int width, int height);
+    // Binds the buffers + sets the uniforms the CLUSTERED_LIGHTING variant of fragLighting.glsl needs
+    void bind(Shader &shader) const;
+
+private:
+    unsigned int lightsBuffer, gridBuffer, indicesBuffer;
+    unsigned int lightsTexture, gridTexture, indicesTexture;
+
+    // Froxel bounds in view space, only rebuilt when the projection changes.
+    // A froxel's x extent only depends on its column + slice (y on row + slice, z on slice)
+    // so they're stored apart, which lets the sphere tests run over 4 columns at once
+    float fieldOfView, nearPlane, farPlane;
+    int width, height;
+    float minX[CLUSTER_Z * CLUSTER_X], maxX[CLUSTER_Z * CLUSTER_X];
+    float minY[CLUSTER_Z * CLUSTER_Y], maxY[CLUSTER_Z * CLUSTER_Y];
+    float minZ[CLUSTER_Z], maxZ[CLUSTER_Z];
+
+    // Per light: view space sphere + the froxel range it could touch
+    struct LightBounds
+    {
+        glm::vec4 sphere;
+        int x0, x1, y0, y1, z0, z1;
+    };
+    vector<LightBounds> bounds;
+    // MAX_LIGHTS_PER_CLUSTER slots per froxel, filled in parallel then compacted
+    vector<unsigned short> clusterLights;
+    vector<unsigned int> clusterCounts;
+    vector<unsigned int> sliceOverflow;
+    vector<unsigned int> grid;
+    vector<unsigned short> indices;
+
+    void buildFroxels(float fieldOfView, float nearPlane, float farPlane, int width, int height);
+    void computeBounds(const ClusterLight *lights, size_t begin, size_t end, const glm::mat4 &view);
+    void assignSlice(int slice);
+    void upload(const ClusterLight *lights, size_t count);
+
+    LightClusters(const LightClusters &);
+    LightClusters &operator=(const LightClusters &);
+};
+
+#endif
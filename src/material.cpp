@@ -0,0 +1,205 @@
+#include "material.h"
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+MaterialRegistry::MaterialRegistry() : reuses(0), full(false), buffer(0), uploadedCount(0)
+{
+    Material defaultMaterial;
+    defaultMaterial.parameters = defaultParameters();
+    defaultMaterial.packedSpecular = false;
+    defaultMaterial.textureUsage = TEXTURE_USAGE_ALL;
+    materials.push_back(defaultMaterial);
+    states.push_back(MATERIAL_READY);
+}
+
+MaterialRegistry::~MaterialRegistry()
+{
+}
+
+string MaterialRegistry::key(const MaterialParameters &parameters, const string &directory, const vector<Texture> &textures,
+                             unsigned int options)
+{
+    ostringstream key;
+    // Exact to the last bit, 0.64 and 0.6400001 are different materials
+    key << setprecision(9);
+    const float *values = &parameters.diffuse.x;
+    for (size_t i = 0; i < sizeof(MaterialParameters) / sizeof(float); i++)
+        key << values[i] << ' ';
+    key << options << '|' << directory;
+    for (size_t i = 0; i < textures.size(); i++)
+        key << '|' << textures[i].type << ':' << textures[i].path;
+    return key.str();
+}
+
+MaterialParameters MaterialRegistry::defaultParameters()
+{
+    MaterialParameters parameters;
+    // What the shaders used before there were materials: the maps as they are (or white) + the default shininess
+    parameters.diffuse = glm::vec4(1.0f);
+    parameters.specular = glm::vec4(1.0f, 1.0f, 1.0f, DEFAULT_SHININESS);
+    parameters.ambient = glm::vec4(0.0f);
+    parameters.emissive = glm::vec4(0.0f);
+    return parameters;
+}
+
+unsigned int MaterialRegistry::acquire(const string &key, const MaterialParameters &parameters, bool &reserved)
+{
+    unique_lock<mutex> lock(materialsMutex);
+    reserved = false;
+    unordered_map<string, unsigned int>::const_iterator it;
+    // Another thread is loading its maps, loading them here too would only make textures nobody uses.
+    // Looked up again after waiting, the other thread may have abandoned it
+    while ((it = ids.find(key)) != ids.end() && states[it->second] == MATERIAL_RESERVED)
+        materialFilled.wait(lock);
+    if (it != ids.end())
+    {
+        reuses++;
+        return it->second;
+    }
+    if (materials.size() == MAX_MATERIALS)
+    {
+        // Once, every material after this one would say the same
+        if (!full)
+            std::cout << "ERROR::MATERIAL::TOO_MANY_MATERIALS more than " << MAX_MATERIALS - 1
+                      << ", the rest use the default parameters + keep their own maps" << std::endl;
+        full = true;
+        return DEFAULT_MATERIAL;
+    }
+    unsigned int id = (unsigned int)materials.size();
+    // The parameters are known already, upload() may send them before the maps are there
+    Material placeholder;
+    placeholder.parameters = parameters;
+    placeholder.packedSpecular = false;
+    placeholder.textureUsage = 0;
+    materials.push_back(placeholder);
+    states.push_back(MATERIAL_RESERVED);
+    ids[key] = id;
+    reserved = true;
+    return id;
+}
+
+void MaterialRegistry::fill(unsigned int id, const Material &material)
+{
+    {
+        lock_guard<mutex> lock(materialsMutex);
+        materials[id] = material;
+        states[id] = MATERIAL_READY;
+    }
+    materialFilled.notify_all();
+}
+
+void MaterialRegistry::abandon(unsigned int id)
+{
+    {
+        lock_guard<mutex> lock(materialsMutex);
+        // The placeholder keeps its id (ids are never reused), nothing refers to it anymore
+        if (states[id] == MATERIAL_RESERVED)
+        {
+            for (unordered_map<string, unsigned int>::iterator it = ids.begin(); it != ids.end(); ++it)
+            {
+                if (it->second == id)
+                {
+                    ids.erase(it);
+                    break;
+                }
+            }
+        }
+        states[id] = MATERIAL_READY;
+    }
+    materialFilled.notify_all();
+}
+
+void MaterialRegistry::requireTextures(unsigned int id, unsigned int usage, const function<unsigned int(const Texture &)> &load)
+{
+    Material material;
+    {
+        unique_lock<mutex> lock(materialsMutex);
+        // Another thread loading maps of this material, maybe the ones needed here
+        materialFilled.wait(lock, [this, id] { return states[id] == MATERIAL_READY; });
+        if ((usage & ~materials[id].textureUsage) == 0)
+            return;
+        material = materials[id];
+        states[id] = MATERIAL_LOADING_MAPS;
+    }
+    // Not holding the lock: load makes GL calls + reads files, other materials can be asked for meanwhile
+    MaterialReservation reservation(*this, id, true);
+    material.textureUsage |= usage;
+    load_deferred_textures(material.textures, material.deferredTextures, usage, load);
+    reservation.fill(material);
+}
+
+Material MaterialRegistry::material(unsigned int id)
+{
+    lock_guard<mutex> lock(materialsMutex);
+    return materials[id];
+}
+
+unsigned int MaterialRegistry::materialCount()
+{
+    lock_guard<mutex> lock(materialsMutex);
+    return (unsigned int)materials.size();
+}
+
+void MaterialRegistry::upload()
+{
+    if (buffer == 0)
+    {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        // The whole block, a buffer smaller than the block it backs is undefined
+        glBufferData(GL_UNIFORM_BUFFER, MAX_MATERIALS * sizeof(MaterialParameters), NULL, GL_STATIC_DRAW);
+    }
+    else
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    {
+        lock_guard<mutex> lock(materialsMutex);
+        if (uploadedCount < materials.size())
+        {
+            vector<MaterialParameters> parameters;
+            for (size_t i = uploadedCount; i < materials.size(); i++)
+                parameters.push_back(materials[i].parameters);
+            glBufferSubData(GL_UNIFORM_BUFFER, uploadedCount * sizeof(MaterialParameters), parameters.size() * sizeof(MaterialParameters),
+                            parameters.data());
+            uploadedCount = materials.size();
+        }
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_PARAMS_BINDING, buffer);
+}
+
+MaterialRegistry &MaterialRegistry::shared()
+{
+    static MaterialRegistry registry;
+    return registry;
+}
+
+bool load_deferred_textures(vector<Texture> &textures, vector<Texture> &deferredTextures, unsigned int usage,
+                            const function<unsigned int(const Texture &)> &load)
+{
+    bool loaded = false;
+    for (size_t i = 0; i < deferredTextures.size();)
+    {
+        Texture &texture = deferredTextures[i];
+        if ((Mesh::textureUsageBit(texture.type) & usage) == 0)
+        {
+            i++;
+            continue;
+        }
+        texture.id = load(texture);
+        textures.push_back(texture);
+        deferredTextures.erase(deferredTextures.begin() + i);
+        loaded = true;
+    }
+    // Same order as a full load, the diffuse map stays on unit 0
+    if (loaded)
+        stable_sort(textures.begin(), textures.end(), [](const Texture &a, const Texture &b) {
+            return Mesh::textureUsageBit(a.type) < Mesh::textureUsageBit(b.type);
+        });
+    return loaded;
+}
@@ -0,0 +1,154 @@
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <glad/glad.h>
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mesh.h"
+
+using namespace std;
+
+// Uniform block binding point of MaterialParamsBlock (see shaders/include/materials.glsl)
+const unsigned int MATERIAL_PARAMS_BINDING = 2;
+// Materials the block holds: 64 bytes each, 16KB is the most every GL 3.3 implementation allows a block
+const unsigned int MAX_MATERIALS = 256;
+// Specular exponent of materials that don't have one
+const float DEFAULT_SHININESS = 32.0f;
+
+// What a material file says about a surface, in the std140 layout of MaterialParams
+struct MaterialParameters
+{
+    // rgb = Kd (the color where there's no diffuse map), a = opacity (d)
+    glm::vec4 diffuse;
+    // rgb = Ks (scales the diffuse color where there's no specular map), a = shininess (Ns)
+    glm::vec4 specular;
+    // rgb = Ka
+    glm::vec4 ambient;
+    // rgb = Ke, added on top of the lighting
+    glm::vec4 emissive;
+};
+
+// A material + its maps, the same set a Mesh keeps (see Mesh::textures / deferredTextures)
+struct Material
+{
+    MaterialParameters parameters;
+    vector<Texture> textures;
+    vector<Texture> deferredTextures;
+    bool packedSpecular;
+    // Slots loaded so far
+    unsigned int textureUsage;
+};
+
+// Every material loaded so far, identical ones (same parameters + map files) only once: a model asks for its materials
+// by key before loading any maps, meshes w/ the same material share its textures + get the same compact id.
+// The first thread to ask for a key reserves it + loads the maps, others asking meanwhile wait for them.
+// The renderer sorts draws by that id, consecutive draws of a material skip binding its textures again.
+// The parameters of every material are in one uniform buffer, shaders index it w/ the id (uniform materialId).
+// Thread safe, models load on the loader thread too. GL calls happen in upload() + in the load callbacks
+// requireTextures runs, those w/o holding the lock
+class MaterialRegistry
+{
+public:
+    // Id of meshes w/o a material of their own (+ of materials past MAX_MATERIALS): white, DEFAULT_SHININESS, no maps.
+    // Draws of it always bind their textures, the meshes don't have to share them
+    static const unsigned int DEFAULT_MATERIAL = 0;
+
+    // Materials asked for that already existed
+    unsigned int reuses;
+
+    MaterialRegistry();
+    // The buffer isn't deleted here, the shared registry outlives the context
+    ~MaterialRegistry();
+
+    // Canonical text of a material, two materials w/ the same key are the same. textures = the maps by file (ids unused),
+    // options = anything else that changes what gets loaded (e.g. packing)
+    static string key(const MaterialParameters &parameters, const string &directory, const vector<Texture> &textures,
+                       unsigned int options);
+    static MaterialParameters defaultParameters();
+
+    // Id of the material w/ this key (once its maps are there). When there is none yet, reserves an id for it
+    // (reserved = true): the caller loads the maps + hands them to fill(), or abandon()s it (see MaterialReservation).
+    // DEFAULT_MATERIAL when the registry is full, the caller keeps its own maps then
+    unsigned int acquire(const string &key, const MaterialParameters &parameters, bool &reserved);
+    // Completes a reserved material, threads waiting for it in acquire() go on
+    void fill(unsigned int id, const Material &material);
+    // Gives up on a reserved material that won't be filled: threads waiting for it in acquire() reserve the key again.
+    // For maps being loaded by requireTextures, the next call loads them again
+    void abandon(unsigned int id);
+    // Loads the material's deferred maps of the slots in usage w/ load (see Model::RequireTextures), once:
+    // other threads asking for the same material wait for them
+    void requireTextures(unsigned int id, unsigned int usage, const function<unsigned int(const Texture &)> &load);
+    // Copy of a material, safe while other threads add to the registry
+    Material material(unsigned int id);
+    unsigned int materialCount();
+
+    // Uploads the parameters of materials added since the last call + binds the buffer to MATERIAL_PARAMS_BINDING,
+    // once a frame before drawing
+    void upload();
+
+    static MaterialRegistry &shared();
+
+private:
+    enum MaterialState
+    {
+        MATERIAL_READY,
+        // Reserved, waiting for fill()
+        MATERIAL_RESERVED,
+        // requireTextures is loading more of its maps
+        MATERIAL_LOADING_MAPS
+    };
+
+    mutex materialsMutex;
+    condition_variable materialFilled;
+    vector<Material> materials;
+    vector<MaterialState> states;
+    unordered_map<string, unsigned int> ids;
+    bool full;
+    unsigned int buffer;
+    size_t uploadedCount;
+
+    MaterialRegistry(const MaterialRegistry &);
+    MaterialRegistry &operator=(const MaterialRegistry &);
+};
+
+// A reserved material (see MaterialRegistry::acquire) that gets abandoned unless it's filled before this goes out
+// of scope, e.g. when loading its maps throws: threads waiting for it would wait forever otherwise
+class MaterialReservation
+{
+public:
+    MaterialReservation(MaterialRegistry &registry, unsigned int id, bool reserved) : registry(registry), id(id), pending(reserved) {}
+    ~MaterialReservation()
+    {
+        if (pending)
+            registry.abandon(id);
+    }
+
+    void fill(const Material &material)
+    {
+        registry.fill(id, material);
+        pending = false;
+    }
+
+private:
+    MaterialRegistry &registry;
+    unsigned int id;
+    bool pending;
+
+    MaterialReservation(const MaterialReservation &);
+    MaterialReservation &operator=(const MaterialReservation &);
+};
+
+// Loads the deferred textures of the slots in usage w/ load (moving them to textures), keeps the order of a full load.
+// True if anything was loaded
+bool load_deferred_textures(vector<Texture> &textures, vector<Texture> &deferredTextures, unsigned int usage,
+                            const function<unsigned int(const Texture &)> &load);
+
+#endif
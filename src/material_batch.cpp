@@ -0,0 +1,261 @@
+#include "material_batch.h"
+#include <glad/glad.h>
+
+#include "texture_streaming.h"
+#include "texture_uploader.h"
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+MaterialBatch::MaterialBatch() : layerCount(0), textureBytes(0), isReady(false), isUnsupported(false),
+                                 VAO(0), VBO(0), EBO(0), materialVBO(0), materialUBO(0), indexCount(0)
+{
+}
+
+MaterialBatch::~MaterialBatch()
+{
+    if (!isReady)
+        return;
+    for (size_t i = 0; i < arrays.size(); i++)
+        glDeleteTextures(1, &arrays[i].texture);
+    glDeleteVertexArrays(1, &VAO);
+    unsigned int buffers[] = {VBO, EBO, materialVBO, materialUBO};
+    glDeleteBuffers(4, buffers);
+}
+
+bool MaterialBatch::build(const vector<Mesh> &meshes)
+{
+    if (isReady || isUnsupported)
+        return isReady;
+
+    // The arrays are copied from the textures' mip chains, every one has to be decoded first
+    TextureStreamer &streamer = TextureStreamer::shared();
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        for (size_t j = 0; j < meshes[i].textures.size(); j++)
+        {
+            const Texture &texture = meshes[i].textures[j];
+            if ((texture.type != "texture_diffuse" && texture.type != "texture_specular") || streamer.chain(texture.id) != NULL)
+                continue;
+            // Never going to be there, the meshes draw one by one w/ what they have
+            if (TextureUploader::failed(texture.id))
+            {
+                std::cout << "ERROR::MATERIAL_BATCH::TEXTURE_FAILED " << texture.path << ", drawing mesh by mesh" << std::endl;
+                isUnsupported = true;
+            }
+            return false;
+        }
+    }
+
+    vector<unsigned short> meshMaterials;
+    for (size_t i = 0; i < meshes.size() && !isUnsupported; i++)
+    {
+        const Mesh &mesh = meshes[i];
+        MaterialRecord record = {-1, 0, -1, 0, (int)mesh.materialId, {0, 0, 0}};
+        bool hasDiffuse = false, hasSpecular = false;
+        for (size_t j = 0; j < mesh.textures.size() && !isUnsupported; j++)
+        {
+            const Texture &texture = mesh.textures[j];
+            if (texture.type == "texture_diffuse" && !hasDiffuse)
+            {
+                isUnsupported = !addLayer(texture.id, record.diffuseArray, record.diffuseLayer);
+                hasDiffuse = true;
+            }
+            else if (texture.type == "texture_specular" && !hasSpecular)
+            {
+                isUnsupported = !addLayer(texture.id, record.specularArray, record.specularLayer);
+                hasSpecular = true;
+            }
+        }
+        if (mesh.packedSpecular)
+            record.specularArray = -2;
+
+        size_t material = 0;
+        while (material < materials.size() &&
+               (materials[material].diffuseArray != record.diffuseArray || materials[material].diffuseLayer != record.diffuseLayer ||
+                materials[material].specularArray != record.specularArray || materials[material].specularLayer != record.specularLayer ||
+                materials[material].material != record.material))
+            material++;
+        if (material == materials.size())
+            materials.push_back(record);
+        isUnsupported = isUnsupported || materials.size() > (size_t)MAX_BATCH_MATERIALS;
+        meshMaterials.push_back((unsigned short)material);
+    }
+    if (isUnsupported)
+    {
+        std::cout << "ERROR::MATERIAL_BATCH::UNSUPPORTED more than " << MAX_MATERIAL_ARRAYS << " texture sizes/formats or "
+                  << MAX_BATCH_MATERIALS << " materials, drawing mesh by mesh" << std::endl;
+        arrays.clear();
+        materials.clear();
+        return false;
+    }
+
+    uploadArrays();
+    uploadGeometry(meshes, meshMaterials);
+    isReady = true;
+    return true;
+}
+
+bool MaterialBatch::addLayer(unsigned int texture, int &array, int &layer)
+{
+    const TextureMipChain *chain = TextureStreamer::shared().chain(texture);
+    size_t i = 0;
+    while (i < arrays.size() &&
+           (arrays[i].width != chain->width || arrays[i].height != chain->height || arrays[i].components != chain->components))
+        i++;
+    if (i == arrays.size())
+    {
+        if (arrays.size() == (size_t)MAX_MATERIAL_ARRAYS)
+            return false;
+        TextureArray created;
+        created.texture = 0;
+        created.width = chain->width;
+        created.height = chain->height;
+        created.components = chain->components;
+        arrays.push_back(created);
+    }
+    // Materials sharing a texture share its layer
+    vector<unsigned int> &layers = arrays[i].layers;
+    size_t existing = 0;
+    while (existing < layers.size() && layers[existing] != texture)
+        existing++;
+    if (existing == layers.size())
+        layers.push_back(texture);
+    array = (int)i;
+    layer = (int)existing;
+    return true;
+}
+
+void MaterialBatch::uploadArrays()
+{
+    TextureStreamer &streamer = TextureStreamer::shared();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t i = 0; i < arrays.size(); i++)
+    {
+        TextureArray &array = arrays[i];
+        GLenum format = texture_format(array.components);
+        GLenum internalFormat = texture_internal_format(array.components);
+        int levels = (int)streamer.chain(array.layers[0])->levels.size();
+
+        glGenTextures(1, &array.texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, array.texture);
+        for (int level = 0; level < levels; level++)
+        {
+            int width = max(array.width >> level, 1);
+            int height = max(array.height >> level, 1);
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat, width, height, (GLsizei)array.layers.size(), 0, format, GL_UNSIGNED_BYTE, NULL);
+            for (size_t layer = 0; layer < array.layers.size(); layer++)
+            {
+                const vector<unsigned char> &pixels = streamer.chain(array.layers[layer])->levels[level];
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, (GLint)layer, width, height, 1, format, GL_UNSIGNED_BYTE, pixels.data());
+                textureBytes += pixels.size();
+            }
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+        if (array.components == 1)
+        {
+            // Grey in rgb, like the R8 textures the layers came from
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_G, GL_RED);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_B, GL_RED);
+        }
+        layerCount += (unsigned int)array.layers.size();
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void MaterialBatch::uploadGeometry(const vector<Mesh> &meshes, const vector<unsigned short> &meshMaterials)
+{
+    // Every mesh's vertices one after the other, its indices shifted to match
+    vector<Vertex> vertices;
+    vector<unsigned short> vertexMaterials;
+    vector<unsigned int> indices;
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        unsigned int base = (unsigned int)vertices.size();
+        vertices.insert(vertices.end(), meshes[i].vertices.begin(), meshes[i].vertices.end());
+        vertexMaterials.resize(vertices.size(), meshMaterials[i]);
+        for (size_t j = 0; j < meshes[i].indices.size(); j++)
+            indices.push_back(base + meshes[i].indices[j]);
+    }
+    indexCount = indices.size();
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glGenBuffers(1, &materialVBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    // Same layout as Mesh::createVertexArrays
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, texCoords));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, tangent));
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, bitangent));
+    // + the material index, an integer attribute
+    glBindBuffer(GL_ARRAY_BUFFER, materialVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexMaterials.size() * sizeof(unsigned short), vertexMaterials.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(5);
+    glVertexAttribIPointer(5, 1, GL_UNSIGNED_SHORT, sizeof(unsigned short), (void *)0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // The whole block, a buffer smaller than the block it backs is undefined
+    vector<MaterialRecord> records(MAX_BATCH_MATERIALS);
+    copy(materials.begin(), materials.end(), records.begin());
+    glGenBuffers(1, &materialUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, materialUBO);
+    glBufferData(GL_UNIFORM_BUFFER, records.size() * sizeof(MaterialRecord), records.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+bool MaterialBatch::ready() const
+{
+    return isReady;
+}
+
+bool MaterialBatch::unsupported() const
+{
+    return isUnsupported;
+}
+
+unsigned int MaterialBatch::materialCount() const
+{
+    return (unsigned int)materials.size();
+}
+
+unsigned int MaterialBatch::arrayCount() const
+{
+    return (unsigned int)arrays.size();
+}
+
+void MaterialBatch::Draw(Shader &shader)
+{
+    // Every sampler gets its own unit, even w/o an array there: a sampler2DArray on a unit a sampler2D also uses fails the draw
+    for (int i = 0; i < MAX_MATERIAL_ARRAYS; i++)
+    {
+        shader.setInt("materialArrays[" + to_string(i) + "]", MATERIAL_ARRAY_UNIT + i);
+        glActiveTexture(GL_TEXTURE0 + MATERIAL_ARRAY_UNIT + i);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, (size_t)i < arrays.size() ? arrays[i].texture : 0);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BLOCK_BINDING, materialUBO);
+
+    glBindVertexArray(VAO);
+    glDrawElements(GL_TRIANGLES, (GLsizei)indexCount, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
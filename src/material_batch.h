@@ -0,0 +1,88 @@
+#ifndef MATERIAL_BATCH_H
+#define MATERIAL_BATCH_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "mesh.h"
+#include "shader.h"
+
+using namespace std;
+
+// Uniform block binding point of MaterialBlock + the texture units of the material arrays (see shaders/include/materials.glsl)
+const unsigned int MATERIAL_BLOCK_BINDING = 1;
+const int MATERIAL_ARRAY_UNIT = 12;
+// Texture arrays a batch can sample from (one per size + format), they take units MATERIAL_ARRAY_UNIT..+3
+const int MAX_MATERIAL_ARRAYS = 4;
+// Materials (= distinct texture combinations + registry materials) one batch can hold, the size of the MaterialBlock array
+const int MAX_BATCH_MATERIALS = 256;
+
+// Draws every mesh of a model w/ one program, one set of texture bindings + one draw call:
+// the meshes' textures are copied into GL_TEXTURE_2D_ARRAY layers (one array per size + format), every material
+// becomes a record of (array, layer) pairs in a uniform block and every vertex carries the index of its material.
+// The shader picks the layers per fragment (MATERIAL_BATCH variants of fragLighting / fragGBuffer).
+// The arrays hold every mip level, they aren't streamed like the textures they're copied from
+class MaterialBatch
+{
+public:
+    // Textures copied into arrays, bytes of every array level
+    unsigned int layerCount;
+    size_t textureBytes;
+
+    MaterialBatch();
+    ~MaterialBatch();
+
+    // Builds the batch from the meshes' diffuse + specular maps (the first of each), which have to be loaded.
+    // False while a texture's pixels aren't there yet (try again next frame) or when the meshes don't fit
+    // (too many sizes / formats / materials) or a texture failed to load, see unsupported()
+    bool build(const vector<Mesh> &meshes);
+    bool ready() const;
+    bool unsupported() const;
+    unsigned int materialCount() const;
+    unsigned int arrayCount() const;
+
+    // Binds the arrays + materials, then draws every mesh (the shader must be a MATERIAL_BATCH variant, in use)
+    void Draw(Shader &shader);
+
+private:
+    // (diffuse array, diffuse layer, specular array, specular layer): array -1 = no map, specular array -2 = in the diffuse alpha,
+    // + the mesh's MaterialRegistry id for the parameters. std140 layout of BatchMaterial
+    struct MaterialRecord
+    {
+        int diffuseArray;
+        int diffuseLayer;
+        int specularArray;
+        int specularLayer;
+        int material;
+        int padding[3];
+    };
+
+    struct TextureArray
+    {
+        unsigned int texture;
+        int width;
+        int height;
+        int components;
+        vector<unsigned int> layers;
+    };
+
+    bool isReady;
+    bool isUnsupported;
+    vector<TextureArray> arrays;
+    vector<MaterialRecord> materials;
+    unsigned int VAO, VBO, EBO, materialVBO, materialUBO;
+    size_t indexCount;
+
+    // Puts texture into the array of its size + format, false when there's no room for another array
+    bool addLayer(unsigned int texture, int &array, int &layer);
+    void uploadArrays();
+    void uploadGeometry(const vector<Mesh> &meshes, const vector<unsigned short> &meshMaterials);
+
+    MaterialBatch(const MaterialBatch &);
+    MaterialBatch &operator=(const MaterialBatch &);
+};
+
+#endif
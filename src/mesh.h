@@ -6,6 +6,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cmath>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -37,6 +38,18 @@ struct Texture
     string path;
 };
 
+// Material texture slots as a mask, to load only the ones the shaders drawing a model sample
+enum TextureUsage
+{
+    TEXTURE_USAGE_DIFFUSE = 1,
+    TEXTURE_USAGE_SPECULAR = 2,
+    TEXTURE_USAGE_NORMAL = 4,
+    TEXTURE_USAGE_HEIGHT = 8,
+    TEXTURE_USAGE_ALL = 15,
+    // Not a slot but a load option: pack the specular map into the diffuse map's alpha where they fit (see Model)
+    TEXTURE_USAGE_PACK_SPECULAR = 16
+};
+
 class Mesh
 {
 public:
@@ -44,22 +57,138 @@ public:
     vector<Vertex> vertices;
     vector<unsigned int> indices;
     vector<Texture> textures;
+    // Maps the material has that no shader has sampled yet (id 0, path set), see Model::RequireTextures
+    vector<Texture> deferredTextures;
+    // The specular map is in the diffuse map's alpha instead of a texture of its own
+    bool packedSpecular;
+    // Id in the MaterialRegistry (see material.h), meshes w/ the same one have the same textures. 0 = none of its own
+    unsigned int materialId;
     unsigned int VAO;
+    // Positions only (12 bytes a vertex instead of the whole 56 byte Vertex), for depth only passes
+    unsigned int positionVAO;
+    // Object space bounding box
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    // Texture coordinate units per object space unit (averaged over the triangles), for mip streaming
+    float uvDensity;
 
     /*  Functions  */
     // constructor
-    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures)
+    // createVertexArrays = false when built on a loader thread: buffers + textures are shared between
+    // contexts but vertex arrays aren't, the context drawing the mesh has to call createVertexArrays()
+    Mesh(vector<Vertex> vertices, vector<unsigned int> indices, vector<Texture> textures, bool createVertexArrays = true)
     {
         this->vertices = vertices;
         this->indices = indices;
         this->textures = textures;
+        packedSpecular = false;
+        materialId = 0;
+        VAO = 0;
+        positionVAO = 0;
 
         // now that we have all the required data, set the vertex buffers and its attribute pointers.
-        setupMesh();
+        setupBuffers();
+        if (createVertexArrays)
+            this->createVertexArrays();
+    }
+
+    // Points vertex arrays of the current context at the mesh's buffers (once)
+    void createVertexArrays()
+    {
+        if (VAO != 0)
+            return;
+        glGenVertexArrays(1, &VAO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+
+        // set the vertex attribute pointers
+        // vertex Positions
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)0);
+        // vertex normals
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
+        // vertex texture coords
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, texCoords));
+        // vertex tangent
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, tangent));
+        // vertex bitangent
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, bitangent));
+
+        glGenVertexArrays(1, &positionVAO);
+        glBindVertexArray(positionVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, positionVBO);
+        // Same index buffer as the full vertices
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void *)0);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
     // render the mesh
-    void Draw(Shader shader)
+    // True if the mesh's material has at least one texture of this type ("texture_diffuse", "texture_specular", ...),
+    // loaded or not (so the shader picked for it doesn't depend on what has been loaded), or packed into another
+    bool hasTexture(const string &type) const
+    {
+        if (packedSpecular && type == "texture_specular")
+            return true;
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            if (textures[i].type == type)
+                return true;
+        }
+        for (size_t i = 0; i < deferredTextures.size(); i++)
+        {
+            if (deferredTextures[i].type == type)
+                return true;
+        }
+        return false;
+    }
+
+    // TextureUsage bit of a texture type, 0 for anything else
+    static unsigned int textureUsageBit(const string &type)
+    {
+        if (type == "texture_diffuse")
+            return TEXTURE_USAGE_DIFFUSE;
+        if (type == "texture_specular")
+            return TEXTURE_USAGE_SPECULAR;
+        if (type == "texture_normal")
+            return TEXTURE_USAGE_NORMAL;
+        if (type == "texture_height")
+            return TEXTURE_USAGE_HEIGHT;
+        return 0;
+    }
+
+    // Slots the program samples, from its active sampler uniforms ("material.texture_diffuse1" -> diffuse)
+    static unsigned int textureUsage(Shader &shader)
+    {
+        const char *types[] = {"texture_diffuse", "texture_specular", "texture_normal", "texture_height"};
+        const vector<string> &samplers = shader.activeSamplers();
+        unsigned int usage = 0;
+        for (size_t i = 0; i < samplers.size(); i++)
+        {
+            for (size_t j = 0; j < sizeof(types) / sizeof(types[0]); j++)
+            {
+                if (samplers[i].find(types[j]) != string::npos)
+                    usage |= textureUsageBit(types[j]);
+            }
+        }
+        return usage;
+    }
+
+    void Draw(Shader &shader)
+    {
+        BindTextures(shader);
+        DrawElements();
+    }
+
+    // Binds the textures to units 0.. + points the shader's material samplers at them
+    void BindTextures(Shader &shader)
     {
         // bind appropriate textures
         unsigned int diffuseNr = 1;
@@ -86,30 +215,48 @@ public:
             // and finally bind the texture
             glBindTexture(GL_TEXTURE_2D, textures[i].id);
         }
+        // always good practice to set everything back to defaults once configured.
+        glActiveTexture(GL_TEXTURE0);
+    }
 
-        // draw mesh
+    // Draws w/ whatever textures are bound
+    void DrawElements()
+    {
         glBindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
         glBindVertexArray(0);
+    }
 
-        // always good practice to set everything back to defaults once configured.
-        glActiveTexture(GL_TEXTURE0);
+    // Deletes the buffers + vertex arrays, once (copies of the mesh share them). Textures belong to the material
+    void deleteBuffers()
+    {
+        unsigned int vertexArrays[] = {VAO, positionVAO};
+        glDeleteVertexArrays(2, vertexArrays);
+        unsigned int buffers[] = {VBO, EBO, positionVBO};
+        glDeleteBuffers(3, buffers);
+        VAO = positionVAO = VBO = EBO = positionVBO = 0;
+    }
+
+    // Draws just the positions (the depth shader must already be in use, it needs no textures)
+    void DrawDepth()
+    {
+        glBindVertexArray(positionVAO);
+        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
     }
 
 private:
     /*  Render data  */
     unsigned int VBO, EBO;
+    unsigned int positionVBO;
 
     /*  Functions    */
-    // initializes all the buffer objects/arrays
-    void setupMesh()
+    // creates + fills the buffer objects
+    void setupBuffers()
     {
-        // create buffers/arrays
-        glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
         glGenBuffers(1, &EBO);
 
-        glBindVertexArray(VAO);
         // load data into vertex buffers
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         // A great thing about structs is that their memory layout is sequential for all its items.
@@ -117,27 +264,36 @@ private:
         // again translates to 3/2 floats which translates to a byte array.
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        // The element array binding belongs to the bound vertex array, there is none yet
+        glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+        glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
 
-        // set the vertex attribute pointers
-        // vertex Positions
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)0);
-        // vertex normals
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
-        // vertex texture coords
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, texCoords));
-        // vertex tangent
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, tangent));
-        // vertex bitangent
-        glEnableVertexAttribArray(4);
-        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, bitangent));
+        // Separate tightly packed position stream, so depth only passes don't pull whole vertices through the cache
+        vector<glm::vec3> positions(vertices.size());
+        boundsMin = boundsMax = vertices.empty() ? glm::vec3(0.0f) : vertices[0].position;
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            positions[i] = vertices[i].position;
+            boundsMin = glm::min(boundsMin, positions[i]);
+            boundsMax = glm::max(boundsMax, positions[i]);
+        }
+        glGenBuffers(1, &positionVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, positionVBO);
+        glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), &positions[0], GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-        glBindVertexArray(0);
+        // Ratio of the total UV area to the total surface area, as a length
+        float uvArea = 0.0f;
+        float area = 0.0f;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const Vertex &a = vertices[indices[i]], &b = vertices[indices[i + 1]], &c = vertices[indices[i + 2]];
+            glm::vec2 uvAB = b.texCoords - a.texCoords, uvAC = c.texCoords - a.texCoords;
+            uvArea += fabs(uvAB.x * uvAC.y - uvAB.y * uvAC.x) * 0.5f;
+            area += glm::length(glm::cross(b.position - a.position, c.position - a.position)) * 0.5f;
+        }
+        uvDensity = area > 0.0f ? sqrt(uvArea / area) : 0.0f;
     }
 };
 #endif
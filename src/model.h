@@ -6,6 +6,7 @@
 #include <sstream>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -13,23 +14,111 @@
 
 #include "shader.h"
 #include "mesh.h"
+#include "material_batch.h"
+#include "material.h"
+#include "obj_loader.h"
+#include "texture_uploader.h"
 
 using namespace std;
 
 unsigned int TextureFromFile(const char *path, const string &directory, bool gamma = false);
 unsigned int TextureFromFile(const char *path, const string &directory, bool gamma, int wrapMode);
+unsigned int MaterialTextureFromFile(const char *path, const string &directory, const char *alphaPath);
+unsigned int GenerateMipmappedTexture(int wrapMode);
 glm::vec3 ConvertVector3(aiVector3D aiVec3);
+void ConvertMesh(aiMesh *mesh, vector<Vertex> &vertices, vector<unsigned int> &indices);
+MaterialParameters ConvertMaterial(aiMaterial *material);
 
 class Model
 {
 public:
     /*  Functions   */
-    Model(char *path)
+    // textureUsage = the material slots to load now (TextureUsage bits, see Mesh::textureUsage), the rest wait for
+    // RequireTextures. createVertexArrays = false to load on a thread w/ a shared context, see Mesh
+    Model(const string &path, unsigned int textureUsage = TEXTURE_USAGE_ALL, bool createVertexArrays = true)
+        : materialBatch(NULL), textureUsage(textureUsage), createVertexArrays(createVertexArrays), ownsBuffers(true)
     {
         loadModel(path);
     }
 
-    void Draw(Shader shader)
+    // source's meshes w/ materials of their own: each mesh's material (parameters + maps) goes through vary first.
+    // The buffers + vertex arrays stay source's, it has to outlive this model (+ be drawn in the same context)
+    Model(const Model &source, const function<void(Material &)> &vary)
+        : meshes(source.meshes), directory(source.directory), materialBatch(NULL), textureUsage(source.textureUsage),
+          createVertexArrays(source.createVertexArrays), ownsBuffers(false)
+    {
+        MaterialRegistry &registry = MaterialRegistry::shared();
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            Mesh &mesh = meshes[i];
+            // The mesh's own maps, the default material's are kept per mesh
+            Material material = registry.material(mesh.materialId);
+            material.textures = mesh.textures;
+            material.deferredTextures = mesh.deferredTextures;
+            material.packedSpecular = mesh.packedSpecular;
+            material.textureUsage = textureUsage;
+            vary(material);
+
+            vector<Texture> maps = material.textures;
+            maps.insert(maps.end(), material.deferredTextures.begin(), material.deferredTextures.end());
+            string key = MaterialRegistry::key(material.parameters, directory, maps, material.packedSpecular);
+            bool reserved;
+            unsigned int materialId = registry.acquire(key, material.parameters, reserved);
+            if (reserved)
+                registry.fill(materialId, material);
+            else if (materialId != MaterialRegistry::DEFAULT_MATERIAL)
+                registry.requireTextures(materialId, textureUsage, textureLoader());
+            if (materialId != MaterialRegistry::DEFAULT_MATERIAL)
+                useMaterial(mesh, materialId);
+            else
+            {
+                // Registry full, the maps are the mesh's own + the parameters the default ones
+                mesh.textures = material.textures;
+                mesh.deferredTextures = material.deferredTextures;
+                mesh.packedSpecular = material.packedSpecular;
+                mesh.materialId = MaterialRegistry::DEFAULT_MATERIAL;
+            }
+        }
+    }
+
+    // On a thread w/ a context sharing the model's buffers
+    ~Model()
+    {
+        delete materialBatch;
+        if (!ownsBuffers)
+            return;
+        for (size_t i = 0; i < meshes.size(); i++)
+            meshes[i].deleteBuffers();
+    }
+
+    // Loads the deferred textures of the slots in usage (before drawing w/ a shader that samples them)
+    void RequireTextures(unsigned int usage)
+    {
+        if ((usage & ~textureUsage) == 0)
+            return;
+        textureUsage |= usage;
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            Mesh &mesh = meshes[i];
+            if (mesh.materialId == MaterialRegistry::DEFAULT_MATERIAL)
+                load_deferred_textures(mesh.textures, mesh.deferredTextures, usage, textureLoader());
+            else
+            {
+                // Loaded once for every mesh w/ the material, this model's or another's
+                MaterialRegistry::shared().requireTextures(mesh.materialId, usage, textureLoader());
+                useMaterial(mesh, mesh.materialId);
+            }
+        }
+    }
+
+    // Makes the model drawable in the current context (after loading it w/o vertex arrays)
+    void CreateVertexArrays()
+    {
+        for (unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].createVertexArrays();
+    }
+
+    void Draw(Shader &shader)
     {
         for (unsigned int i = 0; i < meshes.size(); i++)
         {
@@ -37,13 +126,42 @@ public:
         }
     }
 
-private:
+    // Every mesh in one draw (see MaterialBatch), built the first time it's asked for once the diffuse + specular
+    // maps are decoded. NULL until then, or for good when the model doesn't fit in one batch
+    MaterialBatch *GetMaterialBatch()
+    {
+        RequireTextures(TEXTURE_USAGE_DIFFUSE | TEXTURE_USAGE_SPECULAR);
+        if (materialBatch == NULL)
+            materialBatch = new MaterialBatch();
+        if (!materialBatch->ready() && !materialBatch->build(meshes))
+            return NULL;
+        return materialBatch;
+    }
+
     /*  Model Data  */
     vector<Mesh> meshes;
+
+private:
     string directory;
+    MaterialBatch *materialBatch;
+    // Slots loaded so far
+    unsigned int textureUsage;
+    bool createVertexArrays;
+    // False for a copy w/ other materials, the buffers are the source model's
+    bool ownsBuffers;
     /*  Functions   */
     void loadModel(string path)
     {
+        // We assume that all textures are in the same directory as the scene
+        directory = path.substr(0, path.find_last_of('/'));
+        // OBJ (the common case) w/ our own parallel parser, anything else (or an OBJ it can't read) w/ assimp
+        ObjModel obj;
+        if (isObjFile(path) && load_obj(path, obj))
+        {
+            processObjModel(obj);
+            return;
+        }
+
         Assimp::Importer import;
         // Import scene data (Triangulate = Make all faces 3 indices(x,y,z))
         const aiScene *scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
@@ -53,12 +171,19 @@ private:
             cout << "ERROR::ASSIMP::" << import.GetErrorString() << endl;
             return;
         }
-        // We assume that all textures are in the same directory as the scene
-        directory = path.substr(0, path.find_last_of('/'));
 
         processNode(scene->mRootNode, scene);
     }
 
+    static bool isObjFile(const string &path)
+    {
+        if (path.size() < 4)
+            return false;
+        string extension = path.substr(path.size() - 4);
+        transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        return extension == ".obj";
+    }
+
     void processNode(aiNode *node, const aiScene *scene)
     {
         // process all the node's meshes (if any)
@@ -80,47 +205,42 @@ private:
         // data to fill
         vector<Vertex> vertices;
         vector<unsigned int> indices;
-        vector<Texture> textures;
 
-        // Walk through each of the mesh's vertices
-        for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+        ConvertMesh(mesh, vertices, indices);
+        // process materials
+        aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
+        return buildMesh(vertices, indices, ConvertMaterial(material), materialMaps(material));
+    }
+
+    void processObjModel(const ObjModel &model)
+    {
+        for (size_t i = 0; i < model.meshes.size(); i++)
         {
-            Vertex vertex;
-            // positions
-            vertex.position = ConvertVector3(mesh->mVertices[i]);
-            // normals
-            vertex.normal = ConvertVector3(mesh->mNormals[i]);
-            // texture coordinates
-            if (mesh->HasTextureCoords(0))
-            {
-                glm::vec2 vec;
-                // a vertex can contain up to 8 different texture coordinates. We thus make the assumption that we won't
-                // use models where a vertex can have multiple texture coordinates so we always take the first set (0).
-                vec.x = mesh->mTextureCoords[0][i].x;
-                vec.y = mesh->mTextureCoords[0][i].y;
-                vertex.texCoords = vec;
-            }
-            else
-                vertex.texCoords = glm::vec2(0.0f, 0.0f);
-            if (mesh->HasTangentsAndBitangents())
-            {
-                // tangent
-                vertex.tangent = ConvertVector3(mesh->mTangents[i]);
-                // bitangent
-                vertex.bitangent = ConvertVector3(mesh->mBitangents[i]);
-            }
-            vertices.push_back(vertex);
+            const ObjMaterial &material = model.materials[model.meshes[i].material];
+            meshes.push_back(buildMesh(model.meshes[i].vertices, model.meshes[i].indices, material.parameters, material.maps));
         }
-        // now wak through each of the mesh's faces (a face is a mesh its triangle) and retrieve the corresponding vertex indices.
-        for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    }
+
+    // A mesh w/ its material, whichever loader read them. maps = every map of the material by file, in materialMaps order
+    Mesh buildMesh(const vector<Vertex> &vertices, const vector<unsigned int> &indices, const MaterialParameters &parameters,
+                   const vector<Texture> &maps)
+    {
+        vector<Texture> textures;
+        // The same material (same parameters + maps) loaded before, by this model or another, has its maps already
+        MaterialRegistry &registry = MaterialRegistry::shared();
+        const unsigned int packing = TEXTURE_USAGE_DIFFUSE | TEXTURE_USAGE_SPECULAR | TEXTURE_USAGE_PACK_SPECULAR;
+        string key = MaterialRegistry::key(parameters, directory, maps, (textureUsage & packing) == packing);
+        bool reserved;
+        unsigned int materialId = registry.acquire(key, parameters, reserved);
+        if (materialId != MaterialRegistry::DEFAULT_MATERIAL && !reserved)
         {
-            aiFace face = mesh->mFaces[i];
-            // retrieve all indices of the face and store them in the indices vector
-            for (unsigned int j = 0; j < face.mNumIndices; j++)
-                indices.push_back(face.mIndices[j]);
+            registry.requireTextures(materialId, textureUsage, textureLoader());
+            Mesh shared(vertices, indices, vector<Texture>(), createVertexArrays);
+            useMaterial(shared, materialId);
+            return shared;
         }
-        // process materials
-        aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
+        // Abandoned if anything below throws, other threads waiting for the material would wait forever
+        MaterialReservation reservation(registry, materialId, reserved);
         // we assume a convention for sampler names in the shaders. Each diffuse texture should be named
         // as 'texture_diffuseN' where N is a sequential number ranging from 1 to MAX_SAMPLER_NUMBER.
         // Same applies to other texture as the following list summarizes:
@@ -128,38 +248,126 @@ private:
         // specular: texture_specularN
         // normal: texture_normalN
 
-        // 1. diffuse maps
-        vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-        // 2. specular maps
-        vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+        // 1 + 2. diffuse + specular maps, or one diffuse map w/ the specular map in its alpha
+        bool packedSpecular = packSpecular(maps, textures);
+        if (!packedSpecular)
+        {
+            vector<Texture> diffuseMaps = loadMaterialTextures(maps, "texture_diffuse");
+            textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+            vector<Texture> specularMaps = loadMaterialTextures(maps, "texture_specular");
+            textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+        }
         // 3. normal maps
-        std::vector<Texture> normalMaps = loadMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal");
+        std::vector<Texture> normalMaps = loadMaterialTextures(maps, "texture_normal");
         textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
         // 4. height maps
-        std::vector<Texture> heightMaps = loadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
+        std::vector<Texture> heightMaps = loadMaterialTextures(maps, "texture_height");
         textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
 
         // return a mesh object created from the extracted mesh data
-        return Mesh(vertices, indices, textures);
+        Mesh converted(vertices, indices, vector<Texture>(), createVertexArrays);
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            if (textures[i].id != 0)
+                converted.textures.push_back(textures[i]);
+            else
+                converted.deferredTextures.push_back(textures[i]);
+        }
+        converted.packedSpecular = packedSpecular;
+
+        Material loaded;
+        loaded.parameters = parameters;
+        loaded.textures = converted.textures;
+        loaded.deferredTextures = converted.deferredTextures;
+        loaded.packedSpecular = packedSpecular;
+        loaded.textureUsage = textureUsage;
+        // None when the registry is full, the mesh keeps its maps to itself then
+        if (reserved)
+        {
+            reservation.fill(loaded);
+            useMaterial(converted, materialId);
+        }
+        return converted;
     }
-    vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type,
-                                         string typeName)
+    // Every map of the material by file, loaded or not (for its registry key)
+    vector<Texture> materialMaps(aiMaterial *mat)
+    {
+        aiTextureType types[] = {aiTextureType_DIFFUSE, aiTextureType_SPECULAR, aiTextureType_HEIGHT, aiTextureType_AMBIENT};
+        const char *typeNames[] = {"texture_diffuse", "texture_specular", "texture_normal", "texture_height"};
+        vector<Texture> maps;
+        for (size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+        {
+            for (unsigned int j = 0; j < mat->GetTextureCount(types[i]); j++)
+            {
+                aiString str;
+                mat->GetTexture(types[i], j, &str);
+                Texture texture;
+                texture.id = 0;
+                texture.type = typeNames[i];
+                texture.path = str.C_Str();
+                maps.push_back(texture);
+            }
+        }
+        return maps;
+    }
+    // Gives the mesh the registry's copy of its material's maps
+    void useMaterial(Mesh &mesh, unsigned int materialId)
+    {
+        Material material = MaterialRegistry::shared().material(materialId);
+        mesh.textures = material.textures;
+        mesh.deferredTextures = material.deferredTextures;
+        mesh.packedSpecular = material.packedSpecular;
+        mesh.materialId = materialId;
+    }
+    function<unsigned int(const Texture &)> textureLoader()
+    {
+        string directory = this->directory;
+        return [directory](const Texture &texture) { return MaterialTextureFromFile(texture.path.c_str(), directory, ""); };
+    }
+    // W/ TEXTURE_USAGE_PACK_SPECULAR: loads the material's one diffuse map w/ its one specular map in the alpha,
+    // when both are the same size (nothing samples the diffuse map's own alpha). One texture to sample + bind instead of two
+    bool packSpecular(const vector<Texture> &maps, vector<Texture> &textures)
+    {
+        const unsigned int slots = TEXTURE_USAGE_DIFFUSE | TEXTURE_USAGE_SPECULAR | TEXTURE_USAGE_PACK_SPECULAR;
+        vector<Texture> diffuseMaps = mapsOfType(maps, "texture_diffuse");
+        vector<Texture> specularMaps = mapsOfType(maps, "texture_specular");
+        if ((textureUsage & slots) != slots || diffuseMaps.size() != 1 || specularMaps.size() != 1)
+            return false;
+        const string &diffusePath = diffuseMaps[0].path;
+        const string &specularPath = specularMaps[0].path;
+        if (!TextureUploader::canPackIntoAlpha(directory + '/' + diffusePath, directory + '/' + specularPath))
+            return false;
+        Texture texture;
+        texture.id = MaterialTextureFromFile(diffusePath.c_str(), directory, specularPath.c_str());
+        texture.type = "texture_diffuse";
+        texture.path = diffusePath;
+        textures.push_back(texture);
+        return true;
+    }
+    vector<Texture> mapsOfType(const vector<Texture> &maps, const string &typeName)
     {
         vector<Texture> textures;
-        for (unsigned int i = 0; i < mat->GetTextureCount(type); i++)
+        for (size_t i = 0; i < maps.size(); i++)
         {
-            aiString str;
-            mat->GetTexture(type, i, &str);
-            Texture texture;
-            texture.id = TextureFromFile(str.C_Str(), directory);
-            texture.type = typeName;
-            // texture.path = str;
-            textures.push_back(texture);
+            if (maps[i].type == typeName)
+                textures.push_back(maps[i]);
         }
         return textures;
     }
+    // Slots outside textureUsage aren't loaded (id 0), only remembered
+    vector<Texture> loadMaterialTextures(const vector<Texture> &maps, string typeName)
+    {
+        vector<Texture> textures = mapsOfType(maps, typeName);
+        if (Mesh::textureUsageBit(typeName) & textureUsage)
+        {
+            for (size_t i = 0; i < textures.size(); i++)
+                textures[i].id = MaterialTextureFromFile(textures[i].path.c_str(), directory, "");
+        }
+        return textures;
+    }
+
+    Model(const Model &);
+    Model &operator=(const Model &);
 };
 
 glm::vec3 ConvertVector3(aiVector3D aiVec3)
@@ -171,6 +379,73 @@ glm::vec3 ConvertVector3(aiVector3D aiVec3)
     return newVec3;
 }
 
+// Kd, Ks, Ka, Ke, Ns + d of the material, the defaults where it doesn't say
+MaterialParameters ConvertMaterial(aiMaterial *material)
+{
+    MaterialParameters parameters = MaterialRegistry::defaultParameters();
+    aiColor3D color;
+    if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS)
+        parameters.diffuse = glm::vec4(color.r, color.g, color.b, 1.0f);
+    if (material->Get(AI_MATKEY_COLOR_SPECULAR, color) == AI_SUCCESS)
+        parameters.specular = glm::vec4(color.r, color.g, color.b, parameters.specular.a);
+    if (material->Get(AI_MATKEY_COLOR_AMBIENT, color) == AI_SUCCESS)
+        parameters.ambient = glm::vec4(color.r, color.g, color.b, 0.0f);
+    if (material->Get(AI_MATKEY_COLOR_EMISSIVE, color) == AI_SUCCESS)
+        parameters.emissive = glm::vec4(color.r, color.g, color.b, 0.0f);
+    float value;
+    if (material->Get(AI_MATKEY_OPACITY, value) == AI_SUCCESS)
+        parameters.diffuse.a = value;
+    // 0 = not set by most exporters
+    if (material->Get(AI_MATKEY_SHININESS, value) == AI_SUCCESS && value > 0.0f)
+        parameters.specular.a = value;
+    return parameters;
+}
+
+// Copies an assimp mesh into our own Vertex + index layout
+void ConvertMesh(aiMesh *mesh, vector<Vertex> &vertices, vector<unsigned int> &indices)
+{
+    vertices.reserve(vertices.size() + mesh->mNumVertices);
+    indices.reserve(indices.size() + mesh->mNumFaces * 3);
+    // Walk through each of the mesh's vertices
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+    {
+        Vertex vertex;
+        // positions
+        vertex.position = ConvertVector3(mesh->mVertices[i]);
+        // normals
+        vertex.normal = ConvertVector3(mesh->mNormals[i]);
+        // texture coordinates
+        if (mesh->HasTextureCoords(0))
+        {
+            glm::vec2 vec;
+            // a vertex can contain up to 8 different texture coordinates. We thus make the assumption that we won't
+            // use models where a vertex can have multiple texture coordinates so we always take the first set (0).
+            vec.x = mesh->mTextureCoords[0][i].x;
+            vec.y = mesh->mTextureCoords[0][i].y;
+            vertex.texCoords = vec;
+        }
+        else
+            vertex.texCoords = glm::vec2(0.0f, 0.0f);
+        if (mesh->HasTangentsAndBitangents())
+        {
+            // tangent
+            vertex.tangent = ConvertVector3(mesh->mTangents[i]);
+            // bitangent
+            vertex.bitangent = ConvertVector3(mesh->mBitangents[i]);
+        }
+        vertices.push_back(vertex);
+    }
+    // now wak through each of the mesh's faces (a face is a mesh its triangle) and retrieve the corresponding vertex indices.
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    {
+        // (by reference, copying an aiFace allocates a new index array)
+        const aiFace &face = mesh->mFaces[i];
+        // retrieve all indices of the face and store them in the indices vector
+        for (unsigned int j = 0; j < face.mNumIndices; j++)
+            indices.push_back(face.mIndices[j]);
+    }
+}
+
 unsigned int TextureFromFile(const char *path, const string &directory, bool gamma)
 {
     return TextureFromFile(path, directory, gamma, GL_REPEAT);
@@ -181,38 +456,34 @@ unsigned int TextureFromFile(const char *path, const string &directory, bool gam
     string filename = string(path);
     filename = directory + '/' + filename;
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
+    unsigned int textureID = GenerateMipmappedTexture(wrapMode);
+    // Decoded + uploaded in the background (see texture_uploader.h), OpenGL expects the bottom row first
+    TextureUploader::shared().load(textureID, GL_TEXTURE_2D, filename, true, true);
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    return textureID;
+}
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+// For material maps: the lit shaders never sample their alpha, so grey maps w/ alpha still end up as GL_R8.
+// alphaPath (in directory, may be empty) = a scalar map to put in that alpha instead, see TextureUploader::canPackIntoAlpha
+unsigned int MaterialTextureFromFile(const char *path, const string &directory, const char *alphaPath)
+{
+    unsigned int textureID = GenerateMipmappedTexture(GL_REPEAT);
+    string alphaFilename = alphaPath[0] != '\0' ? directory + '/' + alphaPath : "";
+    TextureUploader::shared().load(textureID, GL_TEXTURE_2D, directory + '/' + path, true, true, alphaFilename, true);
+    return textureID;
+}
 
-        stbi_image_free(data);
-    }
-    else
-    {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-    }
+unsigned int GenerateMipmappedTexture(int wrapMode)
+{
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
 
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
     return textureID;
 }
 
@@ -0,0 +1,762 @@
+#include "obj_loader.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+
+using namespace std;
+
+// Chunks get at least this much of the file, smaller ones cost more to hand out than to parse
+static const size_t MIN_CHUNK_BYTES = 256 * 1024;
+// Face corners (or hash map slots) per job when deduplicating
+static const size_t MIN_CORNERS_PER_JOB = 16 * 1024;
+static const unsigned int EMPTY_SLOT = 0xFFFFFFFFu;
+
+// Read only view of a whole file, mapped instead of read so the chunks are parsed where the page cache has them
+class MappedFile
+{
+public:
+    const char *data;
+    size_t size;
+
+    MappedFile() : data(NULL), size(0)
+    {
+#ifdef _WIN32
+        file = INVALID_HANDLE_VALUE;
+        mapping = NULL;
+#endif
+    }
+
+    ~MappedFile()
+    {
+        unmap();
+    }
+
+    bool map(const string &path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        LARGE_INTEGER fileSize;
+        if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize))
+            return false;
+        size = (size_t)fileSize.QuadPart;
+        if (size == 0)
+        {
+            data = "";
+            return true;
+        }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL)
+            return false;
+        data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        return data != NULL;
+#else
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+            return false;
+        struct stat info;
+        if (fstat(descriptor, &info) != 0)
+        {
+            close(descriptor);
+            return false;
+        }
+        size = (size_t)info.st_size;
+        if (size == 0)
+        {
+            close(descriptor);
+            data = "";
+            return true;
+        }
+        void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        // The mapping keeps the file open
+        close(descriptor);
+        if (mapped == MAP_FAILED)
+        {
+            size = 0;
+            return false;
+        }
+        // Every chunk is read at once, start reading ahead everywhere
+        madvise(mapped, size, MADV_WILLNEED);
+        data = (const char *)mapped;
+        return true;
+#endif
+    }
+
+    void unmap()
+    {
+#ifdef _WIN32
+        if (data != NULL && size > 0)
+            UnmapViewOfFile(data);
+        if (mapping != NULL)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+        mapping = NULL;
+#else
+        if (data != NULL && size > 0)
+            munmap((void *)data, size);
+#endif
+        data = NULL;
+        size = 0;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+};
+
+// Indices into the shared attribute arrays, -1 = the face doesn't have that attribute
+struct ObjCorner
+{
+    int position;
+    int texCoord;
+    int normal;
+
+    bool operator==(const ObjCorner &other) const
+    {
+        return position == other.position && texCoord == other.texCoord && normal == other.normal;
+    }
+};
+
+// "o" / "g" / "usemtl" line, before the corner at this index of its chunk
+struct ObjEvent
+{
+    size_t corner;
+    bool material;
+    string name;
+};
+
+struct ObjChunk
+{
+    const char *begin;
+    const char *end;
+    // v / vt / vn lines, + where the chunk's first of each goes in the shared arrays
+    size_t positionCount, texCoordCount, normalCount;
+    size_t positionOffset, texCoordOffset, normalOffset;
+    // 3 a triangle
+    vector<ObjCorner> corners;
+    vector<ObjEvent> events;
+    vector<string> libraries;
+    // Where parsing stopped, NULL if it didn't
+    const char *error;
+};
+
+struct ObjAttributes
+{
+    vector<glm::vec3> positions;
+    vector<glm::vec2> texCoords;
+    vector<glm::vec3> normals;
+};
+
+// Corners of one mesh, a range of a chunk's corners at a time
+struct ObjSegment
+{
+    size_t chunk;
+    size_t begin;
+    size_t end;
+};
+
+struct ObjRun
+{
+    string name;
+    string material;
+    vector<ObjSegment> segments;
+};
+
+static inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline const char *skip_spaces(const char *p, const char *end)
+{
+    while (p < end && is_space(*p))
+        p++;
+    return p;
+}
+
+// True if the line (leading spaces skipped) starts w/ word followed by a space, rest = after it
+static bool keyword(const char *p, const char *end, const char *word, const char *&rest)
+{
+    size_t length = strlen(word);
+    if ((size_t)(end - p) < length || memcmp(p, word, length) != 0)
+        return false;
+    if (p + length < end && !is_space(p[length]))
+        return false;
+    rest = p + length;
+    return true;
+}
+
+// Rest of the line w/o the spaces around it
+static string trimmed(const char *p, const char *end)
+{
+    p = skip_spaces(p, end);
+    while (end > p && is_space(end[-1]))
+        end--;
+    return string(p, end);
+}
+
+// Powers of ten a double holds exactly
+static const double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                       1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Anything parse_float doesn't handle itself (nan, inf, hex), through strtod on a copy of the token
+static const char *parse_float_slow(const char *p, const char *end, float &value)
+{
+    char token[64];
+    size_t length = 0;
+    while (p + length < end && !is_space(p[length]) && p[length] != '\n' && length + 1 < sizeof(token))
+    {
+        token[length] = p[length];
+        length++;
+    }
+    token[length] = '\0';
+    char *parsed;
+    value = strtof(token, &parsed);
+    return parsed == token ? NULL : p + (parsed - token);
+}
+
+// Reads a decimal number in place, like std::from_chars: no locale, no copy, no allocation.
+// 19 significant digits go into an integer mantissa, scaled once by an exact power of ten where it can be.
+// NULL when there's no number
+static const char *parse_float(const char *p, const char *end, float &value)
+{
+    p = skip_spaces(p, end);
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+    unsigned long long mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    int digits = 0;
+    for (; p < end && is_digit(*p); p++, digits++)
+    {
+        if (significantDigits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            significantDigits += mantissa != 0;
+        }
+        else
+            exponent++;
+    }
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && is_digit(*p); p++, digits++)
+        {
+            if (significantDigits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                significantDigits += mantissa != 0;
+                exponent--;
+            }
+        }
+    }
+    if (digits == 0)
+        return parse_float_slow(start, end, value);
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *e = p + 1;
+        bool negativeExponent = false;
+        if (e < end && (*e == '-' || *e == '+'))
+            negativeExponent = *e++ == '-';
+        if (e < end && is_digit(*e))
+        {
+            int value = 0;
+            for (; e < end && is_digit(*e); e++)
+                value = min(value * 10 + (*e - '0'), 100000);
+            exponent += negativeExponent ? -value : value;
+            p = e;
+        }
+    }
+    double result = (double)mantissa;
+    if (exponent > 0 && exponent <= 22)
+        result *= POWERS_OF_TEN[exponent];
+    else if (exponent < 0 && exponent >= -22)
+        result /= POWERS_OF_TEN[-exponent];
+    else if (exponent != 0 && mantissa != 0)
+        result *= pow(10.0, exponent);
+    value = (float)(negative ? -result : result);
+    return p;
+}
+
+static const char *parse_int(const char *p, const char *end, long long &value)
+{
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+    if (p >= end || !is_digit(*p))
+        return NULL;
+    value = 0;
+    for (; p < end && is_digit(*p); p++)
+        value = min(value * 10 + (*p - '0'), 1LL << 40);
+    if (negative)
+        value = -value;
+    return p;
+}
+
+// 1 based (or negative = counting back from the last one so far) OBJ index -> 0 based, -1 if it's out of range
+static inline int resolve_index(long long index, size_t countSoFar, size_t total)
+{
+    long long resolved = index > 0 ? index - 1 : (long long)countSoFar + index;
+    return index != 0 && resolved >= 0 && resolved < (long long)total ? (int)resolved : -1;
+}
+
+static void count_attributes(ObjChunk &chunk)
+{
+    chunk.positionCount = chunk.texCoordCount = chunk.normalCount = 0;
+    for (const char *line = chunk.begin; line < chunk.end;)
+    {
+        const char *lineEnd = (const char *)memchr(line, '\n', chunk.end - line);
+        if (lineEnd == NULL)
+            lineEnd = chunk.end;
+        // The same test as parse_chunk, every line it writes an attribute for has a slot (bare "v" lines too)
+        const char *p = skip_spaces(line, lineEnd);
+        const char *rest;
+        if (keyword(p, lineEnd, "v", rest))
+            chunk.positionCount++;
+        else if (keyword(p, lineEnd, "vt", rest))
+            chunk.texCoordCount++;
+        else if (keyword(p, lineEnd, "vn", rest))
+            chunk.normalCount++;
+        line = lineEnd + 1;
+    }
+}
+
+static void parse_chunk(ObjChunk &chunk, ObjAttributes &attributes)
+{
+    size_t positions = 0, texCoords = 0, normals = 0;
+    vector<ObjCorner> polygon;
+    chunk.error = NULL;
+    for (const char *line = chunk.begin; line < chunk.end && chunk.error == NULL;)
+    {
+        const char *lineEnd = (const char *)memchr(line, '\n', chunk.end - line);
+        if (lineEnd == NULL)
+            lineEnd = chunk.end;
+        const char *p = skip_spaces(line, lineEnd);
+        const char *rest;
+        if (keyword(p, lineEnd, "v", rest))
+        {
+            glm::vec3 &position = attributes.positions[chunk.positionOffset + positions++];
+            // A 4th coordinate (w) or a vertex color after it is ignored, like assimp does
+            if ((rest = parse_float(rest, lineEnd, position.x)) == NULL || (rest = parse_float(rest, lineEnd, position.y)) == NULL ||
+                parse_float(rest, lineEnd, position.z) == NULL)
+                chunk.error = line;
+        }
+        else if (keyword(p, lineEnd, "vt", rest))
+        {
+            glm::vec2 &texCoord = attributes.texCoords[chunk.texCoordOffset + texCoords++];
+            texCoord.y = 0.0f;
+            if ((rest = parse_float(rest, lineEnd, texCoord.x)) == NULL)
+                chunk.error = line;
+            else
+                parse_float(rest, lineEnd, texCoord.y);
+            // aiProcess_FlipUVs
+            texCoord.y = 1.0f - texCoord.y;
+        }
+        else if (keyword(p, lineEnd, "vn", rest))
+        {
+            glm::vec3 &normal = attributes.normals[chunk.normalOffset + normals++];
+            if ((rest = parse_float(rest, lineEnd, normal.x)) == NULL || (rest = parse_float(rest, lineEnd, normal.y)) == NULL ||
+                parse_float(rest, lineEnd, normal.z) == NULL)
+                chunk.error = line;
+        }
+        else if (keyword(p, lineEnd, "f", rest))
+        {
+            polygon.clear();
+            for (p = skip_spaces(rest, lineEnd); p < lineEnd && *p != '#'; p = skip_spaces(p, lineEnd))
+            {
+                // v, v/vt, v//vn or v/vt/vn
+                ObjCorner corner = {-1, -1, -1};
+                long long index;
+                bool valid = (p = parse_int(p, lineEnd, index)) != NULL &&
+                             (corner.position = resolve_index(index, chunk.positionOffset + positions, attributes.positions.size())) >= 0;
+                if (valid && p < lineEnd && *p == '/')
+                {
+                    if (++p < lineEnd && *p != '/')
+                        valid = (p = parse_int(p, lineEnd, index)) != NULL &&
+                                (corner.texCoord = resolve_index(index, chunk.texCoordOffset + texCoords, attributes.texCoords.size())) >= 0;
+                    if (valid && p < lineEnd && *p == '/')
+                        valid = (p = parse_int(p + 1, lineEnd, index)) != NULL &&
+                                (corner.normal = resolve_index(index, chunk.normalOffset + normals, attributes.normals.size())) >= 0;
+                }
+                if (!valid || (p < lineEnd && !is_space(*p)))
+                {
+                    chunk.error = line;
+                    break;
+                }
+                polygon.push_back(corner);
+            }
+            // A fan, like aiProcess_Triangulate for the convex polygons OBJ exporters write. Points + lines are skipped
+            for (size_t i = 2; i < polygon.size() && chunk.error == NULL; i++)
+            {
+                chunk.corners.push_back(polygon[0]);
+                chunk.corners.push_back(polygon[i - 1]);
+                chunk.corners.push_back(polygon[i]);
+            }
+        }
+        else if (keyword(p, lineEnd, "usemtl", rest))
+            chunk.events.push_back({chunk.corners.size(), true, trimmed(rest, lineEnd)});
+        else if (keyword(p, lineEnd, "o", rest) || keyword(p, lineEnd, "g", rest))
+            chunk.events.push_back({chunk.corners.size(), false, trimmed(rest, lineEnd)});
+        else if (keyword(p, lineEnd, "mtllib", rest))
+            chunk.libraries.push_back(trimmed(rest, lineEnd));
+        line = lineEnd + 1;
+    }
+}
+
+// What assimp's OBJ importer gives a material before reading its lines (+ materials that don't exist)
+static ObjMaterial default_material(const string &name)
+{
+    ObjMaterial material;
+    material.name = name;
+    material.parameters.diffuse = glm::vec4(0.6f, 0.6f, 0.6f, 1.0f);
+    material.parameters.specular = glm::vec4(0.0f, 0.0f, 0.0f, DEFAULT_SHININESS);
+    material.parameters.ambient = glm::vec4(0.0f);
+    material.parameters.emissive = glm::vec4(0.0f);
+    return material;
+}
+
+// Kd 0.5 0.5 0.5 (or just Kd 0.5)
+static void parse_color(const char *p, const char *end, glm::vec4 &color)
+{
+    float r, g, b;
+    if ((p = parse_float(p, end, r)) == NULL)
+        return;
+    g = b = r;
+    if ((p = parse_float(p, end, g)) != NULL)
+        parse_float(p, end, b);
+    color = glm::vec4(r, g, b, color.a);
+}
+
+// The MTL files are a few KB, read in one go
+static void parse_mtl(const string &path, vector<ObjMaterial> &materials)
+{
+    ifstream file(path, ios::binary);
+    if (!file)
+    {
+        std::cout << "ERROR::OBJ::MTL_NOT_FOUND " << path << std::endl;
+        return;
+    }
+    string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    const char *end = text.data() + text.size();
+    const char *mapTypes[][2] = {{"map_Kd", "texture_diffuse"}, {"map_Ks", "texture_specular"}, {"map_Bump", "texture_normal"},
+                                 {"map_bump", "texture_normal"}, {"bump", "texture_normal"}, {"map_Ka", "texture_height"}};
+    for (const char *line = text.data(); line < end;)
+    {
+        const char *lineEnd = (const char *)memchr(line, '\n', end - line);
+        if (lineEnd == NULL)
+            lineEnd = end;
+        const char *p = skip_spaces(line, lineEnd);
+        line = lineEnd + 1;
+        const char *rest;
+        if (keyword(p, lineEnd, "newmtl", rest))
+        {
+            materials.push_back(default_material(trimmed(rest, lineEnd)));
+            continue;
+        }
+        if (materials.empty())
+            continue;
+        ObjMaterial &material = materials.back();
+        float value;
+        if (keyword(p, lineEnd, "Kd", rest))
+            parse_color(rest, lineEnd, material.parameters.diffuse);
+        else if (keyword(p, lineEnd, "Ks", rest))
+            parse_color(rest, lineEnd, material.parameters.specular);
+        else if (keyword(p, lineEnd, "Ka", rest))
+            parse_color(rest, lineEnd, material.parameters.ambient);
+        else if (keyword(p, lineEnd, "Ke", rest))
+            parse_color(rest, lineEnd, material.parameters.emissive);
+        // 0 = not set, see ConvertMaterial
+        else if (keyword(p, lineEnd, "Ns", rest) && parse_float(rest, lineEnd, value) != NULL && value > 0.0f)
+            material.parameters.specular.a = value;
+        else if (keyword(p, lineEnd, "d", rest) && parse_float(rest, lineEnd, value) != NULL)
+            material.parameters.diffuse.a = value;
+        else if (keyword(p, lineEnd, "Tr", rest) && parse_float(rest, lineEnd, value) != NULL)
+            material.parameters.diffuse.a = 1.0f - value;
+        else
+        {
+            for (size_t i = 0; i < sizeof(mapTypes) / sizeof(mapTypes[0]); i++)
+            {
+                if (!keyword(p, lineEnd, mapTypes[i][0], rest))
+                    continue;
+                // The file is the last word, options (-bm 1, -s 1 1 1 ...) come before it
+                string words = trimmed(rest, lineEnd);
+                Texture texture;
+                texture.id = 0;
+                texture.type = mapTypes[i][1];
+                texture.path = words.substr(words.find_last_of(" \t") == string::npos ? 0 : words.find_last_of(" \t") + 1);
+                if (!texture.path.empty())
+                    material.maps.push_back(texture);
+                break;
+            }
+        }
+    }
+    // In the order Model lists an aiMaterial's maps, so both loaders key a material the same way
+    for (size_t i = 0; i < materials.size(); i++)
+        stable_sort(materials[i].maps.begin(), materials[i].maps.end(), [](const Texture &a, const Texture &b) {
+            return Mesh::textureUsageBit(a.type) < Mesh::textureUsageBit(b.type);
+        });
+}
+
+static inline size_t hash_corner(const ObjCorner &corner)
+{
+    unsigned long long hash = (unsigned int)corner.position;
+    hash = hash * 0x9E3779B97F4A7C15ULL ^ (unsigned int)corner.texCoord;
+    hash = hash * 0x9E3779B97F4A7C15ULL ^ (unsigned int)corner.normal;
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 32;
+    return (size_t)hash;
+}
+
+// Open addressing over corner indices: every slot ends up w/ the first (smallest) corner of its triple,
+// whichever thread got there first
+static void insert_corner(atomic<unsigned int> *table, size_t mask, const vector<ObjCorner> &corners, unsigned int corner)
+{
+    for (size_t slot = hash_corner(corners[corner]) & mask;; slot = (slot + 1) & mask)
+    {
+        unsigned int current = table[slot].load();
+        while (current == EMPTY_SLOT && !table[slot].compare_exchange_weak(current, corner))
+        {
+        }
+        if (current == EMPTY_SLOT)
+            return;
+        if (corners[current] == corners[corner])
+        {
+            while (corner < current && !table[slot].compare_exchange_weak(current, corner))
+            {
+            }
+            return;
+        }
+    }
+}
+
+static unsigned int find_corner(const atomic<unsigned int> *table, size_t mask, const vector<ObjCorner> &corners, unsigned int corner)
+{
+    for (size_t slot = hash_corner(corners[corner]) & mask;; slot = (slot + 1) & mask)
+    {
+        unsigned int current = table[slot].load();
+        if (corners[current] == corners[corner])
+            return current;
+    }
+}
+
+// Deduplicates the run's corners into vertices, numbered in order of first use (the same on every run)
+static void build_mesh(const vector<ObjChunk> &chunks, const ObjRun &run, const ObjAttributes &attributes, ThreadPool &pool, ObjMesh &mesh)
+{
+    vector<ObjCorner> corners;
+    for (size_t i = 0; i < run.segments.size(); i++)
+    {
+        const ObjSegment &segment = run.segments[i];
+        const vector<ObjCorner> &chunkCorners = chunks[segment.chunk].corners;
+        corners.insert(corners.end(), chunkCorners.begin() + segment.begin, chunkCorners.begin() + segment.end);
+    }
+    size_t count = corners.size();
+    size_t tableSize = 1;
+    while (tableSize < count * 2)
+        tableSize <<= 1;
+    size_t mask = tableSize - 1;
+    unique_ptr<atomic<unsigned int>[]> table(new atomic<unsigned int>[tableSize]);
+    pool.parallelFor(tableSize, MIN_CORNERS_PER_JOB, [&table](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            table[i].store(EMPTY_SLOT, memory_order_relaxed);
+    });
+    pool.parallelFor(count, MIN_CORNERS_PER_JOB, [&table, mask, &corners](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            insert_corner(table.get(), mask, corners, (unsigned int)i);
+    });
+    vector<unsigned int> first(count);
+    pool.parallelFor(count, MIN_CORNERS_PER_JOB, [&table, mask, &corners, &first](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            first[i] = find_corner(table.get(), mask, corners, (unsigned int)i);
+    });
+
+    vector<unsigned int> ids(count);
+    unsigned int vertexCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (first[i] == i)
+            ids[i] = vertexCount++;
+    }
+    mesh.vertices.resize(vertexCount);
+    mesh.indices.resize(count);
+    pool.parallelFor(count, MIN_CORNERS_PER_JOB, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            unsigned int id = ids[first[i]];
+            mesh.indices[i] = id;
+            if (first[i] != i)
+                continue;
+            const ObjCorner &corner = corners[i];
+            Vertex &vertex = mesh.vertices[id];
+            vertex.position = attributes.positions[corner.position];
+            vertex.texCoords = corner.texCoord >= 0 ? attributes.texCoords[corner.texCoord] : glm::vec2(0.0f);
+            vertex.normal = corner.normal >= 0 ? attributes.normals[corner.normal] : glm::vec3(0.0f);
+            vertex.tangent = glm::vec3(0.0f);
+            vertex.bitangent = glm::vec3(0.0f);
+        }
+    });
+}
+
+bool load_obj(const string &path, ObjModel &model, ThreadPool &pool)
+{
+    MappedFile file;
+    if (!file.map(path))
+    {
+        std::cout << "ERROR::OBJ::FAILED_TO_OPEN " << path << std::endl;
+        return false;
+    }
+
+    // 1. Chunks end after a newline, so no line is split between two
+    size_t chunkCount = max<size_t>(1, min<size_t>(pool.threadCount(), file.size / MIN_CHUNK_BYTES));
+    vector<ObjChunk> chunks(chunkCount);
+    const char *end = file.data + file.size;
+    const char *begin = file.data;
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        const char *split = end;
+        if (i + 1 < chunkCount)
+        {
+            split = max(begin, file.data + file.size / chunkCount * (i + 1));
+            const char *newline = (const char *)memchr(split, '\n', end - split);
+            split = newline != NULL ? newline + 1 : end;
+        }
+        chunks[i].begin = begin;
+        chunks[i].end = split;
+        begin = split;
+    }
+
+    // 2. Where every chunk's attributes go
+    pool.parallelFor(chunkCount, 1, [&chunks](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++)
+            count_attributes(chunks[i]);
+    });
+    ObjAttributes attributes;
+    size_t positions = 0, texCoords = 0, normals = 0;
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        chunks[i].positionOffset = positions;
+        chunks[i].texCoordOffset = texCoords;
+        chunks[i].normalOffset = normals;
+        positions += chunks[i].positionCount;
+        texCoords += chunks[i].texCoordCount;
+        normals += chunks[i].normalCount;
+    }
+    attributes.positions.resize(positions);
+    attributes.texCoords.resize(texCoords);
+    attributes.normals.resize(normals);
+
+    // 3. Attributes + faces
+    pool.parallelFor(chunkCount, 1, [&chunks, &attributes](size_t first, size_t last) {
+        for (size_t i = first; i < last; i++)
+            parse_chunk(chunks[i], attributes);
+    });
+    size_t cornerCount = 0;
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        if (chunks[i].error != NULL)
+        {
+            std::cout << "ERROR::OBJ::PARSE_FAILED " << path << " at byte " << chunks[i].error - file.data << std::endl;
+            return false;
+        }
+        cornerCount += chunks[i].corners.size();
+    }
+    if (cornerCount >= EMPTY_SLOT)
+    {
+        std::cout << "ERROR::OBJ::TOO_MANY_FACES " << path << std::endl;
+        return false;
+    }
+
+    // Materials, every mtllib once
+    string directory = path.find_last_of('/') == string::npos ? "." : path.substr(0, path.find_last_of('/'));
+    vector<string> libraries;
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        for (size_t j = 0; j < chunks[i].libraries.size(); j++)
+        {
+            if (find(libraries.begin(), libraries.end(), chunks[i].libraries[j]) == libraries.end())
+            {
+                libraries.push_back(chunks[i].libraries[j]);
+                parse_mtl(directory + '/' + chunks[i].libraries[j], model.materials);
+            }
+        }
+    }
+
+    // Runs of faces w/ the same object + material, in file order
+    vector<ObjRun> runs;
+    string object, material;
+    bool newRun = true;
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        const ObjChunk &chunk = chunks[i];
+        size_t corner = 0;
+        for (size_t j = 0; j <= chunk.events.size(); j++)
+        {
+            size_t segmentEnd = j < chunk.events.size() ? chunk.events[j].corner : chunk.corners.size();
+            if (segmentEnd > corner)
+            {
+                if (newRun)
+                    runs.push_back({object, material, vector<ObjSegment>()});
+                runs.back().segments.push_back({i, corner, segmentEnd});
+                newRun = false;
+                corner = segmentEnd;
+            }
+            if (j == chunk.events.size())
+                break;
+            const ObjEvent &event = chunk.events[j];
+            string &current = event.material ? material : object;
+            newRun = newRun || event.name != current;
+            current = event.name;
+        }
+    }
+
+    // 4. The meshes, each one parallel over its corners
+    map<string, unsigned int> materialIndices;
+    for (size_t i = 0; i < model.materials.size(); i++)
+        materialIndices.insert(make_pair(model.materials[i].name, (unsigned int)i));
+    model.meshes.resize(runs.size());
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        map<string, unsigned int>::const_iterator it = materialIndices.find(runs[i].material);
+        if (it == materialIndices.end())
+        {
+            // No usemtl, or one the MTL files don't have
+            model.materials.push_back(default_material(runs[i].material));
+            it = materialIndices.insert(make_pair(runs[i].material, (unsigned int)model.materials.size() - 1)).first;
+        }
+        model.meshes[i].name = runs[i].name;
+        model.meshes[i].material = it->second;
+        build_mesh(chunks, runs[i], attributes, pool, model.meshes[i]);
+    }
+    return true;
+}
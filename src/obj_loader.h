@@ -0,0 +1,49 @@
+#ifndef OBJ_LOADER_H
+#define OBJ_LOADER_H
+
+#include <string>
+#include <vector>
+
+#include "mesh.h"
+#include "material.h"
+#include "thread_pool.h"
+
+using namespace std;
+
+// A newmtl of the model's MTL files, what it leaves out has assimp's defaults (so both loaders give the same material)
+struct ObjMaterial
+{
+    string name;
+    MaterialParameters parameters;
+    // Map files (relative to the model) w/ the types assimp would give them: map_Kd diffuse, map_Ks specular,
+    // map_Bump / bump texture_normal, map_Ka texture_height
+    vector<Texture> maps;
+};
+
+// Faces of one object ("o" / "g") w/ one material, triangulated, each distinct position/uv/normal triple once
+struct ObjMesh
+{
+    string name;
+    // Index into ObjModel::materials
+    unsigned int material;
+    vector<Vertex> vertices;
+    vector<unsigned int> indices;
+};
+
+struct ObjModel
+{
+    vector<ObjMesh> meshes;
+    vector<ObjMaterial> materials;
+};
+
+// Reads a Wavefront OBJ (+ the MTL files it names) into the engine's Vertex/index layout, the same meshes
+// assimp w/ aiProcess_Triangulate | aiProcess_FlipUVs gives minus the duplicate vertices:
+//   1. the file is memory mapped + split into chunks at line boundaries
+//   2. the chunks count their v/vt/vn lines in parallel, so every chunk knows where its attributes go
+//   3. the chunks are parsed in parallel, attributes straight into the shared arrays, faces into their own lists
+//   4. per mesh, the face corners are deduplicated in parallel through a lock-free hash map
+// False (+ an ERROR:: line) when the file can't be read or has something this doesn't handle (out of range indices,
+// numbers it can't read), the caller falls back to assimp then. Lines, points + free-form geometry are skipped
+bool load_obj(const string &path, ObjModel &model, ThreadPool &pool = ThreadPool::shared());
+
+#endif
@@ -0,0 +1,136 @@
+#include "object_transforms.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OBJECT_TRANSFORMS_SSE 1
+#endif
+
+using namespace std;
+
+#ifdef OBJECT_TRANSFORMS_SSE
+// a * column, a given as its 4 columns
+static inline __m128 transformColumn(const __m128 a[4], const float *column)
+{
+    __m128 result = _mm_mul_ps(a[0], _mm_set1_ps(column[0]));
+    result = _mm_add_ps(result, _mm_mul_ps(a[1], _mm_set1_ps(column[1])));
+    result = _mm_add_ps(result, _mm_mul_ps(a[2], _mm_set1_ps(column[2])));
+    result = _mm_add_ps(result, _mm_mul_ps(a[3], _mm_set1_ps(column[3])));
+    return result;
+}
+
+// xyz cross product (w ends up as 0)
+static inline __m128 cross3(__m128 a, __m128 b)
+{
+    __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 result = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+    return _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+static inline float dot3(__m128 a, __m128 b)
+{
+    __m128 product = _mm_mul_ps(a, b);
+    __m128 y = _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 z = _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 2, 2, 2));
+    return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(product, y), z));
+}
+#endif
+
+void compute_object_transforms(const glm::mat4 *models, size_t count, const glm::mat4 &viewProjection,
+                               unsigned char *out, size_t stride)
+{
+#ifdef OBJECT_TRANSFORMS_SSE
+    __m128 vp[4];
+    for (int i = 0; i < 4; i++)
+        vp[i] = _mm_loadu_ps(&viewProjection[i][0]);
+    // Masks out w so the normal matrix columns are pure xyz
+    const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const float *model = &models[i][0][0];
+        float *transform = (float *)(out + i * stride);
+
+        __m128 columns[4];
+        for (int c = 0; c < 4; c++)
+        {
+            columns[c] = _mm_loadu_ps(model + c * 4);
+            _mm_storeu_ps(transform + c * 4, columns[c]);
+            // MVP = viewProjection * model
+            _mm_storeu_ps(transform + 16 + c * 4, transformColumn(vp, model + c * 4));
+        }
+
+        // inverse(M)^T of a 3x3 matrix with columns c0, c1, c2 = (c1 x c2, c2 x c0, c0 x c1) / det
+        __m128 c0 = _mm_and_ps(columns[0], xyzMask);
+        __m128 c1 = _mm_and_ps(columns[1], xyzMask);
+        __m128 c2 = _mm_and_ps(columns[2], xyzMask);
+        __m128 r0 = cross3(c1, c2);
+        float determinant = dot3(c0, r0);
+        // A zero scaled object isn't visible anyway, just avoid NaNs
+        __m128 inverseDeterminant = _mm_set1_ps(determinant != 0.0f ? 1.0f / determinant : 0.0f);
+        _mm_storeu_ps(transform + 32, _mm_mul_ps(r0, inverseDeterminant));
+        _mm_storeu_ps(transform + 36, _mm_mul_ps(cross3(c2, c0), inverseDeterminant));
+        _mm_storeu_ps(transform + 40, _mm_mul_ps(cross3(c0, c1), inverseDeterminant));
+        _mm_storeu_ps(transform + 44, _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f));
+    }
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        ObjectTransform transform;
+        transform.model = models[i];
+        transform.modelViewProjection = viewProjection * models[i];
+        transform.normalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(models[i]))));
+        memcpy(out + i * stride, &transform, sizeof(transform));
+    }
+#endif
+}
+
+ObjectTransformBuffer::ObjectTransformBuffer(StreamBuffer &stream) : stream(stream), alignment(16), stride(sizeof(ObjectTransform)), viewProjection(1.0f)
+{
+    allocation.buffer = 0;
+    allocation.offset = 0;
+    allocation.data = NULL;
+    // Every object starts at a multiple of the alignment so it can be bound with glBindBufferRange
+    int offsetAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    if (offsetAlignment > 0)
+        alignment = offsetAlignment;
+    stride = (stride + alignment - 1) / alignment * alignment;
+}
+
+void ObjectTransformBuffer::begin(const glm::mat4 &viewProjection)
+{
+    this->viewProjection = viewProjection;
+    models.clear();
+}
+
+unsigned int ObjectTransformBuffer::add(const glm::mat4 &model)
+{
+    models.push_back(model);
+    return (unsigned int)(models.size() - 1);
+}
+
+unsigned int ObjectTransformBuffer::size() const
+{
+    return (unsigned int)models.size();
+}
+
+void ObjectTransformBuffer::upload()
+{
+    if (models.empty())
+        return;
+    // No staging copy, the stream's region isn't in use by the GPU anymore (see stream_buffer.h)
+    allocation = stream.allocate(models.size() * stride, alignment);
+    compute_object_transforms(models.data(), models.size(), viewProjection, allocation.data, stride);
+    stream.flush();
+}
+
+void ObjectTransformBuffer::bind(unsigned int slot) const
+{
+    glBindBufferRange(GL_UNIFORM_BUFFER, OBJECT_BLOCK_BINDING, allocation.buffer, allocation.offset + slot * stride, sizeof(ObjectTransform));
+}
@@ -0,0 +1,62 @@
+#ifndef OBJECT_TRANSFORMS_H
+#define OBJECT_TRANSFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include "stream_buffer.h"
+
+using namespace std;
+
+// Uniform block binding point of ObjectBlock (see shaders/vertex.glsl)
+const unsigned int OBJECT_BLOCK_BINDING = 0;
+
+// Everything a vertex shader needs to place one object, same layout as the std140 ObjectBlock:
+// normalMatrix is the inverse transpose of the model matrix' upper 3x3, stored as a mat4 so there's no
+// std140 padding to think about. Computing it here once per object beats a 4x4 inverse per vertex.
+struct ObjectTransform
+{
+    glm::mat4 model;
+    glm::mat4 modelViewProjection;
+    glm::mat4 normalMatrix;
+};
+
+// Batch kernel: fills out[i] (every stride bytes) for count model matrices.
+// Uses SSE where available, glm otherwise
+void compute_object_transforms(const glm::mat4 *models, size_t count, const glm::mat4 &viewProjection,
+                               unsigned char *out, size_t stride);
+
+// Per-frame transforms of every object, computed in one batch straight into a StreamBuffer allocation.
+// Usage per frame (inside the stream's frame): begin(), add() every object, upload(), then bind(slot) before drawing each object
+class ObjectTransformBuffer
+{
+public:
+    explicit ObjectTransformBuffer(StreamBuffer &stream);
+
+    void begin(const glm::mat4 &viewProjection);
+    // Queues an object, returns the slot to bind() when drawing it
+    unsigned int add(const glm::mat4 &model);
+    unsigned int size() const;
+    // Computes every queued transform + uploads them
+    void upload();
+    // Points ObjectBlock at this object's transforms
+    void bind(unsigned int slot) const;
+
+private:
+    StreamBuffer &stream;
+    // This frame's transforms
+    StreamAllocation allocation;
+    // Uniform buffer offset alignment, + the bytes between two objects in the buffer (sizeof(ObjectTransform) rounded up to it)
+    size_t alignment;
+    size_t stride;
+    glm::mat4 viewProjection;
+    vector<glm::mat4> models;
+
+    ObjectTransformBuffer(const ObjectTransformBuffer &);
+    ObjectTransformBuffer &operator=(const ObjectTransformBuffer &);
+};
+
+#endif
@@ -0,0 +1,264 @@
+#include "post_process.h"
+#include <glad/glad.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const float SHARPEN_KERNEL[9] = {
+    -1, -1, -1,
+    -1, 9, -1,
+    -1, -1, -1};
+
+static const float EDGE_DETECT_KERNEL[9] = {
+    1, 1, 1,
+    1, -8, 1,
+    1, 1, 1};
+
+PostProcessStack::PostProcessStack(ShaderLibrary &shaders) : fxaa(false), shaders(shaders), lastPassCount(0)
+{
+    shaders.declare("post", "./shaders/vertScreen.glsl", "./shaders/fragPost.glsl");
+}
+
+PostEffect &PostProcessStack::add(PostEffectType type, int radius, bool halfResolution)
+{
+    PostEffect effect;
+    effect.type = type;
+    effect.enabled = true;
+    effect.radius = radius;
+    effect.halfResolution = halfResolution;
+    effects.push_back(effect);
+    return effects.back();
+}
+
+PostEffect *PostProcessStack::find(PostEffectType type)
+{
+    for (size_t i = 0; i < effects.size(); i++)
+    {
+        if (effects[i].type == type)
+            return &effects[i];
+    }
+    return NULL;
+}
+
+bool PostProcessStack::empty() const
+{
+    if (fxaa)
+        return false;
+    for (size_t i = 0; i < effects.size(); i++)
+    {
+        if (effects[i].enabled)
+            return false;
+    }
+    return true;
+}
+
+unsigned int PostProcessStack::passCount() const
+{
+    return lastPassCount;
+}
+
+string PostProcessStack::effectName(PostEffectType type)
+{
+    switch (type)
+    {
+    case POST_INVERT:
+        return "invert";
+    case POST_GRAYSCALE:
+        return "grayscale";
+    case POST_VIGNETTE:
+        return "vignette";
+    case POST_SHARPEN:
+        return "sharpen";
+    case POST_EDGE_DETECT:
+        return "edge";
+    case POST_BLUR:
+        return "blur";
+    }
+    return "";
+}
+
+bool PostProcessStack::parseEffect(const string &name, PostEffectType &type)
+{
+    const PostEffectType all[] = {POST_INVERT, POST_GRAYSCALE, POST_VIGNETTE, POST_SHARPEN, POST_EDGE_DETECT, POST_BLUR};
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++)
+    {
+        if (effectName(all[i]) == name)
+        {
+            type = all[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void PostProcessStack::planPasses()
+{
+    passes.clear();
+    if (fxaa)
+    {
+        Pass pass;
+        pass.source = SOURCE_FXAA;
+        pass.kernel = NULL;
+        pass.horizontal = false;
+        pass.radius = 0;
+        pass.divisor = 1;
+        pass.chain = "color";
+        pass.input = -1;
+        pass.width = 0;
+        pass.height = 0;
+        passes.push_back(pass);
+    }
+    for (size_t i = 0; i < effects.size(); i++)
+    {
+        const PostEffect &effect = effects[i];
+        if (!effect.enabled)
+            continue;
+        Pass pass;
+        pass.source = SOURCE_COPY;
+        pass.kernel = NULL;
+        pass.horizontal = false;
+        pass.radius = 0;
+        pass.divisor = effect.halfResolution ? 2 : 1;
+        pass.chain = "color";
+        pass.input = -1;
+        pass.width = 0;
+        pass.height = 0;
+
+        switch (effect.type)
+        {
+        case POST_INVERT:
+        case POST_GRAYSCALE:
+        case POST_VIGNETTE:
+        {
+            // Fused into the previous pass, unless that one runs at a lower resolution
+            // (then this pass also scales the image back up)
+            if (passes.empty() || passes.back().divisor != 1)
+            {
+                pass.divisor = 1;
+                passes.push_back(pass);
+            }
+            string function = effect.type == POST_INVERT ? "Invert" : effect.type == POST_GRAYSCALE ? "Grayscale" : "Vignette";
+            passes.back().chain = function + "(" + passes.back().chain + ")";
+            break;
+        }
+        case POST_SHARPEN:
+        case POST_EDGE_DETECT:
+            pass.source = SOURCE_KERNEL;
+            pass.kernel = effect.type == POST_SHARPEN ? SHARPEN_KERNEL : EDGE_DETECT_KERNEL;
+            passes.push_back(pass);
+            break;
+        case POST_BLUR:
+            pass.source = SOURCE_BLUR;
+            pass.radius = min(max(effect.radius, 1), (POST_MAX_BLUR_TAPS - 1) * 2);
+            pass.horizontal = true;
+            passes.push_back(pass);
+            pass.horizontal = false;
+            passes.push_back(pass);
+            break;
+        }
+    }
+    // The last pass draws to the screen, so it has to be full size
+    if (!passes.empty() && passes.back().divisor != 1)
+    {
+        Pass upscale = passes.back();
+        upscale.source = SOURCE_COPY;
+        upscale.divisor = 1;
+        upscale.chain = "color";
+        passes.push_back(upscale);
+    }
+}
+
+Shader *PostProcessStack::passShader(const Pass &pass)
+{
+    ShaderDefines defines;
+    if (pass.source != SOURCE_COPY)
+        defines.set("POST_SOURCE", (int)pass.source);
+    if (pass.chain != "color")
+        defines.set("POST_CHAIN", pass.chain);
+    return shaders.variant("post", defines);
+}
+
+void PostProcessStack::setBlurUniforms(Shader &shader, const Pass &pass, int width, int height)
+{
+    // Gaussian weights for offsets 0..radius, sigma so the kernel has mostly faded out at the radius
+    float sigma = max(pass.radius / 2.0f, 0.5f);
+    vector<float> weights(pass.radius + 2, 0.0f);
+    float total = 0.0f;
+    for (int i = 0; i <= pass.radius; i++)
+    {
+        weights[i] = exp(-(float)(i * i) / (2.0f * sigma * sigma));
+        total += i == 0 ? weights[i] : 2.0f * weights[i];
+    }
+
+    // Texels i and i + 1 merged into one bilinear tap placed so the filter weighs them correctly
+    int taps = 1;
+    shader.setFloat("blurOffsets[0]", 0.0f);
+    shader.setFloat("blurWeights[0]", weights[0] / total);
+    for (int i = 1; i <= pass.radius; i += 2)
+    {
+        float weight = weights[i] + weights[i + 1];
+        float offset = (i * weights[i] + (i + 1) * weights[i + 1]) / weight;
+        string index = "[" + to_string(taps) + "]";
+        shader.setFloat("blurOffsets" + index, offset);
+        shader.setFloat("blurWeights" + index, weight / total);
+        taps++;
+    }
+    shader.setInt("blurTaps", taps);
+    // One texel of this pass' resolution along the blur direction
+    shader.setVec2("blurDirection", pass.horizontal ? glm::vec2(1.0f / width, 0.0f) : glm::vec2(0.0f, 1.0f / height));
+}
+
+void PostProcessStack::addPasses(FrameGraph &graph, FrameGraphResource source, FrameGraphResource output, unsigned int quadVAO)
+{
+    planPasses();
+    lastPassCount = (unsigned int)passes.size();
+
+    // Intermediate passes run at the source's resolution (which can be below the output's w/ a render scale),
+    // the last one scales it up to the output
+    const FrameGraphTextureDesc &sourceDesc = graph.desc(source);
+    const FrameGraphTextureDesc &outputDesc = graph.desc(output);
+    FrameGraphResource input = source;
+    for (size_t i = 0; i < passes.size(); i++)
+    {
+        Pass &pass = passes[i];
+        const FrameGraphTextureDesc &size = i + 1 < passes.size() ? sourceDesc : outputDesc;
+        pass.input = input;
+        pass.width = max(size.width / pass.divisor, 1);
+        pass.height = max(size.height / pass.divisor, 1);
+        FrameGraphResource target = output;
+        if (i + 1 < passes.size())
+        {
+            // Linear so passes at another resolution scale it smoothly
+            FrameGraphTextureDesc desc = {pass.width, pass.height, GL_RGB8, GL_LINEAR, 0};
+            target = graph.createTexture("post" + to_string(i), desc);
+        }
+        string name = pass.source == SOURCE_FXAA ? "fxaa" : "post " + to_string(i);
+        graph.addPass(name, vector<FrameGraphResource>(1, input), vector<FrameGraphResource>(1, target),
+                      [this, &graph, i, quadVAO]() { runPass(graph, i, quadVAO); });
+        input = target;
+    }
+}
+
+void PostProcessStack::runPass(const FrameGraph &graph, size_t index, unsigned int quadVAO)
+{
+    const Pass &pass = passes[index];
+    glDisable(GL_DEPTH_TEST);
+    Shader *shader = passShader(pass);
+    shader->use();
+    shader->setInt("screenTexture", 0);
+    if (pass.source == SOURCE_KERNEL)
+    {
+        for (int k = 0; k < 9; k++)
+            shader->setFloat("kernel[" + to_string(k) + "]", pass.kernel[k]);
+    }
+    else if (pass.source == SOURCE_BLUR)
+        setBlurUniforms(*shader, pass, pass.width, pass.height);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, graph.texture(pass.input));
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+}
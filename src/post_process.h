@@ -0,0 +1,107 @@
+#ifndef POST_PROCESS_H
+#define POST_PROCESS_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+#include "shader.h"
+#include "shader_library.h"
+#include "frame_graph.h"
+
+using namespace std;
+
+// Most taps (incl. the center one) a blur pass takes, has to match MAX_BLUR_TAPS in fragPost.glsl.
+// Every tap after the first covers 2 texels on each side, so this is a radius of 32
+const int POST_MAX_BLUR_TAPS = 17;
+
+enum PostEffectType
+{
+    // Per-pixel effects, fused into the pass before them
+    POST_INVERT,
+    POST_GRAYSCALE,
+    POST_VIGNETTE,
+    // Neighbourhood effects, each gets its own pass(es)
+    POST_SHARPEN,
+    POST_EDGE_DETECT,
+    POST_BLUR
+};
+
+struct PostEffect
+{
+    PostEffectType type;
+    bool enabled;
+    // Blur radius in pixels of the resolution the blur runs at
+    int radius;
+    // Run at half width + height (a quarter of the pixels), good enough for blurs
+    bool halfResolution;
+};
+
+// Ordered list of screen space effects applied to the rendered frame.
+// The effects are turned into as few full screen passes as possible: per-pixel effects don't need their own
+// pass, they're fused into the pass in front of them as one generated shader variant (fragPost.glsl w/ POST_CHAIN).
+// Blurs are two separable passes, optionally at half resolution. The passes are added to a frame graph,
+// which lets the intermediate targets of a chain share memory (ping-pong between two of each size)
+class PostProcessStack
+{
+public:
+    vector<PostEffect> effects;
+    // FXAA on the scene before any effect (per-pixel effects still fuse into its pass)
+    bool fxaa;
+
+    PostProcessStack(ShaderLibrary &shaders);
+
+    // Appends an effect (disabled effects are kept but skipped)
+    PostEffect &add(PostEffectType type, int radius = 8, bool halfResolution = false);
+    // First effect of this type, NULL if there is none
+    PostEffect *find(PostEffectType type);
+    // True if no effect (or FXAA) is enabled, so the scene can be drawn straight to the default framebuffer
+    bool empty() const;
+    // Adds the passes that run the enabled effects on source + write the result to output (same size)
+    void addPasses(FrameGraph &graph, FrameGraphResource source, FrameGraphResource output, unsigned int quadVAO);
+    // Full screen passes the last addPasses() planned
+    unsigned int passCount() const;
+
+    static string effectName(PostEffectType type);
+    // Parses an effect name as printed by effectName, returns false for an unknown one
+    static bool parseEffect(const string &name, PostEffectType &type);
+
+private:
+    enum PassSource
+    {
+        SOURCE_COPY = 0,
+        SOURCE_KERNEL = 1,
+        SOURCE_BLUR = 2,
+        SOURCE_FXAA = 3
+    };
+    struct Pass
+    {
+        PassSource source;
+        const float *kernel;
+        // Blur: true for the horizontal half
+        bool horizontal;
+        int radius;
+        // 1 or 2, the pass runs at (width, height) / divisor
+        int divisor;
+        // Fused per-pixel effects, as an expression of color
+        string chain;
+        FrameGraphResource input;
+        int width;
+        int height;
+    };
+
+    ShaderLibrary &shaders;
+    vector<Pass> passes;
+    unsigned int lastPassCount;
+
+    void planPasses();
+    Shader *passShader(const Pass &pass);
+    void runPass(const FrameGraph &graph, size_t index, unsigned int quadVAO);
+    void setBlurUniforms(Shader &shader, const Pass &pass, int width, int height);
+
+    PostProcessStack(const PostProcessStack &);
+    PostProcessStack &operator=(const PostProcessStack &);
+};
+
+#endif
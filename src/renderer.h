@@ -0,0 +1,1066 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+
+#include "shader.h"
+#include "shader_cache.h"
+#include "shader_library.h"
+#include "stream_buffer.h"
+#include "object_transforms.h"
+#include "light_clusters.h"
+#include "frame_graph.h"
+#include "gbuffer.h"
+#include "shadow_cascades.h"
+#include "post_process.h"
+#include "dynamic_resolution.h"
+#include "texture_uploader.h"
+#include "texture_streaming.h"
+#include "gpu_timer.h"
+#include "model.h"
+#include "camera.h"
+#include "scene.h"
+#include "simple_models.h"
+
+using namespace std;
+
+unsigned int loadCubemap(vector<std::string> faces);
+void clearFrameBuffer();
+vector<glm::vec3> sortByCameraDistance(vector<glm::vec3> positions, glm::vec3 cameraPosition);
+
+// How lit objects find their lights
+enum LightingPath
+{
+    // Every fragment loops over a fixed array of point light uniforms (at most MAX_FORWARD_POINT_LIGHTS)
+    LIGHTING_FORWARD,
+    // Lights are sorted into froxels on the CPU, every fragment only loops over its froxel's lights
+    LIGHTING_CLUSTERED,
+    // Lit models only write their surface into a G-buffer, one full screen pass then lights every pixel
+    // once (w/ the froxel light lists), so lighting cost doesn't depend on how much geometry there is
+    LIGHTING_DEFERRED
+};
+
+// How edges get smoothed
+enum Antialiasing
+{
+    ANTIALIASING_NONE,
+    // One post pass over the final image, see ApplyFxaa in fragPost.glsl
+    ANTIALIASING_FXAA,
+    // The scene is drawn into a multisampled target, then resolved (averaged) w/ a blit.
+    // Not on the deferred path, the G-buffer has one sample per pixel
+    ANTIALIASING_MSAA_2X,
+    ANTIALIASING_MSAA_4X,
+    ANTIALIASING_MSAA_8X
+};
+
+// Owns all the GL objects needed to draw a Scene (shaders, frame graph, skybox...)
+// and renders one frame of it at a time
+class Renderer
+{
+public:
+    int width;
+    int height;
+    // Blinn-Phong or plain Phong specular (each is its own shader variant)
+    bool blinnPhong;
+    LightingPath lightingPath;
+    // Lay down the depth of the lit models first (positions only), then shade them w/ GL_EQUAL
+    // so every pixel runs the lighting shader once no matter how much overdraw there is
+    bool depthPrepass;
+    // Cascaded shadow maps for the directional light (each setting is its own shader variant)
+    bool shadows;
+    Antialiasing antialiasing;
+    // Models loaded after this is set (w/ litTextureUsage) get their specular maps packed into the diffuse maps' alpha
+    bool packTextures;
+    // Lit models are drawn w/ one call each, their materials from texture arrays (see MaterialBatch)
+    bool materialBatching;
+    // The scene is drawn at width/height * renderScale, then scaled up to the window by the copy (or last post) pass
+    float renderScale;
+    // Adjusts renderScale every frame to keep the GPU frame time at its target, when enabled
+    DynamicResolution dynamicResolution;
+    // Projection, shared by the draws + the light clusters
+    float fieldOfView;
+    float nearPlane;
+    float farPlane;
+
+    Renderer(int width, int height) : width(width), height(height), blinnPhong(true), lightingPath(LIGHTING_CLUSTERED), depthPrepass(false), shadows(true), antialiasing(ANTIALIASING_MSAA_4X), packTextures(false), materialBatching(false), renderScale(1.0f),
+                                      fieldOfView(45.0f), nearPlane(0.1f), farPlane(100.0f), objects(stream),
+                                      lightingVariants(), materialBatchVariant(NULL), litMaterialBinds(0), lightingVariantLights(0), lightingVariantBlinnPhong(true), lightingVariantPath(LIGHTING_CLUSTERED), lightingVariantShadows(true), post(shaders)
+    {
+        glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+
+        // Shaders only get submitted here, the driver builds them while we load textures (+ the scene)
+        // and the first frame waits for whatever is left (see shader_library.h)
+        std::cout << "Loading Shaders..." << std::endl;
+        Shader::setUniformBlockBinding("ObjectBlock", OBJECT_BLOCK_BINDING);
+        Shader::setUniformBlockBinding("MaterialBlock", MATERIAL_BLOCK_BINDING);
+        Shader::setUniformBlockBinding("MaterialParamsBlock", MATERIAL_PARAMS_BINDING);
+        lampShader = shaders.add("lamp", "./shaders/vertex.glsl", "./shaders/fragLamp.glsl");
+        depthShader = shaders.add("depth", "./shaders/vertDepth.glsl", "./shaders/fragDepth.glsl");
+        shadowShader = shaders.add("shadow", "./shaders/vertShadow.glsl", "./shaders/fragDepth.glsl");
+        // Lit objects use variants of this one, see lightingShaderFor
+        shaders.declare("lighting", "./shaders/vertex.glsl", "./shaders/fragLighting.glsl");
+        // Get the variant the default scene (nanosuit) needs into the first batch
+        shaders.variant("lighting", lightingDefines(0, true, 1, true, true, true));
+        // Deferred path: G-buffer variants per mesh (same maps as above) + the lighting pass
+        shaders.declare("gbuffer", "./shaders/vertex.glsl", "./shaders/fragGBuffer.glsl");
+        shaders.declare("deferred", "./shaders/vertScreen.glsl", "./shaders/fragDeferred.glsl");
+        transparencyShader = shaders.add("transparency", "./shaders/vertex.glsl", "./shaders/fragTrans.glsl");
+        screenShader = shaders.add("screen", "./shaders/vertScreen.glsl", "./shaders/fragScreen.glsl");
+        skyboxShader = shaders.add("skybox", "./shaders/vertSkybox.glsl", "./shaders/fragSkybox.glsl");
+        reflectiveCubeShader = shaders.add("reflectiveCube", "./shaders/vertReflect.glsl", "./shaders/fragReflect.glsl");
+        refractiveCubeShader = shaders.add("refractiveCube", "./shaders/vertReflect.glsl", "./shaders/fragRefract.glsl");
+        shaders.submit();
+
+        Texture texture;
+        texture.id = TextureFromFile("transparent-window.png", "./textures", false, GL_CLAMP_TO_EDGE);
+        texture.type = "texture_diffuse";
+        planeMesh = new Mesh(generate_plane(texture));
+
+        quadVAO = generateQuadVAO(quadVBO);
+
+        vector<std::string> faces{
+            "./textures/skybox/right.jpg",
+            "./textures/skybox/left.jpg",
+            "./textures/skybox/top.jpg",
+            "./textures/skybox/bottom.jpg",
+            "./textures/skybox/front.jpg",
+            "./textures/skybox/back.jpg"};
+        cubemapTexture = loadCubemap(faces);
+
+        skyboxVao = generate_skybox_vao(skyboxVbo);
+
+        cubeVAO = generate_cube_vao(cubeVBO);
+
+        setupState();
+    }
+
+    ~Renderer()
+    {
+        // Nothing may still be uploading into the textures deleted here
+        TextureUploader::shared().finish();
+        // The window texture is streamed, the streamer lets go of it first
+        for (size_t i = 0; i < planeMesh->textures.size(); i++)
+        {
+            TextureStreamer::shared().remove(planeMesh->textures[i].id);
+            glDeleteTextures(1, &planeMesh->textures[i].id);
+        }
+        planeMesh->deleteBuffers();
+        delete planeMesh;
+        unsigned int vertexArrays[] = {quadVAO, skyboxVao, cubeVAO};
+        glDeleteVertexArrays(3, vertexArrays);
+        unsigned int buffers[] = {quadVBO, skyboxVbo, cubeVBO};
+        glDeleteBuffers(3, buffers);
+        glDeleteTextures(1, &cubemapTexture);
+    }
+
+    // Size the scene is drawn at (see renderScale)
+    int renderWidth() const
+    {
+        return max((int)(width * renderScale + 0.5f), 1);
+    }
+
+    int renderHeight() const
+    {
+        return max((int)(height * renderScale + 0.5f), 1);
+    }
+
+    // Time spent building shader programs: submitting them + waiting for them on the first frame
+    // (cold = compiled, warm = from the shader cache)
+    double shaderLoadMilliseconds() const
+    {
+        return shaders.submitMilliseconds + shaders.waitMilliseconds;
+    }
+
+    // Which cascades got redrawn last frame etc.
+    const ShadowCascades &shadowCascades() const
+    {
+        return cascades;
+    }
+
+    // Screen space effects applied to every frame, in order
+    PostProcessStack &postEffects()
+    {
+        return post;
+    }
+
+    // Samples per pixel the scene is drawn w/ (0 = not multisampled)
+    int msaaSamples() const
+    {
+        int samples = 0;
+        if (antialiasing == ANTIALIASING_MSAA_2X)
+            samples = 2;
+        else if (antialiasing == ANTIALIASING_MSAA_4X)
+            samples = 4;
+        else if (antialiasing == ANTIALIASING_MSAA_8X)
+            samples = 8;
+        if (lightingPath == LIGHTING_DEFERRED)
+            return 0;
+        return min(samples, (int)maxSamples);
+    }
+
+    static string antialiasingName(Antialiasing antialiasing)
+    {
+        switch (antialiasing)
+        {
+        case ANTIALIASING_NONE:
+            return "none";
+        case ANTIALIASING_FXAA:
+            return "fxaa";
+        case ANTIALIASING_MSAA_2X:
+            return "msaa2";
+        case ANTIALIASING_MSAA_4X:
+            return "msaa4";
+        case ANTIALIASING_MSAA_8X:
+            return "msaa8";
+        }
+        return "";
+    }
+
+    // Passes run + culled, textures aliased last frame (+ the GPU time of every pass when timePasses is on)
+    FrameGraph &frameGraph()
+    {
+        return graph;
+    }
+
+    // Times the lit pass of the last frame bound a material's textures (draws sorted by material skip the rest)
+    unsigned int materialBinds() const
+    {
+        return litMaterialBinds;
+    }
+
+    // Light assignment stats of the last clustered frame
+    const LightClusters &lightClusters() const
+    {
+        return clusters;
+    }
+
+    // Bytes streamed + fence waits of the per-frame data
+    const StreamBuffer &streamBuffer() const
+    {
+        return stream;
+    }
+
+    // Material slots the program lit models start out drawn w/ samples (for loading them, see Model).
+    // Reflected from the linked program, so this waits for it to build. Includes TEXTURE_USAGE_PACK_SPECULAR w/ packTextures
+    unsigned int litTextureUsage()
+    {
+        Shader *shader;
+        if (lightingPath == LIGHTING_DEFERRED)
+        {
+            ShaderDefines defines;
+            defines.set("HAS_DIFFUSE_MAP", 1);
+            defines.set("HAS_SPECULAR_MAP", 1);
+            shader = shaders.variant("gbuffer", defines);
+        }
+        else
+            shader = shaders.variant("lighting", lightingDefines(0, true, 1, blinnPhong, lightingPath == LIGHTING_CLUSTERED, shadows));
+        return Mesh::textureUsage(*shader) | (packTextures ? TEXTURE_USAGE_PACK_SPECULAR : 0);
+    }
+
+    // Draws the scene from the camera's point of view into the default framebuffer.
+    // The frame is a frame graph (see frame_graph.h): shadows, the G-buffer + lighting on the deferred path,
+    // everything drawn forward, then post processing or a copy to the screen
+    void render(Scene &scene, Camera &camera)
+    {
+        if (shaders.pendingCount() > 0)
+        {
+            shaders.finishAll();
+            std::cout << "Shaders ready after " << shaderLoadMilliseconds() << "ms (submit " << shaders.submitMilliseconds
+                      << "ms, wait " << shaders.waitMilliseconds << "ms; "
+                      << ShaderCache::hits() << " from cache, " << ShaderCache::misses() << " compiled)" << std::endl;
+        }
+        // Textures still loading in the background
+        TextureUploader::shared().update();
+        // Minimized, there's nothing to draw to
+        if (width <= 0 || height <= 0)
+            return;
+
+        // The GPU times of the frames that finished since last frame decide this frame's scale
+        frameTimes.clear();
+        frameTimer.collect(frameTimes);
+        if (dynamicResolution.enabled)
+            renderScale = dynamicResolution.update(frameTimes, renderScale);
+        int sceneWidth = renderWidth();
+        int sceneHeight = renderHeight();
+
+        // Creates a view matrix w/ (pos,target,up) that is looking from pos to target
+        glm::mat4 view = camera.GetViewMatrix();
+
+        glm::mat4 projection;
+        // perspective(FOV, aspectRatio, nearPlaneDist, farPlaneDist)
+        // Near Plane should be as far as possible to avoid z-fighting
+        projection = glm::perspective(glm::radians(fieldOfView), (float)width / (float)height, nearPlane, farPlane);
+
+        // Every object's model matrix goes into one batch first, the transforms the vertex shaders need
+        // (model, normal matrix, MVP) are then computed + uploaded together (see object_transforms.h)
+        FrameSlots slots;
+        stream.beginFrame();
+        objects.begin(projection * view);
+        slots.lamps = objects.size();
+        if (scene.lampModel != NULL)
+        {
+            for (size_t i = 0; i < scene.pointLights.size(); i++)
+            {
+                glm::mat4 lampModel = glm::mat4(1.0f);
+                lampModel = glm::translate(lampModel, scene.pointLights[i].position);
+                lampModel = glm::scale(lampModel, glm::vec3(0.2f));
+                objects.add(lampModel);
+            }
+        }
+        slots.lit = objects.size();
+        for (size_t i = 0; i < scene.litModels.size(); i++)
+            objects.add(scene.litModels[i].transform);
+        slots.reflective = queueEnvironmentCubes(scene.reflectiveCubes);
+        slots.refractive = queueEnvironmentCubes(scene.refractiveCubes);
+        scene.windowPositions = sortByCameraDistance(scene.windowPositions, camera.Position);
+        slots.windows = objects.size();
+        for (size_t i = 0; i < scene.windowPositions.size(); i++)
+        {
+            glm::mat4 model = glm::mat4(1.0f);
+            model = glm::scale(model, glm::vec3(1.0f));
+            model = glm::translate(model, scene.windowPositions[i]);
+            objects.add(model);
+        }
+        slots.outlines = objects.size();
+        for (size_t i = 0; i < scene.outlinedModels.size(); i++)
+            objects.add(scene.outlinedModels[i].transform);
+        objects.upload();
+        MaterialRegistry::shared().upload();
+        requestTextureLevels(scene, camera);
+        if (lightingPath != LIGHTING_FORWARD)
+            updateClusters(scene, view);
+
+        graph.reset();
+        FrameGraphResource backbuffer = graph.importBackbuffer(width, height);
+        // The cascades are cached between frames, so the shadow map isn't transient.
+        // The pass gets culled when shadows are off, nothing reads the map then
+        FrameGraphResource shadowMap = graph.importTexture("shadowMap", cascades.texture(), SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+        graph.addPass("shadows", vector<FrameGraphResource>(), vector<FrameGraphResource>(1, shadowMap),
+                      [&]() { drawShadows(scene, view, slots.lit); });
+        vector<FrameGraphResource> lightingInputs;
+        if (shadows)
+            lightingInputs.push_back(shadowMap);
+
+        // Without effects the frame can go straight to the screen, saving the copy.
+        // Deferred still needs its own depth texture, the G-buffer pass shares it w/ the forward pass.
+        // MSAA draws into multisampled color + depth, sceneColor is then where they're resolved to.
+        // Below full resolution sceneColor gets filtered up to the screen
+        int samples = msaaSamples();
+        post.fxaa = antialiasing == ANTIALIASING_FXAA;
+        bool scaled = sceneWidth != width || sceneHeight != height;
+        bool offscreen = !post.empty() || lightingPath == LIGHTING_DEFERRED || samples > 1 || scaled;
+        vector<FrameGraphResource> sceneTargets(1, backbuffer);
+        FrameGraphResource sceneColor = backbuffer;
+        if (offscreen)
+        {
+            FrameGraphTextureDesc color = {sceneWidth, sceneHeight, GL_RGB8, GL_LINEAR, 0};
+            FrameGraphTextureDesc depthStencil = {sceneWidth, sceneHeight, GL_DEPTH24_STENCIL8, GL_NEAREST, 0};
+            sceneColor = graph.createTexture("sceneColor", color);
+            color.samples = samples;
+            depthStencil.samples = samples;
+            sceneTargets[0] = samples > 1 ? graph.createTexture("sceneColorMS", color) : sceneColor;
+            sceneTargets.push_back(graph.createTexture("sceneDepth", depthStencil));
+        }
+
+        vector<FrameGraphResource> forwardReads = lightingInputs;
+        // Deferred: lit models go through the G-buffer first, the rest is drawn forward on top of the result
+        if (lightingPath == LIGHTING_DEFERRED)
+        {
+            GBuffer gBuffer = create_gbuffer(graph, sceneWidth, sceneHeight, sceneTargets[1]);
+            addDeferredPasses(scene, camera, projection * view, slots.lit, gBuffer, sceneTargets[0], lightingInputs);
+            forwardReads = sceneTargets;
+        }
+        graph.addPass("forward", forwardReads, sceneTargets,
+                      [&]() { drawForward(scene, camera, view, projection, slots); });
+
+        if (samples > 1)
+        {
+            FrameGraphResource multisampled = sceneTargets[0];
+            graph.addPass("resolve", vector<FrameGraphResource>(1, multisampled), vector<FrameGraphResource>(1, sceneColor),
+                          [this, multisampled, sceneColor, sceneWidth, sceneHeight]() {
+                              // Averages the samples of every pixel, depth isn't needed after the scene
+                              glBindFramebuffer(GL_READ_FRAMEBUFFER, graph.framebuffer(multisampled));
+                              glBindFramebuffer(GL_DRAW_FRAMEBUFFER, graph.framebuffer(sceneColor));
+                              glBlitFramebuffer(0, 0, sceneWidth, sceneHeight, 0, 0, sceneWidth, sceneHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+                          });
+        }
+        if (offscreen && !post.empty())
+            post.addPasses(graph, sceneColor, backbuffer, quadVAO);
+        else if (offscreen)
+        {
+            FrameGraphResource color = sceneColor;
+            graph.addPass("copy", vector<FrameGraphResource>(1, color), vector<FrameGraphResource>(1, backbuffer), [this, color]() {
+                screenShader->use();
+                glBindVertexArray(quadVAO);
+                glDisable(GL_DEPTH_TEST);
+                glBindTexture(GL_TEXTURE_2D, graph.texture(color));
+                glDrawArrays(GL_TRIANGLES, 0, 6);
+            });
+        }
+
+        // The screen passes of last frame left depth testing off
+        glEnable(GL_DEPTH_TEST);
+        frameTimer.begin();
+        graph.execute();
+        frameTimer.end();
+        stream.endFrame();
+    }
+
+private:
+    // First object slot of everything drawn this frame (see render)
+    struct FrameSlots
+    {
+        unsigned int lamps;
+        unsigned int lit;
+        unsigned int reflective;
+        unsigned int refractive;
+        unsigned int windows;
+        unsigned int outlines;
+    };
+
+    // Per-frame data the GPU reads (object transforms), see stream_buffer.h
+    StreamBuffer stream;
+    // Transforms of everything drawn this frame, one range of the stream (ObjectBlock)
+    ObjectTransformBuffer objects;
+    // Owns the programs below
+    ShaderLibrary shaders;
+    Shader *lampShader;
+    Shader *depthShader;
+    Shader *shadowShader;
+    // Lighting variants for the current light count, indexed by diffuse map * 3 + specular map (0 none, 1 own map,
+    // 2 packed into the diffuse map's alpha)
+    Shader *lightingVariants[6];
+    // + the MATERIAL_BATCH variant
+    Shader *materialBatchVariant;
+    // One mesh of the lit pass, sorted by state
+    struct LitDraw
+    {
+        Shader *shader;
+        unsigned int material;
+        unsigned int instance;
+        Mesh *mesh;
+    };
+    vector<LitDraw> litDraws;
+    unsigned int litMaterialBinds;
+    size_t lightingVariantLights;
+    bool lightingVariantBlinnPhong;
+    LightingPath lightingVariantPath;
+    bool lightingVariantShadows;
+    // Froxel light lists of the clustered path + the scene's lights in the layout they upload
+    LightClusters clusters;
+    vector<ClusterLight> clusterLights;
+    ShadowCascades cascades;
+    vector<ShadowCaster> shadowCasters;
+    PostProcessStack post;
+    // Rebuilt every frame, owns the intermediate targets
+    FrameGraph graph;
+    GLint maxSamples;
+    // Whole frame on the GPU, drives dynamicResolution
+    GpuTimer frameTimer;
+    vector<double> frameTimes;
+    Shader *transparencyShader;
+    Shader *screenShader;
+    Shader *skyboxShader;
+    Shader *reflectiveCubeShader;
+    Shader *refractiveCubeShader;
+
+    Mesh *planeMesh;
+    unsigned int quadVAO, quadVBO;
+    unsigned int cubemapTexture;
+    unsigned int skyboxVao, skyboxVbo;
+    unsigned int cubeVAO, cubeVBO;
+
+    // Lamps, lit models (unless deferred drew them already), environment cubes, windows, outlines + skybox
+    void drawForward(Scene &scene, Camera &camera, const glm::mat4 &view, const glm::mat4 &projection, const FrameSlots &slots)
+    {
+        // On the deferred path this draws on top of the lit G-buffer
+        if (lightingPath != LIGHTING_DEFERRED)
+            clearFrameBuffer();
+
+        // Use lamp shader to render lamps
+        lampShader->use();
+        glStencilMask(0x00); // disable writing to the stencil buffer
+        if (scene.lampModel != NULL)
+        {
+            for (size_t i = 0; i < scene.pointLights.size(); i++)
+            {
+                lampShader->setVec3("color", scene.pointLights[i].diffuse);
+                objects.bind(slots.lamps + i);
+                scene.lampModel->Draw(*lampShader);
+            }
+        }
+        // (function, comparison value, stencil mask)
+        glStencilFunc(GL_ALWAYS, 1, 0xFF); // all fragments should pass the stencil test
+        glStencilMask(0xFF);               // enable writing to the stencil buffer
+        if (lightingPath != LIGHTING_DEFERRED)
+            drawLitModels(scene, camera, slots.lit);
+
+        // Draw Reflective Cubes
+        drawEnvironmentCubes(*reflectiveCubeShader, slots.reflective, scene.reflectiveCubes.size(), camera);
+        // Instead of using the skybox you can use a dynamically generated cubemap
+        // rendered in real-time (or baked) using framebuffers + six camera shots
+
+        // Draw Refractive Cubes
+        drawEnvironmentCubes(*refractiveCubeShader, slots.refractive, scene.refractiveCubes.size(), camera);
+
+        transparencyShader->use();
+        // We don't want culling for our quad windows
+        glDisable(GL_CULL_FACE);
+        transparencyShader->setVec3("viewPos", camera.Position);
+        for (size_t i = 0; i < scene.windowPositions.size(); i++)
+        {
+            objects.bind(slots.windows + i);
+            planeMesh->Draw(*transparencyShader);
+        }
+        glEnable(GL_CULL_FACE);
+
+        lampShader->use();
+        // TODO: fix the rendering of this (skybox w/ new depth text broke it)
+        glStencilFunc(GL_NOTEQUAL, 1, 0xFF); // ignore all stencil values != 1
+        glStencilMask(0x00);                 // disable writing to the stencil buffer
+        glDisable(GL_DEPTH_TEST);            // ignore depth
+        for (size_t i = 0; i < scene.outlinedModels.size(); i++)
+        {
+            objects.bind(slots.outlines + i);
+            scene.outlinedModels[i].model->Draw(*lampShader);
+        }
+        // Reset Stencil Buffer
+        glStencilMask(0xFF);
+        glStencilFunc(GL_ALWAYS, 1, 0xFF);
+        glEnable(GL_DEPTH_TEST);
+
+        // Draw Skybox
+        glDepthMask(GL_FALSE);
+        skyboxShader->use();
+        skyboxShader->setMat4("projection", projection);
+        // Skybox is always drawn around camera position
+        skyboxShader->setMat4("view", glm::mat4(glm::mat3(view)));
+        glBindVertexArray(skyboxVao);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        glDepthMask(GL_TRUE);
+    }
+
+    // Frame constants of the lighting shader: camera, lights, material samplers
+    void setupLighting(Shader &shader, Scene &scene, Camera &camera)
+    {
+        shader.setVec3("viewPos", camera.Position);
+
+        // Setup Directional Light
+        shader.setVec3("dirLight.direction", scene.dirLight.direction);
+        shader.setVec3("dirLight.ambient", scene.dirLight.ambient);
+        shader.setVec3("dirLight.diffuse", scene.dirLight.diffuse);
+        shader.setVec3("dirLight.specular", scene.dirLight.specular);
+
+        if (lightingPath != LIGHTING_FORWARD)
+            clusters.bind(shader);
+        if (shadows)
+            cascades.bind(shader);
+        // Setup Point Lights (the variant was compiled for exactly this many)
+        for (size_t i = 0; i < pointLightCount(scene); i++)
+        {
+            string index = "[" + to_string(i) + "]";
+            const PointLight &light = scene.pointLights[i];
+            shader.setVec3("pointLights" + index + ".position", light.position);
+            shader.setVec3("pointLights" + index + ".ambient", light.ambient);
+            shader.setVec3("pointLights" + index + ".diffuse", light.diffuse);
+            shader.setVec3("pointLights" + index + ".specular", light.specular);
+            shader.setFloat("pointLights" + index + ".constant", light.constant);
+            shader.setFloat("pointLights" + index + ".linear", light.linear);
+            shader.setFloat("pointLights" + index + ".quadratic", light.quadratic);
+        }
+
+        // Setup Spot Light
+        shader.setVec3("spotLight.position", camera.Position);
+        shader.setVec3("spotLight.ambient", glm::vec3(0.8f) * glm::vec3(0.2f));
+        shader.setVec3("spotLight.diffuse", glm::vec3(0.8f));
+        shader.setVec3("spotLight.specular", glm::vec3(1.0f, 1.0f, 1.0f));
+        shader.setFloat("spotLight.constant", 1.0f);
+        shader.setFloat("spotLight.linear", 0.09f);
+        shader.setFloat("spotLight.quadratic", 0.032f);
+        shader.setVec3("spotLight.direction", camera.Front);
+        shader.setFloat("spotLight.cutOff", glm::cos(glm::radians(12.5f)));
+        shader.setFloat("spotLight.outerCutOff", glm::cos(glm::radians(17.5f)));
+
+        // We can set a struct member using <struct>.member
+        // set Material Properties
+        shader.setInt("material.emission", 2);
+    }
+
+    // Most point lights the forward lighting shader takes, bounded by the uniforms a fragment shader can have
+    static const size_t MAX_FORWARD_POINT_LIGHTS = 32;
+
+    // Point lights the forward variant is compiled for (none for the clustered one, they're in the clusters)
+    size_t pointLightCount(const Scene &scene) const
+    {
+        if (lightingPath != LIGHTING_FORWARD)
+            return 0;
+        return scene.pointLights.size() < MAX_FORWARD_POINT_LIGHTS ? scene.pointLights.size() : MAX_FORWARD_POINT_LIGHTS;
+    }
+
+    // specularMap: 0 none, 1 own map, 2 packed into the diffuse map's alpha
+    static ShaderDefines lightingDefines(size_t pointLights, bool diffuseMap, int specularMap, bool blinnPhong = true,
+                                         bool clustered = false, bool shadows = false)
+    {
+        ShaderDefines defines;
+        if (shadows)
+            addShadowDefines(defines);
+        if (clustered)
+        {
+            defines.set("CLUSTERED_LIGHTING", 1);
+            defines.set("CLUSTER_X", CLUSTER_X);
+            defines.set("CLUSTER_Y", CLUSTER_Y);
+            defines.set("CLUSTER_Z", CLUSTER_Z);
+        }
+        defines.set("NR_POINT_LIGHTS", (int)pointLights);
+        defines.set("BLINN_PHONG", blinnPhong ? 1 : 0);
+        defines.set("HAS_DIFFUSE_MAP", diffuseMap ? 1 : 0);
+        defines.set("HAS_SPECULAR_MAP", specularMap);
+        return defines;
+    }
+
+    static void addShadowDefines(ShaderDefines &defines)
+    {
+        defines.set("SHADOWS", 1);
+        defines.set("SHADOW_CASCADES", SHADOW_CASCADES);
+    }
+
+    // Variant of the deferred lighting pass (fragDeferred.glsl)
+    static ShaderDefines deferredDefines(bool blinnPhong, bool shadows)
+    {
+        ShaderDefines defines;
+        if (shadows)
+            addShadowDefines(defines);
+        defines.set("BLINN_PHONG", blinnPhong ? 1 : 0);
+        defines.set("CLUSTER_X", CLUSTER_X);
+        defines.set("CLUSTER_Y", CLUSTER_Y);
+        defines.set("CLUSTER_Z", CLUSTER_Z);
+        return defines;
+    }
+
+    // Lighting shader variant for the scene's light count + the maps this mesh has (see fragLighting.glsl),
+    // or on the deferred path the G-buffer variant for those maps (see fragGBuffer.glsl)
+    Shader *lightingShaderFor(const Mesh &mesh, const Scene &scene)
+    {
+        size_t lights = updateLightingVariants(scene);
+        bool diffuseMap = mesh.hasTexture("texture_diffuse");
+        int specularMap = mesh.packedSpecular ? 2 : mesh.hasTexture("texture_specular") ? 1 : 0;
+        Shader *&shader = lightingVariants[diffuseMap * 3 + specularMap];
+        if (shader == NULL && lightingPath == LIGHTING_DEFERRED)
+        {
+            ShaderDefines defines;
+            defines.set("HAS_DIFFUSE_MAP", diffuseMap ? 1 : 0);
+            defines.set("HAS_SPECULAR_MAP", specularMap);
+            shader = shaders.variant("gbuffer", defines);
+        }
+        else if (shader == NULL)
+            shader = shaders.variant("lighting", lightingDefines(lights, diffuseMap, specularMap, blinnPhong, lightingPath == LIGHTING_CLUSTERED, shadows));
+        return shader;
+    }
+
+    // Same for a model drawn as a MaterialBatch, the maps come from its material arrays
+    Shader *materialBatchShaderFor(const Scene &scene)
+    {
+        size_t lights = updateLightingVariants(scene);
+        if (materialBatchVariant != NULL)
+            return materialBatchVariant;
+        ShaderDefines defines = lightingPath == LIGHTING_DEFERRED
+                                    ? ShaderDefines()
+                                    : lightingDefines(lights, true, 1, blinnPhong, lightingPath == LIGHTING_CLUSTERED, shadows);
+        defines.set("MATERIAL_BATCH", 1);
+        defines.set("MAX_BATCH_MATERIALS", MAX_BATCH_MATERIALS);
+        materialBatchVariant = shaders.variant(lightingPath == LIGHTING_DEFERRED ? "gbuffer" : "lighting", defines);
+        return materialBatchVariant;
+    }
+
+    // Forgets the cached variants when the light count / shading model / path changed, returns the light count
+    size_t updateLightingVariants(const Scene &scene)
+    {
+        size_t lights = pointLightCount(scene);
+        // Variants for another light count / shading model / path are still cached in the library
+        if (lights != lightingVariantLights || blinnPhong != lightingVariantBlinnPhong || lightingPath != lightingVariantPath ||
+            shadows != lightingVariantShadows)
+        {
+            for (int i = 0; i < 6; i++)
+                lightingVariants[i] = NULL;
+            materialBatchVariant = NULL;
+            lightingVariantLights = lights;
+            lightingVariantBlinnPhong = blinnPhong;
+            lightingVariantPath = lightingPath;
+            lightingVariantShadows = shadows;
+            if (lightingPath == LIGHTING_FORWARD && scene.pointLights.size() > MAX_FORWARD_POINT_LIGHTS)
+                std::cout << "Scene has " << scene.pointLights.size() << " point lights, only the first "
+                          << MAX_FORWARD_POINT_LIGHTS << " are used" << std::endl;
+        }
+        return lights;
+    }
+
+    // use our lighting shader program to render an object with light
+    // Each mesh gets the variant for the maps it has, the per-frame uniforms are set once per variant
+    // (on the deferred path these are the G-buffer variants, which don't need any lights).
+    // Draws are sorted by variant, then material, then instance: a program is set up once, a material's textures are
+    // bound once for all its meshes in a row
+    void drawLitModels(Scene &scene, Camera &camera, unsigned int firstSlot)
+    {
+        if (depthPrepass)
+        {
+            drawDepthPrepass(scene, firstSlot);
+            // Only the closest surface passes, depth is already right so don't write it again
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
+        }
+        vector<Shader *> preparedShaders;
+        litDraws.clear();
+        litMaterialBinds = 0;
+        for (size_t i = 0; i < scene.litModels.size(); i++)
+        {
+            Model *model = scene.litModels[i].model;
+            MaterialBatch *batch = materialBatching ? model->GetMaterialBatch() : NULL;
+            if (batch != NULL)
+            {
+                objects.bind(firstSlot + i);
+                Shader *shader = materialBatchShaderFor(scene);
+                useLitShader(*shader, scene, camera, preparedShaders);
+                shader->setFloat("material.shininess", scene.litModels[i].shininess);
+                batch->Draw(*shader);
+                continue;
+            }
+            for (size_t j = 0; j < model->meshes.size(); j++)
+            {
+                Shader *shader = lightingShaderFor(model->meshes[j], scene);
+                // Maps this program samples that the model was loaded w/o (e.g. after switching lighting paths)
+                model->RequireTextures(Mesh::textureUsage(*shader));
+                LitDraw draw = {shader, model->meshes[j].materialId, (unsigned int)i, &model->meshes[j]};
+                litDraws.push_back(draw);
+            }
+        }
+        stable_sort(litDraws.begin(), litDraws.end(), [](const LitDraw &a, const LitDraw &b) {
+            if (a.shader != b.shader)
+                return less<Shader *>()(a.shader, b.shader);
+            if (a.material != b.material)
+                return a.material < b.material;
+            return a.instance < b.instance;
+        });
+
+        const LitDraw *previous = NULL;
+        for (size_t i = 0; i < litDraws.size(); i++)
+        {
+            const LitDraw &draw = litDraws[i];
+            bool newShader = previous == NULL || draw.shader != previous->shader;
+            if (newShader)
+                useLitShader(*draw.shader, scene, camera, preparedShaders);
+            if (newShader || draw.instance != previous->instance)
+            {
+                objects.bind(firstSlot + draw.instance);
+                draw.shader->setFloat("material.shininess", scene.litModels[draw.instance].shininess);
+            }
+            // Meshes of one material share its textures, except the default material's
+            if (newShader || draw.material != previous->material || draw.material == MaterialRegistry::DEFAULT_MATERIAL)
+            {
+                draw.shader->setInt("materialId", (int)draw.material);
+                draw.mesh->BindTextures(*draw.shader);
+                litMaterialBinds++;
+            }
+            draw.mesh->DrawElements();
+            previous = &draw;
+        }
+        if (depthPrepass)
+        {
+            glDepthFunc(GL_LEQUAL);
+            glDepthMask(GL_TRUE);
+        }
+    }
+
+    void useLitShader(Shader &shader, Scene &scene, Camera &camera, vector<Shader *> &preparedShaders)
+    {
+        shader.use();
+        if (lightingPath != LIGHTING_DEFERRED && find(preparedShaders.begin(), preparedShaders.end(), &shader) == preparedShaders.end())
+        {
+            setupLighting(shader, scene, camera);
+            preparedShaders.push_back(&shader);
+        }
+    }
+
+    // Depth only pass over the lit models w/ their position only streams
+    void drawDepthPrepass(Scene &scene, unsigned int firstSlot)
+    {
+        depthShader->use();
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glStencilMask(0x00);
+        for (size_t i = 0; i < scene.litModels.size(); i++)
+        {
+            objects.bind(firstSlot + i);
+            for (size_t j = 0; j < scene.litModels[i].model->meshes.size(); j++)
+                scene.litModels[i].model->meshes[j].DrawDepth();
+        }
+        glStencilMask(0xFF);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    }
+
+    // Geometry pass into the G-buffer, then one full screen lighting pass into color.
+    // The G-buffer's depth + stencil are the scene's, the forward pass draws on top of both
+    void addDeferredPasses(Scene &scene, Camera &camera, const glm::mat4 &viewProjection, unsigned int litSlots,
+                           const GBuffer &gBuffer, FrameGraphResource color, const vector<FrameGraphResource> &lightingInputs)
+    {
+        graph.addPass("gbuffer", vector<FrameGraphResource>(), gbuffer_targets(gBuffer), [this, &scene, &camera, litSlots]() {
+            clear_gbuffer();
+            // Alpha holds the specular intensity, blending would mix it into the color
+            glDisable(GL_BLEND);
+            glStencilFunc(GL_ALWAYS, 1, 0xFF);
+            glStencilMask(0xFF);
+            drawLitModels(scene, camera, litSlots);
+            glEnable(GL_BLEND);
+        });
+
+        vector<FrameGraphResource> reads = gbuffer_targets(gBuffer);
+        reads.insert(reads.end(), lightingInputs.begin(), lightingInputs.end());
+        graph.addPass("deferred lighting", reads, vector<FrameGraphResource>(1, color), [this, &scene, &camera, viewProjection, gBuffer]() {
+            // Every covered pixel gets written, sky pixels are discarded + keep the clear color
+            clearFrameBuffer();
+            glDisable(GL_DEPTH_TEST);
+            glStencilMask(0x00);
+            Shader *shader = shaders.variant("deferred", deferredDefines(blinnPhong, shadows));
+            shader->use();
+            bind_gbuffer_textures(graph, gBuffer, 0);
+            shader->setInt("gAlbedoSpecular", 0);
+            shader->setInt("gNormal", 1);
+            shader->setInt("gShininess", 2);
+            shader->setInt("gDepth", 3);
+            shader->setMat4("inverseViewProjection", glm::inverse(viewProjection));
+            setupLighting(*shader, scene, camera);
+            glBindVertexArray(quadVAO);
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            glBindVertexArray(0);
+            glStencilMask(0xFF);
+            glEnable(GL_DEPTH_TEST);
+        });
+    }
+
+    // Asks the TextureStreamer for the mip level every textured mesh needs where it's closest to the camera
+    void requestTextureLevels(Scene &scene, Camera &camera)
+    {
+        TextureStreamer &streamer = TextureStreamer::shared();
+        for (size_t i = 0; i < scene.litModels.size(); i++)
+        {
+            // Batched models sample their own copies, the textures can drop back to their resident levels
+            if (materialBatching && scene.litModels[i].model->GetMaterialBatch() != NULL)
+                continue;
+            const glm::mat4 &transform = scene.litModels[i].transform;
+            vector<Mesh> &meshes = scene.litModels[i].model->meshes;
+            for (size_t j = 0; j < meshes.size(); j++)
+                requestTextureLevel(streamer, meshes[j], transform, camera.Position);
+        }
+        for (size_t i = 0; i < scene.windowPositions.size(); i++)
+            requestTextureLevel(streamer, *planeMesh, glm::translate(glm::mat4(1.0f), scene.windowPositions[i]), camera.Position);
+        streamer.update();
+    }
+
+    void requestTextureLevel(TextureStreamer &streamer, const Mesh &mesh, const glm::mat4 &transform, const glm::vec3 &viewPos)
+    {
+        if (mesh.textures.empty() || mesh.uvDensity <= 0.0f)
+            return;
+        float scale = max(glm::length(glm::vec3(transform[0])), max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+        glm::vec3 center = glm::vec3(transform * glm::vec4((mesh.boundsMin + mesh.boundsMax) * 0.5f, 1.0f));
+        float radius = glm::length(mesh.boundsMax - mesh.boundsMin) * 0.5f * scale;
+        float distance = max(glm::length(center - viewPos) - radius, nearPlane);
+        // How many pixels one world unit covers at that distance, + how much UV that is per pixel
+        float pixelsPerUnit = (renderHeight() * 0.5f) / (distance * tan(glm::radians(fieldOfView) * 0.5f));
+        float uvPerPixel = mesh.uvDensity / scale / pixelsPerUnit;
+        for (size_t k = 0; k < mesh.textures.size(); k++)
+            streamer.request(mesh.textures[k].id, uvPerPixel);
+    }
+
+    // Redraws the out of date shadow cascades, the lit models are the casters
+    void drawShadows(Scene &scene, const glm::mat4 &view, unsigned int litSlots)
+    {
+        shadowCasters.resize(scene.litModels.size());
+        for (size_t i = 0; i < scene.litModels.size(); i++)
+        {
+            const vector<Mesh> &meshes = scene.litModels[i].model->meshes;
+            glm::vec3 boundsMin = meshes.empty() ? glm::vec3(0.0f) : meshes[0].boundsMin;
+            glm::vec3 boundsMax = meshes.empty() ? glm::vec3(0.0f) : meshes[0].boundsMax;
+            for (size_t j = 1; j < meshes.size(); j++)
+            {
+                boundsMin = glm::min(boundsMin, meshes[j].boundsMin);
+                boundsMax = glm::max(boundsMax, meshes[j].boundsMax);
+            }
+            const glm::mat4 &transform = scene.litModels[i].transform;
+            float scale = max(glm::length(glm::vec3(transform[0])), max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+            shadowCasters[i].center = glm::vec3(transform * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+            shadowCasters[i].radius = glm::length(boundsMax - boundsMin) * 0.5f * scale;
+        }
+        cascades.update(view, fieldOfView, (float)width / (float)height, nearPlane, scene.dirLight.direction, shadowCasters);
+        cascades.render(*shadowShader, [this, &scene, litSlots](size_t caster) {
+            objects.bind(litSlots + caster);
+            Model *model = scene.litModels[caster].model;
+            for (size_t j = 0; j < model->meshes.size(); j++)
+                model->meshes[j].DrawDepth();
+        });
+    }
+
+    // Sorts this frame's point + spot lights into the froxels of the camera
+    void updateClusters(const Scene &scene, const glm::mat4 &view)
+    {
+        clusterLights.resize(scene.pointLights.size() + scene.spotLights.size());
+        for (size_t i = 0; i < scene.pointLights.size(); i++)
+        {
+            const PointLight &point = scene.pointLights[i];
+            ClusterLight &light = clusterLights[i];
+            light.position = point.position;
+            light.ambient = point.ambient;
+            light.diffuse = point.diffuse;
+            light.specular = point.specular;
+            light.constant = point.constant;
+            light.linear = point.linear;
+            light.quadratic = point.quadratic;
+            light.direction = glm::vec3(0.0f);
+            light.cutOff = -2.0f;
+            light.outerCutOff = -2.0f;
+            float intensity = max(max(point.diffuse.x, point.diffuse.y), point.diffuse.z);
+            intensity = max(intensity, max(max(point.specular.x, point.specular.y), point.specular.z));
+            light.range = light_range(point.constant, point.linear, point.quadratic, intensity);
+        }
+        for (size_t i = 0; i < scene.spotLights.size(); i++)
+        {
+            const SpotLight &spot = scene.spotLights[i];
+            ClusterLight &light = clusterLights[scene.pointLights.size() + i];
+            light.position = spot.position;
+            light.ambient = spot.ambient;
+            light.diffuse = spot.diffuse;
+            light.specular = spot.specular;
+            light.constant = spot.constant;
+            light.linear = spot.linear;
+            light.quadratic = spot.quadratic;
+            light.direction = spot.direction;
+            light.cutOff = spot.cutOff;
+            light.outerCutOff = spot.outerCutOff;
+            // Bounded by a sphere, the cone isn't used to cull (a spot's unattenuated ambient ends at the range too)
+            float intensity = max(max(spot.diffuse.x, spot.diffuse.y), spot.diffuse.z);
+            intensity = max(intensity, max(max(spot.specular.x, spot.specular.y), spot.specular.z));
+            light.range = light_range(spot.constant, spot.linear, spot.quadratic, intensity);
+        }
+        clusters.update(clusterLights.data(), clusterLights.size(), view, fieldOfView, nearPlane, farPlane, renderWidth(), renderHeight());
+    }
+
+    void setupState()
+    {
+        // Enable wireframe mode
+        // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+        // Enable Z-buffer test
+        // Depth -> Z value is based on a 1/x curve
+        glEnable(GL_DEPTH_TEST);
+        // Defines which depth test function to use (Default = GL_LESS)
+        glDepthFunc(GL_LEQUAL);
+
+        // Enable Stencil Test
+        glEnable(GL_STENCIL_TEST);
+        // (stencilFail, stencilPassDepthFail, stencilAndDepthPass)
+        // GL_KEEP = keep original frag
+        // GL_REPLACE = replace original frag w/ new frag
+        glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+        // Enable Alpha Blending
+        glEnable(GL_BLEND);
+        // Sets Source and Dest Factors (color = c1(src) + c2(dest))
+        // (source,dest)
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        // Blends RGB and A separately
+        // glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
+        // Enable Culling
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_BACK);
+        // Defines which winding order to look for(winding order = order of verts in triangle)
+        glFrontFace(GL_CCW);
+
+        glEnable(GL_MULTISAMPLE);
+    }
+
+    // Queues a transform per cube, returns the first slot
+    unsigned int queueEnvironmentCubes(const vector<glm::vec3> &positions)
+    {
+        unsigned int first = objects.size();
+        for (size_t i = 0; i < positions.size(); i++)
+            objects.add(glm::translate(glm::mat4(1.0f), positions[i]));
+        return first;
+    }
+
+    void drawEnvironmentCubes(Shader &shader, unsigned int firstSlot, size_t count, Camera &camera)
+    {
+        if (count == 0)
+            return;
+        shader.use();
+        shader.setVec3("cameraPos", camera.Position);
+        glDisable(GL_CULL_FACE); // TODO: fix this
+        glBindVertexArray(cubeVAO);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
+        for (size_t i = 0; i < count; i++)
+        {
+            objects.bind(firstSlot + i);
+            glDrawArrays(GL_TRIANGLES, 0, 36);
+        }
+        glBindVertexArray(0);
+        glEnable(GL_CULL_FACE);
+    }
+
+    Renderer(const Renderer &);
+    Renderer &operator=(const Renderer &);
+};
+
+// Warning: handling transparency like this can break under certain circumstances
+// https://www.khronos.org/opengl/wiki/Transparency_Sorting
+// Order Independant transparency can solve this (for newer hardware and/or w/ a perf cost)
+vector<glm::vec3> sortByCameraDistance(vector<glm::vec3> positions, glm::vec3 cameraPosition)
+{
+    std::map<float, glm::vec3> sorted;
+    for (unsigned int i = 0; i < positions.size(); i++)
+    {
+        float distance = glm::length(cameraPosition - positions[i]);
+        sorted[distance] = positions[i];
+    }
+    int i = 0;
+    for (std::map<float, glm::vec3>::reverse_iterator it = sorted.rbegin(); it != sorted.rend(); ++it)
+    {
+        positions[i] = it->second,
+        ++i;
+    }
+    return positions;
+}
+
+void clearFrameBuffer()
+{
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+}
+
+unsigned int loadCubemap(vector<std::string> faces)
+{
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    // Don't need to flip textures for the cube map.
+    // Adding i iterates through enum
+    for (unsigned int i = 0; i < faces.size(); i++)
+        TextureUploader::shared().load(textureID, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, faces[i], false, false);
+
+    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    return textureID;
+}
+
+#endif
@@ -0,0 +1,231 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+#include "model.h"
+
+using namespace std;
+
+struct DirectionalLight
+{
+    glm::vec3 direction;
+    glm::vec3 ambient;
+    glm::vec3 diffuse;
+    glm::vec3 specular;
+};
+
+struct PointLight
+{
+    glm::vec3 position;
+    glm::vec3 ambient;
+    glm::vec3 diffuse;
+    glm::vec3 specular;
+    // Attenuation = 1 / (constant + linear * d + quadratic * d^2)
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+struct SpotLight
+{
+    glm::vec3 position;
+    glm::vec3 direction;
+    glm::vec3 ambient;
+    glm::vec3 diffuse;
+    glm::vec3 specular;
+    float constant;
+    float linear;
+    float quadratic;
+    // Cosines of the inner (full intensity) and outer (zero intensity) cone angles
+    float cutOff;
+    float outerCutOff;
+};
+
+struct ModelInstance
+{
+    Model *model;
+    glm::mat4 transform;
+    // Specular exponent used when drawing this instance w/ the lighting shader, 0 = its materials' own (Ns)
+    float shininess = 0.0f;
+};
+
+// Everything that gets drawn in a frame, kept separate from the renderer so the
+// same scene can be rendered by the interactive app and the benchmark runner
+class Scene
+{
+public:
+    string name;
+    DirectionalLight dirLight;
+    vector<PointLight> pointLights;
+    // Only lit by the clustered lighting path
+    vector<SpotLight> spotLights;
+    // Drawn w/ the lighting shader
+    vector<ModelInstance> litModels;
+    // Drawn (scaled down) at every point light position so we can see where the lights are
+    Model *lampModel = NULL;
+    // Drawn on top of everything using the stencil buffer
+    vector<ModelInstance> outlinedModels;
+    vector<glm::vec3> reflectiveCubes;
+    vector<glm::vec3> refractiveCubes;
+    // Transparent quads (sorted back to front every frame)
+    vector<glm::vec3> windowPositions;
+    // Cycle the point light colors over time
+    bool animateLights = false;
+    // Lights wander this far around where they started (0 = they stay put)
+    float lightWander = 0.0f;
+
+    Scene(const string &name) : name(name) {}
+    ~Scene()
+    {
+        for (map<string, Model *>::iterator it = models.begin(); it != models.end(); ++it)
+            delete it->second;
+        for (size_t i = 0; i < adoptedModels.size(); i++)
+            delete adoptedModels[i];
+    }
+
+    // Models are shared between instances so each file only gets loaded once
+    // (textureUsage: the material slots to load, see Model)
+    Model *loadModel(const string &path, unsigned int textureUsage = TEXTURE_USAGE_ALL)
+    {
+        map<string, Model *>::iterator it = models.find(path);
+        if (it != models.end())
+        {
+            it->second->RequireTextures(textureUsage);
+            return it->second;
+        }
+        Model *model = new Model(path, textureUsage);
+        models[path] = model;
+        return model;
+    }
+
+    // Takes ownership of a model loaded elsewhere (e.g. on the loader thread, see gl_loader.h)
+    Model *adoptModel(Model *model)
+    {
+        adoptedModels.push_back(model);
+        return model;
+    }
+
+    // Advances anything animated, time is passed in so benchmark runs are repeatable
+    void update(float time)
+    {
+        if (lightWander > 0.0f)
+        {
+            if (lightOrigins.size() != pointLights.size())
+            {
+                lightOrigins.clear();
+                for (size_t i = 0; i < pointLights.size(); i++)
+                    lightOrigins.push_back(pointLights[i].position);
+            }
+            // Every light gets its own phase so they don't all move in lockstep
+            for (size_t i = 0; i < pointLights.size(); i++)
+            {
+                float phase = time + i * 0.37f;
+                pointLights[i].position = lightOrigins[i] + lightWander * glm::vec3(sin(phase), 0.0f, cos(phase * 0.7f));
+            }
+        }
+        if (!animateLights)
+            return;
+        glm::vec3 lightColor;
+        lightColor.x = sin(time * 2.0f);
+        lightColor.y = sin(time * 0.7f);
+        lightColor.z = sin(time * 1.3f);
+        for (size_t i = 0; i < pointLights.size(); i++)
+            pointLights[i].diffuse = lightColor;
+    }
+
+private:
+    map<string, Model *> models;
+    vector<Model *> adoptedModels;
+    vector<glm::vec3> lightOrigins;
+
+    // Scenes own GL resources, copying one would delete them twice
+    Scene(const Scene &);
+    Scene &operator=(const Scene &);
+};
+
+PointLight make_point_light(glm::vec3 position, glm::vec3 color)
+{
+    PointLight light;
+    light.position = position;
+    light.ambient = glm::vec3(0.06f);
+    light.diffuse = color;
+    light.specular = glm::vec3(1.0f);
+    // Covers a distance of ~50 units
+    light.constant = 1.0f;
+    light.linear = 0.09f;
+    light.quadratic = 0.032f;
+    return light;
+}
+
+// Light that fades out over roughly range units (attenuation constants from the usual range table fit)
+PointLight make_point_light(glm::vec3 position, glm::vec3 color, float range)
+{
+    PointLight light = make_point_light(position, color);
+    light.linear = 4.5f / range;
+    light.quadratic = 75.0f / (range * range);
+    return light;
+}
+
+// Angles are in degrees
+SpotLight make_spot_light(glm::vec3 position, glm::vec3 direction, glm::vec3 color, float range, float innerAngle, float outerAngle)
+{
+    SpotLight light;
+    light.position = position;
+    light.direction = glm::normalize(direction);
+    light.ambient = glm::vec3(0.0f);
+    light.diffuse = color;
+    light.specular = glm::vec3(1.0f);
+    light.constant = 1.0f;
+    light.linear = 4.5f / range;
+    light.quadratic = 75.0f / (range * range);
+    light.cutOff = glm::cos(glm::radians(innerAngle));
+    light.outerCutOff = glm::cos(glm::radians(outerAngle));
+    return light;
+}
+
+// The original hard-coded scene: nanosuit, four lamps, two cubes and four windows
+Scene *build_default_scene(unsigned int textureUsage = TEXTURE_USAGE_ALL)
+{
+    Scene *scene = new Scene("default");
+    Model *nanoSuit = scene->loadModel("./models/nanosuit/nanosuit.obj", textureUsage);
+
+    glm::vec3 diffuseColor = glm::vec3(0.3f);
+    scene->dirLight.direction = glm::vec3(-0.2f, -1.0f, -0.3f);
+    scene->dirLight.ambient = diffuseColor * glm::vec3(0.2f);
+    scene->dirLight.diffuse = diffuseColor;
+    scene->dirLight.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+
+    scene->pointLights.push_back(make_point_light(glm::vec3(0.7f, 0.2f, 2.0f), glm::vec3(1.0f)));
+    scene->pointLights.push_back(make_point_light(glm::vec3(2.3f, -3.3f, -4.0f), glm::vec3(1.0f)));
+    scene->pointLights.push_back(make_point_light(glm::vec3(-4.0f, 2.0f, -12.0f), glm::vec3(1.0f)));
+    scene->pointLights.push_back(make_point_light(glm::vec3(0.0f, 0.0f, -3.0f), glm::vec3(1.0f)));
+    scene->animateLights = true;
+    scene->lampModel = nanoSuit;
+
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::scale(model, glm::vec3(.2f));
+    scene->litModels.push_back({nanoSuit, model});
+
+    glm::mat4 outlineModel = glm::mat4(1.0f);
+    outlineModel = glm::scale(outlineModel, glm::vec3(0.3f));
+    scene->outlinedModels.push_back({nanoSuit, outlineModel});
+
+    scene->reflectiveCubes.push_back(glm::vec3(5, 0, 0));
+    scene->refractiveCubes.push_back(glm::vec3(-5, 0, 0));
+
+    scene->windowPositions = {
+        glm::vec3(0.0f, 0.0f, 1.0f),
+        glm::vec3(0.0f, 0.0f, 3.0f),
+        glm::vec3(0.0f, 0.0f, 5.0f),
+        glm::vec3(0.0f, 0.0f, 7.0f)};
+    return scene;
+}
+
+#endif
@@ -0,0 +1,288 @@
+#ifndef SCENE_GENERATOR_H
+#define SCENE_GENERATOR_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+#include "scene.h"
+
+using namespace std;
+
+enum SceneLayout
+{
+    LAYOUT_GRID,
+    LAYOUT_RANDOM
+};
+
+// Knobs for procedurally generated stress test scenes
+struct SceneGeneratorSettings
+{
+    // Number of model instances
+    int models = 16;
+    // Number of point lights
+    int lights = 4;
+    // Number of spot lights (pointing down at the instances)
+    int spots = 0;
+    // Distance a light reaches, 0 = the default ~50 units of make_point_light.
+    // Thousands of lights only make sense with small ranges
+    float lightRange = 0.0f;
+    // How far lights wander around their start position every frame (see Scene::lightWander)
+    float lightWander = 0.0f;
+    // Number of transparent quads, they're stacked in front of the models to create overdraw
+    int quads = 4;
+    // Number of distinct materials cycled through by the instances: the model's own + copies of it w/ other
+    // parameters (diffuse + specular color, shininess), every other one w/o its maps
+    int materials = 4;
+    SceneLayout layout = LAYOUT_GRID;
+    // Distance between neighbouring instances
+    float spacing = 2.5f;
+    // Draw a lamp model at every light (gets expensive w/ lots of lights)
+    bool drawLamps = true;
+    // Same seed = same scene, so benchmark runs can be compared
+    unsigned int seed = 1;
+    string modelPath = "./models/nanosuit/nanosuit.obj";
+    // Material slots of the model to load (TextureUsage bits)
+    unsigned int textureUsage = TEXTURE_USAGE_ALL;
+};
+
+// Builds a scene w/ N model instances, M point lights, K transparent quads and varied materials
+Scene *generate_scene(const SceneGeneratorSettings &settings, const string &name)
+{
+    Scene *scene = new Scene(name);
+    Model *model = scene->loadModel(settings.modelPath, settings.textureUsage);
+    mt19937 random(settings.seed);
+    uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    scene->dirLight.direction = glm::vec3(-0.2f, -1.0f, -0.3f);
+    scene->dirLight.ambient = glm::vec3(0.06f);
+    scene->dirLight.diffuse = glm::vec3(0.3f);
+    scene->dirLight.specular = glm::vec3(1.0f);
+
+    // Material set 0 is the model's own, the others are copies of its meshes w/ materials of their own.
+    // Own random sequence, so the rest of the scene is the same for any number of materials
+    vector<Model *> materialSets(1, model);
+    mt19937 materialRandom(settings.seed);
+    for (int i = 1; i < settings.materials; i++)
+    {
+        glm::vec3 color = glm::vec3(unit(materialRandom), unit(materialRandom), unit(materialRandom));
+        // From rough (shininess 2, dull highlights) to very glossy (256)
+        float glossiness = (float)i / (settings.materials - 1);
+        // Untextured ones sample no maps, they draw w/ other shader variants + show the colors
+        bool textured = i % 2 == 0;
+        materialSets.push_back(scene->adoptModel(new Model(*model, [color, glossiness, textured](Material &material) {
+            material.parameters.diffuse = glm::vec4(color, material.parameters.diffuse.a);
+            material.parameters.specular = glm::vec4(glm::vec3(0.2f + 0.8f * glossiness), pow(2.0f, 1.0f + 7.0f * glossiness));
+            if (!textured)
+            {
+                material.textures.clear();
+                material.deferredTextures.clear();
+                material.packedSpecular = false;
+            }
+        })));
+    }
+
+    // Instances are spread over a square area centered on the origin
+    int columns = max(1, (int)ceil(sqrt((float)settings.models)));
+    float extent = columns * settings.spacing;
+    for (int i = 0; i < settings.models; i++)
+    {
+        glm::vec3 position;
+        float rotation = 0.0f;
+        if (settings.layout == LAYOUT_GRID)
+        {
+            position.x = (i % columns - (columns - 1) * 0.5f) * settings.spacing;
+            position.z = (i / columns - (columns - 1) * 0.5f) * settings.spacing;
+            position.y = 0.0f;
+        }
+        else
+        {
+            position.x = (unit(random) - 0.5f) * extent;
+            position.z = (unit(random) - 0.5f) * extent;
+            position.y = 0.0f;
+            rotation = unit(random) * 360.0f;
+        }
+        glm::mat4 transform = glm::mat4(1.0f);
+        transform = glm::translate(transform, position);
+        transform = glm::rotate(transform, glm::radians(rotation), glm::vec3(0.0f, 1.0f, 0.0f));
+        transform = glm::scale(transform, glm::vec3(0.2f));
+
+        ModelInstance instance = {materialSets[i % materialSets.size()], transform};
+        scene->litModels.push_back(instance);
+    }
+
+    // Lights float above the instances with a random color each
+    for (int i = 0; i < settings.lights; i++)
+    {
+        glm::vec3 position;
+        position.x = (unit(random) - 0.5f) * extent;
+        position.y = 1.0f + unit(random) * 3.0f;
+        position.z = (unit(random) - 0.5f) * extent;
+        glm::vec3 color = glm::vec3(unit(random), unit(random), unit(random));
+        if (settings.lightRange > 0.0f)
+            scene->pointLights.push_back(make_point_light(position, color, settings.lightRange));
+        else
+            scene->pointLights.push_back(make_point_light(position, color));
+    }
+    for (int i = 0; i < settings.spots; i++)
+    {
+        glm::vec3 position;
+        position.x = (unit(random) - 0.5f) * extent;
+        position.y = 3.0f + unit(random) * 2.0f;
+        position.z = (unit(random) - 0.5f) * extent;
+        // Tilted a little away from straight down
+        glm::vec3 direction = glm::vec3(unit(random) - 0.5f, -2.0f, unit(random) - 0.5f);
+        glm::vec3 color = glm::vec3(unit(random), unit(random), unit(random));
+        float range = settings.lightRange > 0.0f ? settings.lightRange * 2.0f : 20.0f;
+        scene->spotLights.push_back(make_spot_light(position, direction, color, range, 15.0f, 25.0f));
+    }
+    scene->lightWander = settings.lightWander;
+    if (settings.drawLamps)
+        scene->lampModel = model;
+
+    // Quads are stacked along z in front of the center of the scene so they cover each other on screen
+    for (int i = 0; i < settings.quads; i++)
+    {
+        glm::vec3 position;
+        position.x = (unit(random) - 0.5f) * 2.0f;
+        position.y = 0.5f + unit(random) * 2.0f;
+        position.z = extent * 0.5f + 1.0f + i * (4.0f / max(1, settings.quads));
+        scene->windowPositions.push_back(position);
+    }
+
+    return scene;
+}
+
+// value as a whole number >= minimum, false (+ an ERROR:: line) for anything else ("", "abc", "3x", "-1" for a count of models)
+bool parse_scene_count(const string &key, const string &value, int minimum, int &count)
+{
+    char *end = NULL;
+    errno = 0;
+    long long parsed = strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || errno == ERANGE || parsed < minimum || parsed > INT_MAX)
+    {
+        std::cout << "ERROR::SCENE_GENERATOR::INVALID_COUNT " << key << "=" << value << ", expected a whole number >= " << minimum
+                  << std::endl;
+        return false;
+    }
+    count = (int)parsed;
+    return true;
+}
+
+// value as a finite number >= 0, false (+ an ERROR:: line) for anything else
+bool parse_scene_number(const string &key, const string &value, float &number)
+{
+    char *end = NULL;
+    float parsed = strtof(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !std::isfinite(parsed) || parsed < 0.0f)
+    {
+        std::cout << "ERROR::SCENE_GENERATOR::INVALID_NUMBER " << key << "=" << value << ", expected a number >= 0" << std::endl;
+        return false;
+    }
+    number = parsed;
+    return true;
+}
+
+// Parses a scene description of the form "<layout>:key=value,key=value"
+// e.g. "grid:models=100,lights=16,quads=32" or "random:models=500,seed=7,lamps=0"
+// or for the clustered lighting stress test "grid:models=100,lights=4096,range=3,wander=1,lamps=0"
+// layout is "grid" or "random", unspecified keys keep their defaults. models + materials are at least 1,
+// no count or number is negative
+// Returns NULL if the description isn't a generated scene.
+Scene *generate_scene(const string &description, unsigned int textureUsage = TEXTURE_USAGE_ALL)
+{
+    SceneGeneratorSettings settings;
+    settings.textureUsage = textureUsage;
+    size_t colon = description.find(':');
+    string layout = description.substr(0, colon);
+    if (layout == "grid")
+        settings.layout = LAYOUT_GRID;
+    else if (layout == "random")
+        settings.layout = LAYOUT_RANDOM;
+    else
+        return NULL;
+
+    if (colon != string::npos)
+    {
+        stringstream stream(description.substr(colon + 1));
+        string pair;
+        while (getline(stream, pair, ','))
+        {
+            size_t equals = pair.find('=');
+            if (equals == string::npos)
+            {
+                std::cout << "ERROR::SCENE_GENERATOR::EXPECTED_KEY_VALUE " << pair << std::endl;
+                return NULL;
+            }
+            string key = pair.substr(0, equals);
+            string value = pair.substr(equals + 1);
+            bool valid = true;
+            if (key == "models")
+                valid = parse_scene_count(key, value, 1, settings.models);
+            else if (key == "lights")
+                valid = parse_scene_count(key, value, 0, settings.lights);
+            else if (key == "spots")
+                valid = parse_scene_count(key, value, 0, settings.spots);
+            else if (key == "range")
+                valid = parse_scene_number(key, value, settings.lightRange);
+            else if (key == "wander")
+                valid = parse_scene_number(key, value, settings.lightWander);
+            else if (key == "quads")
+                valid = parse_scene_count(key, value, 0, settings.quads);
+            else if (key == "materials")
+                valid = parse_scene_count(key, value, 1, settings.materials);
+            else if (key == "spacing")
+                valid = parse_scene_number(key, value, settings.spacing);
+            else if (key == "lamps")
+            {
+                int lamps = 0;
+                valid = parse_scene_count(key, value, 0, lamps);
+                settings.drawLamps = lamps != 0;
+            }
+            else if (key == "seed")
+            {
+                int seed = 0;
+                valid = parse_scene_count(key, value, 0, seed);
+                settings.seed = seed;
+            }
+            else if (key == "model")
+                settings.modelPath = value;
+            else
+            {
+                std::cout << "ERROR::SCENE_GENERATOR::UNKNOWN_KEY " << key << std::endl;
+                return NULL;
+            }
+            if (!valid)
+                return NULL;
+        }
+    }
+
+    std::cout << "Generating scene: " << settings.models << " models, " << settings.lights << " lights, " << settings.spots << " spots, "
+              << settings.quads << " quads, " << settings.materials << " materials" << std::endl;
+    return generate_scene(settings, description);
+}
+
+// Looks up a scene by name, returns NULL if there isn't one
+// "default" is the original showcase scene, anything else is treated as a generated scene description.
+// textureUsage = the material slots the scene's models get loaded w/ (see Renderer::litTextureUsage)
+Scene *load_scene(const string &name, unsigned int textureUsage = TEXTURE_USAGE_ALL)
+{
+    if (name == "default")
+        return build_default_scene(textureUsage);
+    Scene *generated = generate_scene(name, textureUsage);
+    if (generated != NULL)
+        return generated;
+    std::cout << "ERROR::SCENE::UNKNOWN_SCENE " << name << std::endl;
+    return NULL;
+}
+
+#endif
@@ -1,41 +1,179 @@
 #include "shader.h"
+#include "shader_cache.h"
 #include <glad/glad.h>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <map>
+#include <vector>
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 using namespace std;
 
-Shader::Shader(const string vertexPath, const string fragmentPath)
+static map<string, unsigned int> &uniformBlockBindings()
 {
-    int vertexShader = generateAndCompileShader(vertexPath, GL_VERTEX_SHADER);
-    checkSuccessfulShaderCompilation(vertexShader);
+    static map<string, unsigned int> bindings;
+    return bindings;
+}
 
-    int fragmentShader = generateAndCompileShader(fragmentPath, GL_FRAGMENT_SHADER);
-    checkSuccessfulShaderCompilation(fragmentShader);
+Shader::Shader(const string vertexPath, const string fragmentPath, bool deferBuild)
+    : Shader(vertexPath, fragmentPath, ShaderDefines(), deferBuild)
+{
+}
+
+Shader::Shader(const string vertexPath, const string fragmentPath, const ShaderDefines &defines, bool deferBuild)
+    : state(SHADER_NOT_STARTED), samplersReflected(false), definesKey(defines.key()), vertexShader(0), fragmentShader(0)
+{
+    vertexSource = readSource(vertexPath, defines);
+    fragmentSource = readSource(fragmentPath, defines);
 
     unsigned int shaderProgram;
     shaderProgram = glCreateProgram();
+    ID = shaderProgram;
 
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+    if (!deferBuild)
+    {
+        compile();
+        link();
+        finish();
+    }
+}
 
-    checkSuccessfulShaderLink(shaderProgram);
+void Shader::use()
+{
+    if (state != SHADER_READY)
+        finish();
+    glUseProgram(ID);
+}
 
-    ID = shaderProgram;
+void Shader::compile()
+{
+    if (state != SHADER_NOT_STARTED)
+        return;
+
+    // Reuse the driver's compiled program from a previous run when we can (see shader_cache.h)
+    cacheKey = ShaderCache::key(vertexSource, fragmentSource, definesKey);
+    if (ShaderCache::load(ID, cacheKey))
+    {
+        applyUniformBlockBindings();
+        sourceFiles.clear();
+        state = SHADER_READY;
+    }
+    else
+    {
+        // Status is only checked in finish(), asking for it here would make us wait for the compiler
+        vertexShader = generateAndCompileShader(vertexSource, GL_VERTEX_SHADER);
+        fragmentShader = generateAndCompileShader(fragmentSource, GL_FRAGMENT_SHADER);
+        state = SHADER_COMPILING;
+    }
+    // Sources aren't needed once the driver has them
+    vertexSource.clear();
+    fragmentSource.clear();
+}
+
+void Shader::link()
+{
+    if (state == SHADER_NOT_STARTED)
+        compile();
+    if (state != SHADER_COMPILING)
+        return;
+
+    glAttachShader(ID, vertexShader);
+    glAttachShader(ID, fragmentShader);
+    ShaderCache::prepare(ID);
+    glLinkProgram(ID);
+    state = SHADER_LINKING;
+}
+
+bool Shader::isComplete() const
+{
+    if (state != SHADER_LINKING || !GLAD_GL_KHR_parallel_shader_compile)
+        return true;
+    int complete;
+    glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete != 0;
+}
+
+void Shader::finish()
+{
+    if (state == SHADER_READY)
+        return;
+    link();
+
+    // A failed link is almost always a failed compile, check those first for the more useful error log
+    int linked;
+    glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+        checkSuccessfulShaderCompilation(vertexShader);
+        checkSuccessfulShaderCompilation(fragmentShader);
+        checkSuccessfulShaderLink(ID);
+    }
+    ShaderCache::store(ID, cacheKey);
+    applyUniformBlockBindings();
 
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
+    sourceFiles.clear();
+    state = SHADER_READY;
 }
 
-void Shader::use()
+bool Shader::isReady() const
 {
-    glUseProgram(ID);
+    return state == SHADER_READY;
+}
+
+const vector<string> &Shader::activeSamplers()
+{
+    if (samplersReflected)
+        return samplers;
+    finish();
+    int count = 0;
+    int maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    vector<char> name(max(maxLength, 1) + 1);
+    for (int i = 0; i < count; i++)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, i, (GLsizei)name.size(), &length, &size, &type, name.data());
+        switch (type)
+        {
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_2D_SHADOW:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_MULTISAMPLE:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_BUFFER:
+            samplers.push_back(string(name.data(), length));
+            break;
+        }
+    }
+    samplersReflected = true;
+    return samplers;
+}
+
+void Shader::setUniformBlockBinding(const string &blockName, unsigned int binding)
+{
+    uniformBlockBindings()[blockName] = binding;
+}
+
+void Shader::applyUniformBlockBindings()
+{
+    const map<string, unsigned int> &bindings = uniformBlockBindings();
+    for (map<string, unsigned int>::const_iterator it = bindings.begin(); it != bindings.end(); ++it)
+    {
+        unsigned int index = glGetUniformBlockIndex(ID, it->first.c_str());
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, it->second);
+    }
 }
 
 void Shader::setBool(const string &name, bool value) const
@@ -58,19 +196,23 @@ void Shader::setMat4(const string &name, glm::mat4 value) const
     glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
 }
 
+void Shader::setVec2(const string &name, glm::vec2 value) const
+{
+    glUniform2f(glGetUniformLocation(ID, name.c_str()), value.x, value.y);
+}
+
 void Shader::setVec3(const string &name, glm::vec3 value) const
 {
     glUniform3f(glGetUniformLocation(ID, name.c_str()), value.x, value.y, value.z);
 }
 
-int Shader::generateAndCompileShader(string sourceFileLocation, int shaderType)
+int Shader::generateAndCompileShader(const string &shaderSource, int shaderType)
 {
     unsigned int shaderId;
     // Create Shader Object
     shaderId = glCreateShader(shaderType);
 
     // Read source code into a C string
-    string shaderSource = readFileContents(sourceFileLocation);
     const char *vertexShaderSource = shaderSource.c_str();
     // Read source code into shader object
     glShaderSource(shaderId, 1, &vertexShaderSource, NULL);
@@ -81,15 +223,16 @@ int Shader::generateAndCompileShader(string sourceFileLocation, int shaderType)
     return shaderId;
 }
 
-string Shader::readFileContents(string filename)
+string Shader::readSource(const string &path, const ShaderDefines &defines)
 {
-    ifstream file;
-    file.open(filename);
-    stringstream fileStream;
-    fileStream << file.rdbuf();
-    file.close();
-
-    return fileStream.str();
+    PreprocessedShader shader;
+    if (!preprocess_shader(path, defines, shader))
+        throw runtime_error("Shader Source Missing");
+    sourceFiles += path + ":";
+    for (size_t i = 0; i < shader.files.size(); i++)
+        sourceFiles += " " + to_string(i) + "=" + shader.files[i];
+    sourceFiles += "\n";
+    return shader.source;
 }
 
 void Shader::checkSuccessfulShaderCompilation(int shaderId)
@@ -102,7 +245,8 @@ void Shader::checkSuccessfulShaderCompilation(int shaderId)
     {
         glGetShaderInfoLog(shaderId, 512, NULL, infoLog);
         std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
+                  << infoLog << "Source files (" << definesKey << ")\n"
+                  << sourceFiles << std::endl;
         throw runtime_error("Shader Compilation Unsuccessful");
     }
 }
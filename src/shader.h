@@ -6,6 +6,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <string>
+#include <vector>
+
+#include "shader_preprocessor.h"
 
 using namespace std;
 
@@ -15,20 +18,63 @@ public:
     unsigned int ID;
 
     // Read + compile shader
-    Shader(const string vertexPath, const string fragmentPath);
-    // Activate shader
+    // With deferBuild only the sources are read, the GL work is left to compile() / link() / finish()
+    // so a ShaderLibrary can get the driver working on several programs at once
+    Shader(const string vertexPath, const string fragmentPath, bool deferBuild = false);
+    // Same but specialized with a set of #defines (see shader_preprocessor.h)
+    Shader(const string vertexPath, const string fragmentPath, const ShaderDefines &defines, bool deferBuild = false);
+    // Activate shader (finishes the build first if it is still pending)
     void use();
 
+    // Hand the sources to the driver, doesn't wait for the result
+    void compile();
+    // Start linking, doesn't wait for the result either
+    void link();
+    // True once the driver is done with the program, so finish() won't block
+    // (only known with GL_KHR_parallel_shader_compile, otherwise always true)
+    bool isComplete() const;
+    // Waits for the build and checks it succeeded, throws if it didn't
+    void finish();
+    bool isReady() const;
+    // Names of the sampler uniforms the program actually uses (the compiler drops the ones it doesn't read),
+    // e.g. "material.texture_diffuse1". Reflected once, finishes the build first if it is still pending
+    const vector<string> &activeSamplers();
+
+    // Every program with a uniform block of this name gets it bound to this binding point
+    // (GLSL 330 has no layout(binding = N) so it has to be done from here after linking)
+    static void setUniformBlockBinding(const string &blockName, unsigned int binding);
+
     void setBool(const string &name, bool value) const;
     void setInt(const string &name, int value) const;
     void setFloat(const string &name, float value) const;
     void setMat4(const string &name, glm::mat4 value) const;
+    void setVec2(const string &name, glm::vec2 value) const;
     void setVec3(const string &name, glm::vec3 value) const;
 
 private:
-    string readFileContents(string filename);
+    enum BuildState
+    {
+        SHADER_NOT_STARTED,
+        SHADER_COMPILING,
+        SHADER_LINKING,
+        SHADER_READY
+    };
+    BuildState state;
+    string vertexSource;
+    string fragmentSource;
+    vector<string> samplers;
+    bool samplersReflected;
+    string definesKey;
+    string cacheKey;
+    // File index -> name for compiler errors, see preprocess_shader
+    string sourceFiles;
+    int vertexShader;
+    int fragmentShader;
+
+    string readSource(const string &path, const ShaderDefines &defines);
+    void applyUniformBlockBindings();
     void checkSuccessfulShaderCompilation(int shaderId);
-    int generateAndCompileShader(string sourceFileLocation, int shaderType);
+    int generateAndCompileShader(const string &shaderSource, int shaderType);
     void checkSuccessfulShaderLink(int shaderId);
 };
 
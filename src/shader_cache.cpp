@@ -0,0 +1,179 @@
+#include "shader_cache.h"
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+string ShaderCache::directory = "./shader_cache";
+
+static unsigned int cacheHits = 0;
+static unsigned int cacheMisses = 0;
+
+// Identifies a cache file, bump the version when the layout changes
+static const char CACHE_MAGIC[4] = {'G', 'L', 'P', 'B'};
+static const unsigned int CACHE_VERSION = 1;
+
+struct CacheFileHeader
+{
+    char magic[4];
+    unsigned int version;
+    unsigned int binaryFormat;
+    unsigned int length;
+};
+
+// 64 bit FNV-1a, plenty to tell a handful of shader programs apart
+static unsigned long long hashString(unsigned long long hash, const string &value)
+{
+    for (size_t i = 0; i < value.size(); i++)
+    {
+        hash ^= (unsigned char)value[i];
+        hash *= 1099511628211ULL;
+    }
+    // Separator so ("ab", "c") and ("a", "bc") don't hash the same
+    hash ^= 0xff;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+static string glString(GLenum name)
+{
+    const GLubyte *value = glGetString(name);
+    return value != NULL ? string((const char *)value) : string();
+}
+
+// Binaries are only guaranteed to work on the driver that produced them
+static const string &driverString()
+{
+    static string driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+    return driver;
+}
+
+static string cachePath(const string &key)
+{
+    return ShaderCache::directory + "/" + key + ".bin";
+}
+
+static void createDirectory(const string &path)
+{
+#ifdef _WIN32
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+bool ShaderCache::isEnabled()
+{
+    if (!GLAD_GL_ARB_get_program_binary)
+        return false;
+    const char *setting = getenv("SHADER_CACHE");
+    return setting == NULL || strcmp(setting, "0") != 0;
+}
+
+string ShaderCache::key(const string &vertexSource, const string &fragmentSource, const string &defines)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    hash = hashString(hash, vertexSource);
+    hash = hashString(hash, fragmentSource);
+    hash = hashString(hash, defines);
+    hash = hashString(hash, driverString());
+
+    stringstream key;
+    key << hex << setw(16) << setfill('0') << hash;
+    return key.str();
+}
+
+bool ShaderCache::load(unsigned int program, const string &key)
+{
+    if (!isEnabled())
+    {
+        cacheMisses++;
+        return false;
+    }
+
+    ifstream file(cachePath(key), ios::binary);
+    CacheFileHeader header;
+    if (!file || !file.read((char *)&header, sizeof(header)) || memcmp(header.magic, CACHE_MAGIC, 4) != 0 ||
+        header.version != CACHE_VERSION || header.length == 0)
+    {
+        cacheMisses++;
+        return false;
+    }
+    vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size()))
+    {
+        cacheMisses++;
+        return false;
+    }
+
+    glProgramBinary(program, header.binaryFormat, binary.data(), header.length);
+    // The driver can reject a binary it produced itself (e.g. after an update), which shows up as a failed link
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        std::cout << "ERROR::SHADER_CACHE::STALE_BINARY " << key << ", recompiling" << std::endl;
+        cacheMisses++;
+        return false;
+    }
+    cacheHits++;
+    return true;
+}
+
+void ShaderCache::prepare(unsigned int program)
+{
+    if (isEnabled())
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ShaderCache::store(unsigned int program, const string &key)
+{
+    if (!isEnabled())
+        return;
+
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+    vector<char> binary(length);
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(program, length, &length, &binaryFormat, binary.data());
+
+    createDirectory(directory);
+    ofstream file(cachePath(key), ios::binary | ios::trunc);
+    if (!file)
+    {
+        std::cout << "ERROR::SHADER_CACHE::FAILED_TO_WRITE " << cachePath(key) << std::endl;
+        return;
+    }
+    CacheFileHeader header;
+    memcpy(header.magic, CACHE_MAGIC, 4);
+    header.version = CACHE_VERSION;
+    header.binaryFormat = binaryFormat;
+    header.length = (unsigned int)length;
+    file.write((const char *)&header, sizeof(header));
+    file.write(binary.data(), length);
+}
+
+unsigned int ShaderCache::hits()
+{
+    return cacheHits;
+}
+
+unsigned int ShaderCache::misses()
+{
+    return cacheMisses;
+}
@@ -0,0 +1,40 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad/glad.h>
+#include <string>
+
+using namespace std;
+
+// On-disk cache of linked shader programs (GL_ARB_get_program_binary):
+// compiling + linking GLSL is one of the slowest parts of startup, but once a program is linked
+// the driver can hand us its compiled form with glGetProgramBinary and take it back later with
+// glProgramBinary, skipping the compiler entirely.
+// A binary is only valid for the exact same sources on the exact same driver, so entries are keyed by
+// a hash of the sources, the defines and the GL vendor/renderer/version strings. If the driver still
+// rejects a binary (it is allowed to, e.g. after an update) the caller compiles from source instead.
+class ShaderCache
+{
+public:
+    // Where binaries are stored
+    static string directory;
+
+    // Disabled by setting the SHADER_CACHE environment variable to 0 (forces a cold start)
+    static bool isEnabled();
+
+    // Key identifying a program built from these sources on the current driver
+    static string key(const string &vertexSource, const string &fragmentSource, const string &defines);
+
+    // Tries to load program from the cache, returns false (program untouched or unlinked) on a miss
+    static bool load(unsigned int program, const string &key);
+    // Must be called before linking so the driver keeps a retrievable binary around
+    static void prepare(unsigned int program);
+    // Writes the binary of a successfully linked program to disk
+    static void store(unsigned int program, const string &key);
+
+    // Programs loaded from disk / compiled from source since startup
+    static unsigned int hits();
+    static unsigned int misses();
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include "shader_library.h"
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+ShaderLibrary::ShaderLibrary() : submitMilliseconds(0), waitMilliseconds(0), submitted(false)
+{
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+    for (Shader *shader : shaders)
+        delete shader;
+}
+
+Shader *ShaderLibrary::add(const string &name, const string &vertexPath, const string &fragmentPath)
+{
+    declare(name, vertexPath, fragmentPath);
+    return variant(name, ShaderDefines());
+}
+
+void ShaderLibrary::declare(const string &name, const string &vertexPath, const string &fragmentPath)
+{
+    sources[name] = {vertexPath, fragmentPath};
+}
+
+Shader *ShaderLibrary::variant(const string &name, const ShaderDefines &defines)
+{
+    string key = name + "|" + defines.key();
+    map<string, Shader *>::iterator found = variants.find(key);
+    if (found != variants.end())
+        return found->second;
+
+    map<string, ShaderSource>::iterator source = sources.find(name);
+    if (source == sources.end())
+    {
+        std::cout << "ERROR::SHADER_LIBRARY::UNKNOWN_PROGRAM " << name << std::endl;
+        return NULL;
+    }
+    Shader *shader = new Shader(source->second.vertexPath, source->second.fragmentPath, defines, true);
+    shaders.push_back(shader);
+    variants[key] = shader;
+    // Before submit() it goes out with the rest of the batch
+    if (submitted)
+    {
+        shader->compile();
+        shader->link();
+    }
+    return shader;
+}
+
+Shader *ShaderLibrary::get(const string &name) const
+{
+    map<string, Shader *>::const_iterator found = variants.find(name + "|");
+    return found != variants.end() ? found->second : NULL;
+}
+
+void ShaderLibrary::submit()
+{
+    chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+    // Let the driver use as many compiler threads as it likes
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+
+    // All compiles before any link, so a driver that compiles lazily/in parallel has everything queued up
+    for (Shader *shader : shaders)
+        shader->compile();
+    for (Shader *shader : shaders)
+        shader->link();
+    submitted = true;
+    submitMilliseconds += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+}
+
+void ShaderLibrary::finishCompleted()
+{
+    for (Shader *shader : shaders)
+    {
+        if (!shader->isReady() && shader->isComplete())
+            shader->finish();
+    }
+}
+
+void ShaderLibrary::finishAll()
+{
+    chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+    for (Shader *shader : shaders)
+        shader->finish();
+    waitMilliseconds += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+}
+
+unsigned int ShaderLibrary::pendingCount() const
+{
+    unsigned int pending = 0;
+    for (Shader *shader : shaders)
+    {
+        if (!shader->isReady())
+            pending++;
+    }
+    return pending;
+}
@@ -0,0 +1,69 @@
+#ifndef SHADER_LIBRARY_H
+#define SHADER_LIBRARY_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "shader.h"
+
+using namespace std;
+
+// Builds all the shader programs of the app as one batch:
+// compiling a Shader normally waits on the driver twice (compile status, link status) per program,
+// so seven programs are compiled strictly one after the other. Here every program is compiled first,
+// then every program is linked, and nobody waits until a program is actually used (Shader::use).
+// Drivers with GL_KHR_parallel_shader_compile build the programs on their own threads in the meantime,
+// which lets us load textures + models while the shaders are still compiling.
+//
+// A program can also have variants specialized with #defines (see shader_preprocessor.h). Variants are
+// built lazily the first time their key is asked for and cached by key after that.
+class ShaderLibrary
+{
+public:
+    ShaderLibrary();
+    ~ShaderLibrary();
+
+    // Queues a program, the returned Shader is owned by the library and usable right away
+    // (its first use() waits for it to finish building)
+    Shader *add(const string &name, const string &vertexPath, const string &fragmentPath);
+    // Registers a program without building anything, only its variants get built
+    void declare(const string &name, const string &vertexPath, const string &fragmentPath);
+    // The program specialized with these defines, building it if this is the first time the key is seen
+    // (after submit() the build starts right away, use() waits for it). NULL for an unknown name
+    Shader *variant(const string &name, const ShaderDefines &defines);
+    // The program as added (no extra defines), NULL if there is no program with that name
+    Shader *get(const string &name) const;
+
+    // Starts compiling + linking everything that was added
+    void submit();
+    // Finishes the programs the driver is already done with, never blocks
+    void finishCompleted();
+    // Waits for every program + checks for errors
+    void finishAll();
+    // Programs that haven't been finished yet
+    unsigned int pendingCount() const;
+
+    // Time spent issuing the GL work and time spent waiting on the driver afterwards
+    double submitMilliseconds;
+    double waitMilliseconds;
+
+private:
+    struct ShaderSource
+    {
+        string vertexPath;
+        string fragmentPath;
+    };
+
+    bool submitted;
+    vector<Shader *> shaders;
+    map<string, ShaderSource> sources;
+    // Keyed by name + "|" + ShaderDefines::key()
+    map<string, Shader *> variants;
+
+    // Copying would double delete the shaders
+    ShaderLibrary(const ShaderLibrary &);
+    ShaderLibrary &operator=(const ShaderLibrary &);
+};
+
+#endif
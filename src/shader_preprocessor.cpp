@@ -0,0 +1,126 @@
+#include "shader_preprocessor.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+ShaderDefines &ShaderDefines::set(const string &name, const string &value)
+{
+    values[name] = value;
+    return *this;
+}
+
+ShaderDefines &ShaderDefines::set(const string &name, int value)
+{
+    return set(name, to_string(value));
+}
+
+bool ShaderDefines::empty() const
+{
+    return values.empty();
+}
+
+string ShaderDefines::key() const
+{
+    string key;
+    for (map<string, string>::const_iterator it = values.begin(); it != values.end(); ++it)
+    {
+        if (!key.empty())
+            key += ";";
+        key += it->first + "=" + it->second;
+    }
+    return key;
+}
+
+string ShaderDefines::glsl() const
+{
+    string glsl;
+    for (map<string, string>::const_iterator it = values.begin(); it != values.end(); ++it)
+        glsl += "#define " + it->first + " " + it->second + "\n";
+    return glsl;
+}
+
+static string directoryOf(const string &path)
+{
+    size_t slash = path.find_last_of("/\\");
+    return slash == string::npos ? string(".") : path.substr(0, slash);
+}
+
+// Returns the first token after the # of a preprocessor line ("include", "version", ...)
+static string directiveOf(const string &line)
+{
+    size_t start = line.find_first_not_of(" \t");
+    if (start == string::npos || line[start] != '#')
+        return "";
+    start = line.find_first_not_of(" \t", start + 1);
+    if (start == string::npos)
+        return "";
+    size_t end = line.find_first_of(" \t\"<", start);
+    return line.substr(start, end == string::npos ? string::npos : end - start);
+}
+
+static bool processFile(const string &path, const ShaderDefines &defines, PreprocessedShader &result)
+{
+    ifstream file(path);
+    if (!file)
+    {
+        std::cout << "ERROR::SHADER::FILE_NOT_FOUND " << path << std::endl;
+        return false;
+    }
+    bool root = result.files.empty();
+    int fileIndex = (int)result.files.size();
+    result.files.push_back(path);
+    if (!root)
+        result.source += "#line 1 " + to_string(fileIndex) + "\n";
+
+    string line;
+    int lineNumber = 0;
+    while (getline(file, line))
+    {
+        lineNumber++;
+        string directive = directiveOf(line);
+        if (directive == "version")
+        {
+            // Only the root file's #version counts, the defines have to come right after it
+            if (root)
+            {
+                result.source += line + "\n" + defines.glsl();
+                result.source += "#line " + to_string(lineNumber + 1) + " " + to_string(fileIndex) + "\n";
+            }
+            continue;
+        }
+        if (directive == "include")
+        {
+            size_t open = line.find('"');
+            size_t close = open == string::npos ? string::npos : line.find('"', open + 1);
+            if (close == string::npos)
+            {
+                std::cout << "ERROR::SHADER::BAD_INCLUDE " << path << "(" << lineNumber << "): " << line << std::endl;
+                return false;
+            }
+            string includePath = directoryOf(path) + "/" + line.substr(open + 1, close - open - 1);
+            // Include guards for free: every file only goes in once
+            if (find(result.files.begin(), result.files.end(), includePath) == result.files.end())
+            {
+                if (!processFile(includePath, defines, result))
+                    return false;
+                result.source += "#line " + to_string(lineNumber + 1) + " " + to_string(fileIndex) + "\n";
+            }
+            continue;
+        }
+        result.source += line + "\n";
+    }
+    return true;
+}
+
+bool preprocess_shader(const string &path, const ShaderDefines &defines, PreprocessedShader &result)
+{
+    result.source.clear();
+    result.files.clear();
+    return processFile(path, defines, result);
+}
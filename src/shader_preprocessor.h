@@ -0,0 +1,43 @@
+#ifndef SHADER_PREPROCESSOR_H
+#define SHADER_PREPROCESSOR_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace std;
+
+// A set of #defines a shader is specialized with, e.g. NR_POINT_LIGHTS=8 + BLINN_PHONG=1.
+// Every distinct set is its own shader variant (permutation) with its own GL program, so code the
+// variant doesn't need is removed by the GLSL preprocessor instead of being branched over at runtime.
+class ShaderDefines
+{
+public:
+    ShaderDefines &set(const string &name, const string &value = "1");
+    ShaderDefines &set(const string &name, int value);
+    bool empty() const;
+
+    // Canonical text for the set ("BLINN_PHONG=1;NR_POINT_LIGHTS=8"), used to key variants
+    string key() const;
+    // The set as GLSL #define lines
+    string glsl() const;
+
+private:
+    // Ordered so the same defines always give the same key
+    map<string, string> values;
+};
+
+struct PreprocessedShader
+{
+    string source;
+    // Every file that went into the source, index = GLSL source string number in compiler errors
+    vector<string> files;
+};
+
+// Reads a shader, resolves #include "file" (relative to the including file, each file is included once)
+// and injects the defines right after #version.
+// #line directives are emitted so compiler errors read <file index>(<line>) against the original files.
+// Returns false if a file couldn't be read.
+bool preprocess_shader(const string &path, const ShaderDefines &defines, PreprocessedShader &result);
+
+#endif
@@ -0,0 +1,232 @@
+#include "shadow_cascades.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <string>
+#include <iostream>
+
+using namespace std;
+
+// Split positions: 0 = even slices, 1 = every slice a constant factor deeper than the last.
+// In between keeps the near cascades small (sharp) without starving the far ones
+static const float SPLIT_BLEND = 0.75f;
+// Cached cascades cover this much more than their slice, so the camera can move a bit before they're redrawn
+static const float CACHE_MARGIN = 0.25f;
+
+ShadowCascades::ShadowCascades() : shadowDistance(50.0f), cascadesRendered(0), castersDrawn(0),
+                                   lightDirection(0.0f), cameraForward(0.0f, 0.0f, -1.0f), castersHash(0)
+{
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+    {
+        cascades[i].split = 0.0f;
+        cascades[i].center = glm::vec3(0.0f);
+        cascades[i].radius = 0.0f;
+        cascades[i].lightSpace = glm::mat4(1.0f);
+        cascades[i].texelSize = 0.0f;
+        cascades[i].valid = false;
+        cascades[i].dirty = false;
+    }
+
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, depthTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, SHADOW_CASCADES, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    // Linear + compare = the hardware does a 2x2 PCF per lookup
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    // Outside the map counts as lit
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    float border[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0, 0);
+    // Depth only, no color buffer to draw to
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::SHADOW_CASCADES:: Framebuffer is not complete!" << std::endl;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+ShadowCascades::~ShadowCascades()
+{
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &depthTexture);
+}
+
+void ShadowCascades::invalidate()
+{
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+        cascades[i].valid = false;
+}
+
+unsigned int ShadowCascades::texture() const
+{
+    return depthTexture;
+}
+
+// FNV-1a over the caster spheres, a change means cached cascades are out of date
+static unsigned long long hash_casters(const vector<ShadowCaster> &casters)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    const unsigned char *bytes = casters.empty() ? NULL : (const unsigned char *)casters.data();
+    for (size_t i = 0; i < casters.size() * sizeof(ShadowCaster); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static glm::mat4 light_rotation(const glm::vec3 &lightDirection)
+{
+    // Any up vector works as long as it isn't parallel to the light
+    glm::vec3 up = fabs(lightDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    return glm::lookAt(glm::vec3(0.0f), lightDirection, up);
+}
+
+void ShadowCascades::fit(Cascade &cascade, const glm::vec3 &center, float radius)
+{
+    glm::mat4 rotation = light_rotation(lightDirection);
+    glm::vec3 lightCenter = glm::vec3(rotation * glm::vec4(center, 1.0f));
+    // Only ever move the projection by whole texels, otherwise every shadow edge crawls as the camera moves
+    float texelSize = 2.0f * radius / SHADOW_MAP_SIZE;
+    lightCenter.x = floor(lightCenter.x / texelSize) * texelSize;
+    lightCenter.y = floor(lightCenter.y / texelSize) * texelSize;
+    // The light looks down -z. Casters between the light and the near plane still land in the map
+    // because depth clamping is on while drawing it
+    glm::mat4 projection = glm::ortho(lightCenter.x - radius, lightCenter.x + radius, lightCenter.y - radius, lightCenter.y + radius,
+                                      -lightCenter.z - radius, -lightCenter.z + radius);
+    cascade.center = center;
+    cascade.radius = radius;
+    cascade.texelSize = texelSize;
+    cascade.lightSpace = projection * rotation;
+    cascade.dirty = true;
+}
+
+void ShadowCascades::cull(Cascade &cascade, const vector<ShadowCaster> &casters)
+{
+    cascade.casters.clear();
+    for (size_t i = 0; i < casters.size(); i++)
+    {
+        // The projection is a cube of 2 * radius, so the caster's radius in clip space is just radius / cascade radius
+        glm::vec4 clip = cascade.lightSpace * glm::vec4(casters[i].center, 1.0f);
+        float extent = 1.0f + casters[i].radius / cascade.radius;
+        // Anything in front of the near plane can still cast into the cascade, only cull what's behind it
+        if (fabs(clip.x) > extent || fabs(clip.y) > extent || clip.z > extent)
+            continue;
+        cascade.casters.push_back(i);
+    }
+}
+
+void ShadowCascades::update(const glm::mat4 &view, float fieldOfView, float aspect, float nearPlane,
+                            const glm::vec3 &lightDirection, const vector<ShadowCaster> &casters)
+{
+    glm::vec3 direction = glm::normalize(lightDirection);
+    unsigned long long hash = hash_casters(casters);
+    if (direction != this->lightDirection || hash != castersHash)
+        invalidate();
+    this->lightDirection = direction;
+    castersHash = hash;
+
+    glm::mat4 cameraToWorld = glm::inverse(view);
+    cameraForward = -glm::vec3(cameraToWorld[2]);
+    float scaleY = tan(glm::radians(fieldOfView) * 0.5f);
+    float scaleX = scaleY * aspect;
+
+    cascadesRendered = 0;
+    castersDrawn = 0;
+    float sliceNear = nearPlane;
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+    {
+        Cascade &cascade = cascades[i];
+        float fraction = (float)(i + 1) / SHADOW_CASCADES;
+        float evenSplit = nearPlane + (shadowDistance - nearPlane) * fraction;
+        float logSplit = nearPlane * pow(shadowDistance / nearPlane, fraction);
+        float sliceFar = evenSplit + (logSplit - evenSplit) * SPLIT_BLEND;
+        cascade.split = sliceFar;
+
+        // Bounding sphere of the slice's 8 corners
+        glm::vec3 corners[8];
+        glm::vec3 center = glm::vec3(0.0f);
+        for (int corner = 0; corner < 8; corner++)
+        {
+            float depth = corner < 4 ? sliceNear : sliceFar;
+            float x = (corner & 1) ? scaleX : -scaleX;
+            float y = (corner & 2) ? scaleY : -scaleY;
+            corners[corner] = glm::vec3(cameraToWorld * glm::vec4(x * depth, y * depth, -depth, 1.0f));
+            center += corners[corner] / 8.0f;
+        }
+        float radius = 0.0f;
+        for (int corner = 0; corner < 8; corner++)
+            radius = max(radius, glm::length(corners[corner] - center));
+        // Rounded up so the size (+ the texel size) doesn't jitter w/ float error as the camera turns
+        radius = ceil(radius * 16.0f) / 16.0f;
+        sliceNear = sliceFar;
+
+        if (i < SHADOW_FIRST_CACHED_CASCADE)
+            fit(cascade, center, radius);
+        else if (!cascade.valid || glm::length(center - cascade.center) + radius > cascade.radius)
+            fit(cascade, center, radius * (1.0f + CACHE_MARGIN));
+        else
+            cascade.dirty = false;
+
+        if (cascade.dirty)
+            cull(cascade, casters);
+    }
+}
+
+void ShadowCascades::render(Shader &shader, const function<void(size_t)> &drawCaster)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+    glEnable(GL_DEPTH_CLAMP);
+    // Slope scaled bias on top of the normal offset in the shader
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(1.0f, 1.0f);
+    shader.use();
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+    {
+        Cascade &cascade = cascades[i];
+        if (!cascade.dirty)
+            continue;
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0, i);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        shader.setMat4("lightSpace", cascade.lightSpace);
+        for (size_t j = 0; j < cascade.casters.size(); j++)
+            drawCaster(cascade.casters[j]);
+        cascade.valid = true;
+        cascade.dirty = false;
+        cascadesRendered++;
+        castersDrawn += (unsigned int)cascade.casters.size();
+    }
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_DEPTH_CLAMP);
+}
+
+void ShadowCascades::bind(Shader &shader) const
+{
+    glActiveTexture(GL_TEXTURE0 + SHADOW_MAP_UNIT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, depthTexture);
+    glActiveTexture(GL_TEXTURE0);
+    shader.setInt("shadowMap", SHADOW_MAP_UNIT);
+    shader.setVec3("shadowCameraForward", cameraForward);
+
+    // Clip space (-1 to 1) -> texture space (0 to 1)
+    glm::mat4 bias = glm::translate(glm::mat4(1.0f), glm::vec3(0.5f)) * glm::scale(glm::mat4(1.0f), glm::vec3(0.5f));
+    for (int i = 0; i < SHADOW_CASCADES; i++)
+    {
+        string index = "[" + to_string(i) + "]";
+        shader.setMat4("shadowMatrices" + index, bias * cascades[i].lightSpace);
+        shader.setFloat("shadowSplits" + index, cascades[i].split);
+        shader.setFloat("shadowTexelSizes" + index, cascades[i].texelSize);
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef SHADOW_CASCADES_H
+#define SHADOW_CASCADES_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "shader.h"
+
+using namespace std;
+
+// Cascades the view is split into, nearest first (has to match SHADOW_CASCADES in shaders/include/shadows.glsl)
+const int SHADOW_CASCADES = 4;
+// Cascades from this one on are cached: only redrawn when the view leaves the area they cover or casters change
+const int SHADOW_FIRST_CACHED_CASCADE = 2;
+// Width + height of every layer of the shadow map
+const int SHADOW_MAP_SIZE = 2048;
+// Texture unit the lighting shaders read the shadow map from
+const int SHADOW_MAP_UNIT = 11;
+
+// World space bounding sphere of something that casts a shadow
+struct ShadowCaster
+{
+    glm::vec3 center;
+    float radius;
+};
+
+// Cascaded shadow maps for one directional light, all cascades are layers of one depth texture array.
+// The view frustum (up to shadowDistance) is split into SHADOW_CASCADES slices, each slice gets an orthographic
+// projection from the light that covers its bounding sphere, snapped to whole texels so edges don't shimmer
+// while the camera moves. Casters are culled per cascade on the CPU.
+// Usage per frame: update(), render() (draws whatever is out of date), then bind() on the lighting shaders
+class ShadowCascades
+{
+public:
+    // How far from the camera shadows reach
+    float shadowDistance;
+    // Stats of the last update()
+    int cascadesRendered;
+    unsigned int castersDrawn;
+
+    ShadowCascades();
+    ~ShadowCascades();
+
+    // Fits the cascades to the camera (view matrix + projection) and decides which ones need redrawing
+    void update(const glm::mat4 &view, float fieldOfView, float aspect, float nearPlane,
+                const glm::vec3 &lightDirection, const vector<ShadowCaster> &casters);
+    // Draws the casters of every cascade that needs it, drawCaster(i) draws casters[i] w/ the shader in use.
+    // shader gets the cascade's matrix as "lightSpace". Changes the framebuffer + viewport
+    void render(Shader &shader, const function<void(size_t)> &drawCaster);
+    // Shadow map + cascade uniforms for shaders/include/shadows.glsl
+    void bind(Shader &shader) const;
+    // Forces every cascade to be redrawn next frame
+    void invalidate();
+    // The depth texture array, one layer per cascade
+    unsigned int texture() const;
+
+private:
+    struct Cascade
+    {
+        // View depth where the cascade ends
+        float split;
+        // Sphere (world space) the cached projection covers
+        glm::vec3 center;
+        float radius;
+        glm::mat4 lightSpace;
+        float texelSize;
+        bool valid;
+        bool dirty;
+        vector<size_t> casters;
+    };
+    Cascade cascades[SHADOW_CASCADES];
+    unsigned int fbo;
+    unsigned int depthTexture;
+    glm::vec3 lightDirection;
+    glm::vec3 cameraForward;
+    unsigned long long castersHash;
+
+    // Light space projection that covers the sphere (center, radius)
+    void fit(Cascade &cascade, const glm::vec3 &center, float radius);
+    void cull(Cascade &cascade, const vector<ShadowCaster> &casters);
+
+    ShadowCascades(const ShadowCascades &);
+    ShadowCascades &operator=(const ShadowCascades &);
+};
+
+#endif
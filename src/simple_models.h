@@ -24,7 +24,8 @@ Mesh generate_plane(Texture texture)
     return Mesh(vertices, indices, {texture});
 }
 
-int generateQuadVAO()
+// vbo = the buffer behind it, for deleting both
+int generateQuadVAO(unsigned int &vbo)
 {
     float quadVertices[] = {// vertex attributes for a quad that fills the entire screen in Normalized Device Coordinates.
                             // positions   // texCoords
@@ -46,10 +47,11 @@ int generateQuadVAO()
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)(2 * sizeof(float)));
+    vbo = quadVBO;
     return quadVAO;
 }
 
-int generate_skybox_vao()
+int generate_skybox_vao(unsigned int &vbo)
 {
     float skyboxVertices[] = {
         // positions
@@ -103,10 +105,11 @@ int generate_skybox_vao()
     glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+    vbo = skyboxVBO;
     return skyboxVAO;
 }
 
-unsigned int generate_cube_vao()
+unsigned int generate_cube_vao(unsigned int &vbo)
 {
     float cubeVertices[] = {
         // positions          // normals
@@ -162,6 +165,7 @@ unsigned int generate_cube_vao()
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
+    vbo = cubeVBO;
     return cubeVAO;
 }
 
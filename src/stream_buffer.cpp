@@ -0,0 +1,173 @@
+#include "stream_buffer.h"
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// Regions are kept a multiple of this, it covers every uniform buffer offset alignment seen in practice
+static const size_t REGION_ALIGNMENT = 256;
+
+StreamBuffer::StreamBuffer(size_t frameCapacity) : bytesStreamed(0), frameBytes(0), fenceWaits(0), fenceWaitMilliseconds(0.0),
+                                                   growCount(0), mapped(false), buffer(0), regionSize(0), region(0), head(0), flushed(0), memory(NULL)
+{
+    for (unsigned int i = 0; i < FRAMES_IN_FLIGHT; i++)
+        fences[i] = NULL;
+    create(frameCapacity);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (unsigned int i = 0; i < FRAMES_IN_FLIGHT; i++)
+    {
+        if (fences[i] != NULL)
+            glDeleteSync(fences[i]);
+    }
+    if (!retired.empty())
+        glDeleteBuffers((GLsizei)retired.size(), retired.data());
+    // Deleting a mapped buffer unmaps it
+    glDeleteBuffers(1, &buffer);
+}
+
+bool StreamBuffer::persistent() const
+{
+    return mapped;
+}
+
+size_t StreamBuffer::capacity() const
+{
+    return regionSize;
+}
+
+void StreamBuffer::create(size_t frameCapacity)
+{
+    regionSize = max((frameCapacity + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT, REGION_ALIGNMENT);
+    // Buffers don't have a type, the copy binding just doesn't disturb any binding draws use
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    mapped = false;
+    memory = NULL;
+    if (GLAD_GL_ARB_buffer_storage)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        size_t size = regionSize * FRAMES_IN_FLIGHT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, size, NULL, flags);
+        memory = (unsigned char *)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags);
+        mapped = memory != NULL;
+        if (!mapped)
+        {
+            // Storage is immutable, start over w/ a buffer for the orphaning path
+            std::cout << "ERROR::STREAM_BUFFER::MAP_FAILED falling back to orphaning" << std::endl;
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        }
+    }
+    if (!mapped)
+    {
+        glBufferData(GL_COPY_WRITE_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+        shadow.resize(regionSize);
+        memory = shadow.data();
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    head = mapped ? region * regionSize : 0;
+    flushed = head;
+}
+
+void StreamBuffer::waitForRegion()
+{
+    GLsync &fence = fences[region];
+    if (fence == NULL)
+        return;
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED)
+    {
+        // The GPU is still FRAMES_IN_FLIGHT frames behind, nothing to do but wait for it
+        fenceWaits++;
+        chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+        while (status == GL_TIMEOUT_EXPIRED)
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        fenceWaitMilliseconds += chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+    }
+    glDeleteSync(fence);
+    fence = NULL;
+}
+
+void StreamBuffer::beginFrame()
+{
+    frameBytes = 0;
+    if (mapped)
+    {
+        waitForRegion();
+        head = region * regionSize;
+    }
+    else
+    {
+        // Orphan: the driver hands out new storage while last frame's draws still read the old one
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, regionSize, NULL, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        head = 0;
+    }
+    flushed = head;
+}
+
+StreamAllocation StreamBuffer::allocate(size_t bytes, size_t alignment)
+{
+    size_t offset = (head + alignment - 1) / alignment * alignment;
+    size_t regionEnd = (mapped ? region * regionSize : 0) + regionSize;
+    if (offset + bytes > regionEnd)
+    {
+        // Doesn't fit, switch to a bigger buffer. Whatever this frame allocated so far stays in the old one
+        flush();
+        retired.push_back(buffer);
+        for (unsigned int i = 0; i < FRAMES_IN_FLIGHT; i++)
+        {
+            if (fences[i] != NULL)
+                glDeleteSync(fences[i]);
+            fences[i] = NULL;
+        }
+        growCount++;
+        create(max(regionSize * 2, bytes + alignment));
+        offset = (head + alignment - 1) / alignment * alignment;
+    }
+    head = offset + bytes;
+    frameBytes += bytes;
+
+    StreamAllocation allocation;
+    allocation.buffer = buffer;
+    allocation.offset = offset;
+    allocation.data = memory + offset;
+    return allocation;
+}
+
+void StreamBuffer::flush()
+{
+    if (mapped || head <= flushed)
+        return;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, flushed, head - flushed, memory + flushed);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    flushed = head;
+}
+
+void StreamBuffer::endFrame()
+{
+    flush();
+    if (mapped)
+    {
+        // Signaled once the GPU is done w/ every command so far, i.e. this frame's reads of the region
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        region = (region + 1) % FRAMES_IN_FLIGHT;
+    }
+    // The driver keeps their storage until the GPU is done w/ it
+    if (!retired.empty())
+    {
+        glDeleteBuffers((GLsizei)retired.size(), retired.data());
+        retired.clear();
+    }
+    bytesStreamed += frameBytes;
+}
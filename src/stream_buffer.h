@@ -0,0 +1,77 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Where an allocation ended up: bind buffer at offset (glBindBufferRange, glVertexAttribPointer...)
+// and write the data to data
+struct StreamAllocation
+{
+    unsigned int buffer;
+    size_t offset;
+    unsigned char *data;
+};
+
+// Ring buffer for data that's rewritten every frame (object transforms, uniform blocks, transient geometry).
+// Allocations are plain memory to memcpy into, the GPU reads them straight from the buffer.
+// With GL_ARB_buffer_storage the buffer stays mapped (persistent + coherent) and is split into one region
+// per frame in flight: a fence at the end of every frame tells when the GPU is done w/ that frame's region,
+// so it's only reused then instead of the driver having to guess (+ stall).
+// On plain GL 3.3 the data is kept in memory, the buffer is orphaned every frame + flush() uploads it.
+// Usage per frame: beginFrame(), allocate() + write, flush() before drawing w/ it, endFrame() after the last draw
+class StreamBuffer
+{
+public:
+    static const unsigned int FRAMES_IN_FLIGHT = 3;
+
+    // Bytes allocated over every frame so far, and in the last finished frame
+    unsigned long long bytesStreamed;
+    size_t frameBytes;
+    // Frames that had to wait for the GPU to finish with their region, + how long they waited in total
+    unsigned int fenceWaits;
+    double fenceWaitMilliseconds;
+    // Times a frame didn't fit + the buffer was replaced by a bigger one
+    unsigned int growCount;
+
+    // frameCapacity = bytes one frame can use before the buffer has to grow
+    explicit StreamBuffer(size_t frameCapacity = 256 * 1024);
+    ~StreamBuffer();
+
+    // Persistently mapped (GL_ARB_buffer_storage) or orphaned every frame
+    bool persistent() const;
+    size_t capacity() const;
+    void beginFrame();
+    // data is only valid until the next allocate() or flush()
+    StreamAllocation allocate(size_t bytes, size_t alignment = 16);
+    // Makes everything allocated so far visible to the GPU (nothing to do when persistently mapped)
+    void flush();
+    void endFrame();
+
+private:
+    bool mapped;
+    unsigned int buffer;
+    size_t regionSize;
+    unsigned int region;
+    // Next free byte + what flush() uploaded up to, absolute offsets in the buffer
+    size_t head;
+    size_t flushed;
+    unsigned char *memory;
+    // What the GPU reads, when not mapped
+    vector<unsigned char> shadow;
+    GLsync fences[FRAMES_IN_FLIGHT];
+    // Outgrown buffers, this frame's draws may still bind them
+    vector<unsigned int> retired;
+
+    void create(size_t frameCapacity);
+    void waitForRegion();
+
+    StreamBuffer(const StreamBuffer &);
+    StreamBuffer &operator=(const StreamBuffer &);
+};
+
+#endif
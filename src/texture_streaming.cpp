@@ -0,0 +1,280 @@
+#include "texture_streaming.h"
+#include <glad/glad.h>
+
+#include "texture_uploader.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+void build_mip_chain(const unsigned char *pixels, int width, int height, int components, bool flipVertically, TextureMipChain &chain)
+{
+    chain.width = width;
+    chain.height = height;
+    chain.components = components;
+    chain.levels.clear();
+
+    size_t rowBytes = (size_t)width * components;
+    chain.levels.push_back(vector<unsigned char>(rowBytes * height));
+    unsigned char *base = chain.levels[0].data();
+    for (int y = 0; y < height; y++)
+        memcpy(base + rowBytes * y, pixels + rowBytes * (flipVertically ? height - 1 - y : y), rowBytes);
+
+    while (width > 1 || height > 1)
+    {
+        int nextWidth = max(width / 2, 1);
+        int nextHeight = max(height / 2, 1);
+        vector<unsigned char> next((size_t)nextWidth * nextHeight * components);
+        const unsigned char *source = chain.levels.back().data();
+        for (int y = 0; y < nextHeight; y++)
+        {
+            // Odd sizes + 1 pixel wide levels just reuse the last row/column
+            int y0 = min(y * 2, height - 1), y1 = min(y * 2 + 1, height - 1);
+            for (int x = 0; x < nextWidth; x++)
+            {
+                int x0 = min(x * 2, width - 1), x1 = min(x * 2 + 1, width - 1);
+                for (int c = 0; c < components; c++)
+                {
+                    int sum = source[((size_t)y0 * width + x0) * components + c] + source[((size_t)y0 * width + x1) * components + c] +
+                              source[((size_t)y1 * width + x0) * components + c] + source[((size_t)y1 * width + x1) * components + c];
+                    next[((size_t)y * nextWidth + x) * components + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        chain.levels.push_back(next);
+        width = nextWidth;
+        height = nextHeight;
+    }
+}
+
+int streaming_tail_level(int width, int height)
+{
+    int level = 0;
+    while (max(width >> level, height >> level) > STREAMING_RESIDENT_SIZE)
+        level++;
+    return level;
+}
+
+GLenum texture_format(int components)
+{
+    switch (components)
+    {
+    case 1:
+        return GL_RED;
+    case 2:
+        return GL_RG;
+    case 3:
+        return GL_RGB;
+    default:
+        return GL_RGBA;
+    }
+}
+
+GLenum texture_internal_format(int components)
+{
+    switch (components)
+    {
+    case 1:
+        return GL_R8;
+    case 2:
+        return GL_RG8;
+    case 3:
+        return GL_RGB8;
+    default:
+        return GL_RGBA8;
+    }
+}
+
+TextureStreamer::TextureStreamer() : budgetBytes(256 * 1024 * 1024), residentBytes(0), pendingRequests(0), levelsStreamed(0), levelsEvicted(0),
+                                     nextGeneration(0), frame(0), uploadsInFlight(0)
+{
+}
+
+size_t TextureStreamer::levelBytes(const StreamedTexture &texture, int level)
+{
+    return texture.chain.levels[level].size();
+}
+
+void TextureStreamer::add(unsigned int texture, TextureMipChain &chain)
+{
+    lock_guard<mutex> lock(texturesMutex);
+    // GL hands out the ids of deleted textures again
+    map<unsigned int, StreamedTexture>::iterator existing = textures.find(texture);
+    if (existing != textures.end())
+        forget(existing);
+    StreamedTexture &streamed = textures[texture];
+    streamed.chain.width = chain.width;
+    streamed.chain.height = chain.height;
+    streamed.chain.components = chain.components;
+    streamed.chain.levels.swap(chain.levels);
+    streamed.tailLevel = streaming_tail_level(chain.width, chain.height);
+    streamed.baseLevel = streamed.tailLevel;
+    streamed.wantedLevel = streamed.tailLevel;
+    streamed.requestedLevel = INT_MAX;
+    // Never used yet: it may come from the loader thread, nothing may touch it before the renderer draws w/ it
+    streamed.lastUsed = 0;
+    streamed.uploading = false;
+    streamed.generation = nextGeneration++;
+    for (size_t level = streamed.tailLevel; level < streamed.chain.levels.size(); level++)
+        residentBytes += levelBytes(streamed, (int)level);
+}
+
+void TextureStreamer::remove(unsigned int texture)
+{
+    lock_guard<mutex> lock(texturesMutex);
+    map<unsigned int, StreamedTexture>::iterator it = textures.find(texture);
+    if (it != textures.end())
+        forget(it);
+}
+
+void TextureStreamer::forget(map<unsigned int, StreamedTexture>::iterator it)
+{
+    StreamedTexture &streamed = it->second;
+    // The level in flight was counted when it started
+    int first = streamed.uploading ? streamed.baseLevel - 1 : streamed.baseLevel;
+    for (size_t level = first; level < streamed.chain.levels.size(); level++)
+        residentBytes -= levelBytes(streamed, (int)level);
+    // Its pixels have to stay until the upload's copy is done, levelUploaded() frees them
+    if (streamed.uploading)
+        retiredLevels[streamed.generation].swap(streamed.chain.levels);
+    textures.erase(it);
+}
+
+void TextureStreamer::request(unsigned int texture, float uvPerPixel)
+{
+    lock_guard<mutex> lock(texturesMutex);
+    map<unsigned int, StreamedTexture>::iterator it = textures.find(texture);
+    if (it == textures.end())
+        return;
+    StreamedTexture &streamed = it->second;
+    // The level where one texel covers about one pixel
+    float texelsPerPixel = max(streamed.chain.width, streamed.chain.height) * uvPerPixel;
+    int level = texelsPerPixel > 1.0f ? (int)floor(log2(texelsPerPixel)) : 0;
+    streamed.requestedLevel = min(streamed.requestedLevel, min(level, streamed.tailLevel));
+}
+
+bool TextureStreamer::evictOne(unsigned int keep)
+{
+    map<unsigned int, StreamedTexture>::iterator victim = textures.end();
+    for (map<unsigned int, StreamedTexture>::iterator it = textures.begin(); it != textures.end(); ++it)
+    {
+        StreamedTexture &streamed = it->second;
+        if (it->first == keep || streamed.uploading || streamed.baseLevel >= streamed.tailLevel)
+            continue;
+        // Levels drawn this frame that are still needed stay, evicting them would only bring them back next frame
+        bool surplus = streamed.baseLevel < streamed.wantedLevel;
+        if (!surplus && streamed.lastUsed == frame)
+            continue;
+        if (victim == textures.end())
+        {
+            victim = it;
+            continue;
+        }
+        const StreamedTexture &best = victim->second;
+        bool bestSurplus = best.baseLevel < best.wantedLevel;
+        if (surplus != bestSurplus ? surplus : streamed.lastUsed < best.lastUsed)
+            victim = it;
+    }
+    if (victim == textures.end())
+        return false;
+
+    StreamedTexture &streamed = victim->second;
+    int level = streamed.baseLevel;
+    streamed.baseLevel++;
+    residentBytes -= levelBytes(streamed, level);
+    levelsEvicted++;
+    GLenum format = texture_format(streamed.chain.components);
+    glBindTexture(GL_TEXTURE_2D, victim->first);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, streamed.baseLevel);
+    // An empty image is the only way to give a level's memory back w/o immutable storage (levels below the base don't count)
+    glTexImage2D(GL_TEXTURE_2D, level, texture_internal_format(streamed.chain.components), 0, 0, 0, format, GL_UNSIGNED_BYTE, NULL);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+void TextureStreamer::update()
+{
+    lock_guard<mutex> lock(texturesMutex);
+    frame++;
+
+    // Most recently used first, then the ones furthest from what they need
+    vector<pair<pair<unsigned long long, int>, unsigned int> > candidates;
+    pendingRequests = 0;
+    for (map<unsigned int, StreamedTexture>::iterator it = textures.begin(); it != textures.end(); ++it)
+    {
+        StreamedTexture &streamed = it->second;
+        if (streamed.requestedLevel != INT_MAX)
+        {
+            streamed.wantedLevel = streamed.requestedLevel;
+            streamed.lastUsed = frame;
+            streamed.requestedLevel = INT_MAX;
+        }
+        if (streamed.lastUsed == 0 || streamed.wantedLevel >= streamed.baseLevel)
+            continue;
+        pendingRequests++;
+        if (!streamed.uploading)
+            candidates.push_back(make_pair(make_pair(streamed.lastUsed, streamed.baseLevel - streamed.wantedLevel), it->first));
+    }
+    sort(candidates.rbegin(), candidates.rend());
+
+    for (size_t i = 0; i < candidates.size() && uploadsInFlight < MAX_UPLOADS_IN_FLIGHT; i++)
+    {
+        unsigned int texture = candidates[i].second;
+        StreamedTexture &streamed = textures[texture];
+        // One level at a time, coarse to fine, every step already looks sharper
+        int level = streamed.baseLevel - 1;
+        size_t bytes = levelBytes(streamed, level);
+        while (residentBytes + bytes > budgetBytes && evictOne(texture))
+            ;
+        if (residentBytes + bytes > budgetBytes)
+            continue;
+
+        residentBytes += bytes;
+        streamed.uploading = true;
+        uploadsInFlight++;
+        int width = max(streamed.chain.width >> level, 1);
+        int height = max(streamed.chain.height >> level, 1);
+        unsigned int generation = streamed.generation;
+        TextureUploader::shared().uploadLevel(texture, level, width, height, streamed.chain.components, streamed.chain.levels[level].data(),
+                                              [this, texture, generation, level]() { levelUploaded(texture, generation, level); });
+    }
+}
+
+void TextureStreamer::levelUploaded(unsigned int texture, unsigned int generation, int level)
+{
+    lock_guard<mutex> lock(texturesMutex);
+    uploadsInFlight--;
+    // Removed while the level was uploading
+    if (retiredLevels.erase(generation) > 0)
+        return;
+    StreamedTexture &streamed = textures[texture];
+    streamed.baseLevel = level;
+    streamed.uploading = false;
+    levelsStreamed++;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+unsigned int TextureStreamer::textureCount() const
+{
+    lock_guard<mutex> lock(texturesMutex);
+    return (unsigned int)textures.size();
+}
+
+const TextureMipChain *TextureStreamer::chain(unsigned int texture) const
+{
+    lock_guard<mutex> lock(texturesMutex);
+    map<unsigned int, StreamedTexture>::const_iterator it = textures.find(texture);
+    return it != textures.end() ? &it->second.chain : NULL;
+}
+
+TextureStreamer &TextureStreamer::shared()
+{
+    static TextureStreamer streamer;
+    return streamer;
+}
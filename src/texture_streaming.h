@@ -0,0 +1,106 @@
+#ifndef TEXTURE_STREAMING_H
+#define TEXTURE_STREAMING_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Mip levels this size (or smaller) are uploaded w/ the texture + never evicted, so every texture always has something to show
+const int STREAMING_RESIDENT_SIZE = 64;
+
+// Every mip level of an image in system memory, level 0 first
+struct TextureMipChain
+{
+    int width;
+    int height;
+    int components;
+    vector<vector<unsigned char> > levels;
+};
+
+// Box filters pixels down to 1x1, flipping them (bottom row first, like OpenGL wants) on the way when asked
+void build_mip_chain(const unsigned char *pixels, int width, int height, int components, bool flipVertically, TextureMipChain &chain);
+// First level of the chain that's resident from the start (see STREAMING_RESIDENT_SIZE)
+int streaming_tail_level(int width, int height);
+// Pixel format + sized internal format (GL_R8 ... GL_RGBA8) of an image w/ this many 8 bit channels,
+// every level of a texture has to use the same ones
+GLenum texture_format(int components);
+GLenum texture_internal_format(int components);
+
+// Keeps only the mip levels textures need on screen in video memory:
+// textures start w/ just their small levels (GL_TEXTURE_BASE_LEVEL clamps sampling to what's there), the renderer
+// requests the level every texture needs each frame (from how big it's drawn + its UV density) and finer levels
+// are streamed in one at a time through the TextureUploader. When they don't fit in budgetBytes, levels nobody needs
+// right now are evicted: first ones finer than their texture needs, then least recently used.
+// The full chain stays in system memory so levels can come back w/o decoding the file again.
+// add() may be called from any thread, everything else belongs to the render thread
+class TextureStreamer
+{
+public:
+    // Level uploads in flight at once
+    static const unsigned int MAX_UPLOADS_IN_FLIGHT = 4;
+
+    size_t budgetBytes;
+    // Bytes of every resident level (as uploaded, the driver may pad them) + textures waiting for a finer level
+    size_t residentBytes;
+    unsigned int pendingRequests;
+    // Levels streamed in + evicted so far
+    unsigned int levelsStreamed;
+    unsigned int levelsEvicted;
+
+    TextureStreamer();
+
+    // Takes over chain (it's left empty), the texture already has levels streaming_tail_level.. uploaded.
+    // Replaces what a deleted texture w/ the same id left behind
+    void add(unsigned int texture, TextureMipChain &chain);
+    // Forgets a texture (+ gives its levels back to the budget), call before deleting a texture that was added
+    void remove(unsigned int texture);
+    // uvPerPixel = how much of the texture's 0-1 UV range one screen pixel covers where it's drawn the closest
+    void request(unsigned int texture, float uvPerPixel);
+    // Once a frame after the requests: starts streaming in levels that were asked for, evicting to stay in budget
+    void update();
+    unsigned int textureCount() const;
+    // Every level of a texture in system memory, NULL until its upload added it. Chains never change after add(),
+    // the pointer stays valid until the texture is removed
+    const TextureMipChain *chain(unsigned int texture) const;
+
+    static TextureStreamer &shared();
+
+private:
+    struct StreamedTexture
+    {
+        TextureMipChain chain;
+        // Levels tailLevel.. are always resident, baseLevel.. are resident now
+        int tailLevel;
+        int baseLevel;
+        // Finest level asked for in the last frame it was used, + this frame's requests
+        int wantedLevel;
+        int requestedLevel;
+        unsigned long long lastUsed;
+        bool uploading;
+        // Tells the level upload in flight which texture it was for, when the id has been removed (+ reused) since
+        unsigned int generation;
+    };
+
+    mutable mutex texturesMutex;
+    map<unsigned int, StreamedTexture> textures;
+    // Levels of removed textures w/ an upload in flight (it copies from them), by generation
+    map<unsigned int, vector<vector<unsigned char> > > retiredLevels;
+    unsigned int nextGeneration;
+    unsigned long long frame;
+    unsigned int uploadsInFlight;
+
+    static size_t levelBytes(const StreamedTexture &texture, int level);
+    bool evictOne(unsigned int keep);
+    void levelUploaded(unsigned int texture, unsigned int generation, int level);
+    void forget(map<unsigned int, StreamedTexture>::iterator it);
+
+    TextureStreamer(const TextureStreamer &);
+    TextureStreamer &operator=(const TextureStreamer &);
+};
+
+#endif
@@ -0,0 +1,403 @@
+#include "texture_uploader.h"
+#include <glad/glad.h>
+
+#include "stb_image.h"
+#include "thread_pool.h"
+
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+// Textures whose load failed, on every thread's uploader
+static mutex failedTexturesMutex;
+static set<unsigned int> failedTextures;
+
+// Copies width * height pixels, bottom row first when flipping
+static void copy_rows(unsigned char *destination, const unsigned char *source, int width, int height, int components, bool flip)
+{
+    size_t rowBytes = (size_t)width * components;
+    if (!flip)
+    {
+        memcpy(destination, source, rowBytes * height);
+        return;
+    }
+    for (int y = 0; y < height; y++)
+        memcpy(destination + rowBytes * y, source + rowBytes * (height - 1 - y), rowBytes);
+}
+
+// Luminance of an rgb pixel, the same weights the G-buffer uses to turn a specular color into one value
+static unsigned char luminance(const unsigned char *pixel)
+{
+    return (unsigned char)(0.2126f * pixel[0] + 0.7152f * pixel[1] + 0.0722f * pixel[2] + 0.5f);
+}
+
+// Drops to one channel (the luminance) in place when the image is grey on average (+ opaque unless its alpha is unused),
+// returns whether it did
+static bool reduce_to_grayscale(unsigned char *pixels, int width, int height, int &components, int tolerance, bool alphaUnused)
+{
+    if (components < 3)
+        return false;
+    size_t count = (size_t)width * height;
+    unsigned long long spread = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        const unsigned char *pixel = pixels + i * components;
+        if (components == 4 && pixel[3] != 255 && !alphaUnused)
+            return false;
+        spread += max(pixel[0], max(pixel[1], pixel[2])) - min(pixel[0], min(pixel[1], pixel[2]));
+    }
+    if (spread > (unsigned long long)tolerance * count)
+        return false;
+    for (size_t i = 0; i < count; i++)
+        pixels[i] = luminance(pixels + i * components);
+    components = 1;
+    return true;
+}
+
+// Writes the grey value of every alpha pixel into the alpha channel of an RGBA image of the same size
+static void pack_alpha(unsigned char *pixels, const unsigned char *alpha, int width, int height, int alphaComponents)
+{
+    size_t count = (size_t)width * height;
+    for (size_t i = 0; i < count; i++)
+    {
+        const unsigned char *source = alpha + i * alphaComponents;
+        pixels[i * 4 + 3] = alphaComponents >= 3 ? luminance(source) : source[0];
+    }
+}
+
+TextureUploader::TextureUploader() : texturesUploaded(0), bytesUploaded(0), synchronousUploads(0), grayscaleTextures(0), packedTextures(0)
+{
+}
+
+TextureUploader::~TextureUploader()
+{
+    for (size_t i = 0; i < uploads.size(); i++)
+    {
+        // Decoded but not copied yet, the other states' pixels are owned by a worker job or already freed
+        if (uploads[i]->state.load() == UPLOAD_DECODED && uploads[i]->ownsPixels)
+            stbi_image_free((void *)uploads[i]->pixels);
+    }
+}
+
+void TextureUploader::load(unsigned int texture, GLenum target, const string &path, bool flipVertically, bool streamMips, const string &alphaPath,
+                           bool alphaUnused)
+{
+    {
+        // The id of a deleted texture, given out again
+        lock_guard<mutex> lock(failedTexturesMutex);
+        failedTextures.erase(texture);
+    }
+    shared_ptr<Upload> upload(new Upload());
+    upload->state = UPLOAD_DECODING;
+    upload->texture = texture;
+    upload->target = target;
+    upload->level = 0;
+    upload->path = path;
+    upload->alphaPath = alphaPath;
+    upload->alphaUnused = alphaUnused;
+    upload->flipVertically = flipVertically;
+    upload->streamMips = streamMips;
+    upload->width = 0;
+    upload->height = 0;
+    upload->components = 0;
+    upload->pixels = NULL;
+    upload->ownsPixels = true;
+    upload->levelsPending = 0;
+    upload->pixelBuffer = -1;
+    upload->mapped = NULL;
+    uploads.push_back(upload);
+    if (!alphaPath.empty())
+        packedTextures++;
+
+    ThreadPool::shared().submit([upload]() {
+        bool packed = !upload->alphaPath.empty();
+        unsigned char *pixels = stbi_load(upload->path.c_str(), &upload->width, &upload->height, &upload->components, packed ? 4 : 0);
+        if (pixels != NULL && packed)
+        {
+            upload->components = 4;
+            int width, height, components;
+            unsigned char *alpha = stbi_load(upload->alphaPath.c_str(), &width, &height, &components, 0);
+            if (alpha != NULL && width == upload->width && height == upload->height)
+                pack_alpha(pixels, alpha, width, height, components);
+            else
+                std::cout << "ERROR::TEXTURE_UPLOADER::PACK_FAILED " << upload->alphaPath << " doesn't match " << upload->path << std::endl;
+            stbi_image_free(alpha);
+        }
+        else if (pixels != NULL && upload->streamMips)
+            reduce_to_grayscale(pixels, upload->width, upload->height, upload->components, GRAYSCALE_TOLERANCE, upload->alphaUnused);
+        if (pixels != NULL && upload->streamMips)
+        {
+            // The chain is what gets uploaded + streamed from, the flip happens while building it
+            build_mip_chain(pixels, upload->width, upload->height, upload->components, upload->flipVertically, upload->chain);
+            stbi_image_free(pixels);
+            upload->state = UPLOAD_DECODED;
+            return;
+        }
+        upload->pixels = pixels;
+        upload->state = pixels != NULL ? UPLOAD_DECODED : UPLOAD_FAILED;
+    });
+}
+
+void TextureUploader::uploadLevel(unsigned int texture, int level, int width, int height, int components, const unsigned char *pixels,
+                                  const function<void()> &uploaded)
+{
+    shared_ptr<Upload> upload(new Upload());
+    // Nothing to decode, straight to the copy into a PBO
+    upload->state = UPLOAD_DECODED;
+    upload->texture = texture;
+    upload->target = GL_TEXTURE_2D;
+    upload->level = level;
+    upload->flipVertically = false;
+    upload->streamMips = false;
+    upload->width = width;
+    upload->height = height;
+    upload->components = components;
+    upload->pixels = pixels;
+    upload->ownsPixels = false;
+    upload->alphaUnused = false;
+    upload->levelsPending = 0;
+    upload->pixelBuffer = -1;
+    upload->mapped = NULL;
+    upload->uploaded = uploaded;
+    uploads.push_back(upload);
+}
+
+int TextureUploader::acquirePixelBuffer(size_t bytes)
+{
+    for (size_t i = 0; i < pixelBuffers.size(); i++)
+    {
+        PixelBuffer &pixelBuffer = pixelBuffers[i];
+        if (pixelBuffer.busy)
+            continue;
+        if (pixelBuffer.fence != NULL)
+        {
+            // Still being copied to a texture
+            if (glClientWaitSync(pixelBuffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED)
+                continue;
+            glDeleteSync(pixelBuffer.fence);
+            pixelBuffer.fence = NULL;
+        }
+        if (pixelBuffer.size < bytes)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer.buffer);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            pixelBuffer.size = bytes;
+        }
+        pixelBuffer.busy = true;
+        return (int)i;
+    }
+    if (pixelBuffers.size() >= MAX_PIXEL_BUFFERS)
+        return -1;
+
+    PixelBuffer pixelBuffer;
+    glGenBuffers(1, &pixelBuffer.buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer.buffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    pixelBuffer.size = bytes;
+    pixelBuffer.fence = NULL;
+    pixelBuffer.busy = true;
+    pixelBuffers.push_back(pixelBuffer);
+    return (int)pixelBuffers.size() - 1;
+}
+
+void TextureUploader::startCopy(const shared_ptr<Upload> &upload)
+{
+    size_t bytes = (size_t)upload->width * upload->height * upload->components;
+    int index = acquirePixelBuffer(bytes);
+    // Every PBO is in use, try again next update
+    if (index < 0)
+        return;
+
+    PixelBuffer &pixelBuffer = pixelBuffers[index];
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer.buffer);
+    // Whatever was in it has been copied to its texture (see the fence), no need to keep it
+    upload->mapped = (unsigned char *)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    if (upload->mapped == NULL)
+    {
+        pixelBuffer.busy = false;
+        uploadFromClientMemory(*upload);
+        return;
+    }
+    upload->pixelBuffer = index;
+    upload->state = UPLOAD_COPYING;
+    ThreadPool::shared().submit([upload]() {
+        copy_rows(upload->mapped, upload->pixels, upload->width, upload->height, upload->components, upload->flipVertically);
+        if (upload->ownsPixels)
+            stbi_image_free((void *)upload->pixels);
+        upload->pixels = NULL;
+        upload->state = UPLOAD_COPIED;
+    });
+}
+
+void TextureUploader::uploadFromClientMemory(Upload &upload)
+{
+    std::cout << "ERROR::TEXTURE_UPLOADER::MAP_FAILED uploading " << upload.path << " from client memory" << std::endl;
+    size_t bytes = (size_t)upload.width * upload.height * upload.components;
+    vector<unsigned char> pixels(bytes);
+    copy_rows(pixels.data(), upload.pixels, upload.width, upload.height, upload.components, upload.flipVertically);
+    if (upload.ownsPixels)
+        stbi_image_free((void *)upload.pixels);
+    upload.pixels = NULL;
+    upload.mapped = pixels.data();
+    finishUpload(upload);
+    upload.mapped = NULL;
+    synchronousUploads++;
+}
+
+void TextureUploader::finishUpload(Upload &upload)
+{
+    GLenum binding = upload.target == GL_TEXTURE_2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP;
+    GLenum format = texture_format(upload.components);
+    const void *source = upload.mapped;
+    if (upload.pixelBuffer >= 0)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[upload.pixelBuffer].buffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        // Offset into the bound PBO
+        source = NULL;
+    }
+
+    glBindTexture(binding, upload.texture);
+    // Rows are tightly packed, 1 + 3 channel images rarely have rows that are a multiple of 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // Allocates + fills the level in one go: w/ a PBO bound even a NULL source is a transfer (from offset 0)
+    glTexImage2D(upload.target, upload.level, texture_internal_format(upload.components), upload.width, upload.height, 0, format, GL_UNSIGNED_BYTE,
+                 source);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(binding, 0);
+
+    if (upload.pixelBuffer >= 0)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        PixelBuffer &pixelBuffer = pixelBuffers[upload.pixelBuffer];
+        pixelBuffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        pixelBuffer.busy = false;
+        upload.pixelBuffer = -1;
+        upload.mapped = NULL;
+    }
+    upload.state = UPLOAD_DONE;
+    // Single levels (uploadLevel) are part of a texture counted elsewhere
+    if (!upload.uploaded)
+        texturesUploaded++;
+    bytesUploaded += (unsigned long long)upload.width * upload.height * upload.components;
+    if (upload.uploaded)
+        upload.uploaded();
+}
+
+void TextureUploader::uploadResidentLevels(const shared_ptr<Upload> &upload)
+{
+    TextureMipChain &chain = upload->chain;
+    int tail = streaming_tail_level(chain.width, chain.height);
+    int last = (int)chain.levels.size() - 1;
+    glBindTexture(GL_TEXTURE_2D, upload->texture);
+    // Sampling stays within the levels that are there
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, tail);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, last);
+    if (chain.components == 1)
+    {
+        // Grey in rgb (+ opaque, the default alpha) like the image it came from
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+        grayscaleTextures++;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Through the PBOs like any other upload, the chain stays w/ this upload until the last level is in
+    upload->state = UPLOAD_LEVELS;
+    upload->levelsPending = last - tail + 1;
+    for (int level = tail; level <= last; level++)
+    {
+        uploadLevel(upload->texture, level, max(chain.width >> level, 1), max(chain.height >> level, 1), chain.components,
+                    chain.levels[level].data(), [this, upload]() {
+                        if (--upload->levelsPending > 0)
+                            return;
+                        TextureStreamer::shared().add(upload->texture, upload->chain);
+                        upload->state = UPLOAD_DONE;
+                        texturesUploaded++;
+                    });
+    }
+}
+
+void TextureUploader::update()
+{
+    for (size_t i = 0; i < uploads.size();)
+    {
+        // A copy, uploadResidentLevels adds uploads
+        shared_ptr<Upload> current = uploads[i];
+        Upload &upload = *current;
+        int state = upload.state.load();
+        if (state == UPLOAD_DECODED && upload.streamMips)
+            uploadResidentLevels(current);
+        else if (state == UPLOAD_DECODED)
+            startCopy(current);
+        else if (state == UPLOAD_COPIED)
+            finishUpload(upload);
+
+        state = upload.state.load();
+        if (state == UPLOAD_FAILED)
+        {
+            std::cout << "Texture failed to load at path: " << upload.path << std::endl;
+            lock_guard<mutex> lock(failedTexturesMutex);
+            failedTextures.insert(upload.texture);
+        }
+        if (state == UPLOAD_DONE || state == UPLOAD_FAILED)
+            uploads.erase(uploads.begin() + i);
+        else
+            i++;
+    }
+}
+
+void TextureUploader::finish()
+{
+    while (!uploads.empty())
+    {
+        update();
+        if (!uploads.empty())
+            this_thread::yield();
+    }
+}
+
+unsigned int TextureUploader::pending() const
+{
+    return (unsigned int)uploads.size();
+}
+
+void TextureUploader::releasePixelBuffers()
+{
+    finish();
+    for (size_t i = 0; i < pixelBuffers.size(); i++)
+    {
+        if (pixelBuffers[i].fence != NULL)
+            glDeleteSync(pixelBuffers[i].fence);
+        glDeleteBuffers(1, &pixelBuffers[i].buffer);
+    }
+    pixelBuffers.clear();
+}
+
+bool TextureUploader::canPackIntoAlpha(const string &path, const string &alphaPath)
+{
+    int width, height, components;
+    int alphaWidth, alphaHeight, alphaComponents;
+    if (!stbi_info(path.c_str(), &width, &height, &components) || !stbi_info(alphaPath.c_str(), &alphaWidth, &alphaHeight, &alphaComponents))
+        return false;
+    return width == alphaWidth && height == alphaHeight;
+}
+
+bool TextureUploader::failed(unsigned int texture)
+{
+    lock_guard<mutex> lock(failedTexturesMutex);
+    return failedTextures.count(texture) > 0;
+}
+
+TextureUploader &TextureUploader::shared()
+{
+    static thread_local TextureUploader uploader;
+    return uploader;
+}
@@ -0,0 +1,134 @@
+#ifndef TEXTURE_UPLOADER_H
+#define TEXTURE_UPLOADER_H
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "texture_streaming.h"
+
+using namespace std;
+
+// Loads image files into textures without blocking the GL thread:
+//   1. a worker decodes the file (stb_image)
+//   2. the GL thread maps a free pixel buffer object (PBO) from a small pool
+//   3. a worker copies the pixels into the mapped PBO (flipping them on the way when asked)
+//   4. the GL thread unmaps it + glTexImage2D's from it, the driver copies to the texture asynchronously
+//      and a fence tells when the PBO can be handed out again
+// The texture id exists straight away, it just samples as black until its upload is done.
+// Textures w/ mipmaps build their mip chain on the worker instead, only the small levels get uploaded
+// (through the PBOs too) + the rest is left to the TextureStreamer (see texture_streaming.h).
+// GL calls only happen in load(), update(), finish() and releasePixelBuffers(), all on the thread that owns the uploader + a context
+class TextureUploader
+{
+public:
+    // PBOs (= uploads between steps 2 + 4) at once
+    static const unsigned int MAX_PIXEL_BUFFERS = 4;
+    // Average difference between a pixel's channels (0-255) that still counts as grey (compression noise, slight tints)
+    static const int GRAYSCALE_TOLERANCE = 8;
+
+    // Textures + bytes uploaded so far, and the uploads that went through client memory because a PBO couldn't be mapped
+    unsigned int texturesUploaded;
+    unsigned long long bytesUploaded;
+    unsigned int synchronousUploads;
+    // Streamed textures stored w/ one channel because they turned out grey, + textures w/ a map packed into their alpha
+    unsigned int grayscaleTextures;
+    unsigned int packedTextures;
+
+    TextureUploader();
+    // GL objects aren't deleted here, the shared uploader outlives the context (see releasePixelBuffers)
+    ~TextureUploader();
+
+    // Starts loading the image at path into target of texture (GL_TEXTURE_2D or a cube map face), returns right away.
+    // streamMips = the GL_TEXTURE_2D gets a mip chain, streamed (the texture's filters are up to the caller).
+    // Streamed images that are grey (see GRAYSCALE_TOLERANCE) + opaque are stored as GL_R8, swizzled so they still
+    // sample as grey rgb. alphaUnused = nothing samples the alpha, it doesn't have to be opaque (it's dropped or replaced).
+    // alphaPath = a scalar map (e.g. specular) of the same size to pack into the alpha channel, streamed textures only
+    void load(unsigned int texture, GLenum target, const string &path, bool flipVertically, bool streamMips, const string &alphaPath = "",
+              bool alphaUnused = false);
+    // Uploads one mip level of a GL_TEXTURE_2D from pixels, which have to stay valid until uploaded() runs (in update())
+    void uploadLevel(unsigned int texture, int level, int width, int height, int components, const unsigned char *pixels,
+                     const function<void()> &uploaded);
+    // Moves every load along as far as it can go without waiting, call once a frame
+    void update();
+    // Blocks until every load so far is done
+    void finish();
+    unsigned int pending() const;
+    // Finishes every load + deletes the PBOs, before the thread's context goes away (e.g. the loader thread's)
+    void releasePixelBuffers();
+
+    // Whether load() can pack alphaPath into path's alpha: both are the same size (path's own alpha, if any, is replaced).
+    // Only reads the image headers
+    static bool canPackIntoAlpha(const string &path, const string &alphaPath);
+    // Whether the last load() into texture failed (missing or unreadable file), on any thread's uploader
+    static bool failed(unsigned int texture);
+
+    // Uploader of the calling thread (TextureFromFile, loadCubemap). Every thread w/ a context has its own,
+    // a load is moved along by the thread that started it
+    static TextureUploader &shared();
+
+private:
+    enum UploadState
+    {
+        UPLOAD_DECODING,
+        UPLOAD_DECODED,
+        UPLOAD_COPYING,
+        UPLOAD_COPIED,
+        // Streamed, waiting for the uploads of its resident levels
+        UPLOAD_LEVELS,
+        UPLOAD_DONE,
+        UPLOAD_FAILED
+    };
+    // Shared w/ the worker jobs, so they never touch the uploader itself
+    struct Upload
+    {
+        atomic<int> state;
+        unsigned int texture;
+        GLenum target;
+        int level;
+        string path;
+        string alphaPath;
+        bool alphaUnused;
+        bool flipVertically;
+        bool streamMips;
+        int width;
+        int height;
+        int components;
+        // Decoded by stb_image (owned) or the caller's (uploadLevel)
+        const unsigned char *pixels;
+        bool ownsPixels;
+        // Every level, when streaming mips
+        TextureMipChain chain;
+        int levelsPending;
+        function<void()> uploaded;
+        int pixelBuffer;
+        unsigned char *mapped;
+    };
+    struct PixelBuffer
+    {
+        unsigned int buffer;
+        size_t size;
+        // Set once the upload from it is issued, the buffer is free again when it's signaled
+        GLsync fence;
+        bool busy;
+    };
+
+    vector<shared_ptr<Upload> > uploads;
+    vector<PixelBuffer> pixelBuffers;
+
+    int acquirePixelBuffer(size_t bytes);
+    void startCopy(const shared_ptr<Upload> &upload);
+    void uploadFromClientMemory(Upload &upload);
+    void uploadResidentLevels(const shared_ptr<Upload> &upload);
+    void finishUpload(Upload &upload);
+
+    TextureUploader(const TextureUploader &);
+    TextureUploader &operator=(const TextureUploader &);
+};
+
+#endif
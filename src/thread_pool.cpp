@@ -0,0 +1,112 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+ThreadPool::ThreadPool(unsigned int workers) : stopping(false)
+{
+    if (workers == 0)
+    {
+        unsigned int hardwareThreads = thread::hardware_concurrency();
+        workers = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+    for (unsigned int i = 0; i < workers; i++)
+        threads.push_back(thread(&ThreadPool::workerLoop, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(jobsMutex);
+        stopping = true;
+    }
+    jobsAvailable.notify_all();
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+unsigned int ThreadPool::threadCount() const
+{
+    return (unsigned int)threads.size() + 1;
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        function<void()> job;
+        {
+            unique_lock<mutex> lock(jobsMutex);
+            jobsAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+bool ThreadPool::runPendingJob()
+{
+    function<void()> job;
+    {
+        lock_guard<mutex> lock(jobsMutex);
+        if (jobs.empty())
+            return false;
+        job = jobs.front();
+        jobs.pop_front();
+    }
+    job();
+    return true;
+}
+
+void ThreadPool::submit(const function<void()> &job)
+{
+    {
+        lock_guard<mutex> lock(jobsMutex);
+        jobs.push_back(job);
+    }
+    jobsAvailable.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, size_t minChunk, const function<void(size_t, size_t)> &job)
+{
+    if (count == 0)
+        return;
+    size_t chunks = min<size_t>(threadCount(), (count + max<size_t>(minChunk, 1) - 1) / max<size_t>(minChunk, 1));
+    if (chunks <= 1)
+    {
+        job(0, count);
+        return;
+    }
+
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    shared_ptr<atomic<size_t>> remaining = make_shared<atomic<size_t>>(chunks - 1);
+    for (size_t chunk = 1; chunk < chunks; chunk++)
+    {
+        size_t begin = chunk * chunkSize;
+        size_t end = min(count, begin + chunkSize);
+        submit([&job, begin, end, remaining] {
+            if (begin < end)
+                job(begin, end);
+            remaining->fetch_sub(1);
+        });
+    }
+    // The first chunk runs here, then we help with whatever is queued until our chunks are done
+    // (so calling parallelFor from inside a job can't deadlock)
+    job(0, min(count, chunkSize));
+    while (remaining->load() > 0)
+    {
+        if (!runPendingJob())
+            this_thread::yield();
+    }
+}
+
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool pool;
+    return pool;
+}
@@ -0,0 +1,50 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// Fixed set of worker threads for CPU work that can be split up (light assignment, decoding, parsing...).
+// Threads are started once and wait for work, starting threads every frame would cost more than most jobs.
+// None of the workers has a GL context: jobs must not make GL calls.
+class ThreadPool
+{
+public:
+    // 0 = one worker per hardware thread minus the calling thread
+    explicit ThreadPool(unsigned int workers = 0);
+    ~ThreadPool();
+
+    // Workers + the calling thread, which also works while it waits
+    unsigned int threadCount() const;
+
+    // Runs job(begin, end) over [0, count) in chunks of at least minChunk items and returns once every chunk is done
+    void parallelFor(size_t count, size_t minChunk, const function<void(size_t, size_t)> &job);
+    // Runs a job on a worker some time later
+    void submit(const function<void()> &job);
+
+    // Pool shared by the whole app
+    static ThreadPool &shared();
+
+private:
+    vector<thread> threads;
+    deque<function<void()>> jobs;
+    mutex jobsMutex;
+    condition_variable jobsAvailable;
+    bool stopping;
+
+    void workerLoop();
+    // Pops + runs one queued job, returns false if the queue was empty
+    bool runPendingJob();
+
+    ThreadPool(const ThreadPool &);
+    ThreadPool &operator=(const ThreadPool &);
+};
+
+#endif